@@ -3,6 +3,7 @@
 #include <stdint.h>
 #include <string.h>
 #include "reverbsc.h"
+#include "reverbsc_lanes.h"
 
 #define REVSC_OK 0
 #define REVSC_NOT_OK 1
@@ -11,9 +12,6 @@
 #define MIN_SRATE 5000.0
 #define MAX_SRATE 1000000.0
 #define MAX_PITCHMOD 20.0
-#define DELAYPOS_SHIFT 28
-#define DELAYPOS_SCALE 0x10000000
-#define DELAYPOS_MASK 0x0FFFFFFF
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846 /* pi */
@@ -39,14 +37,14 @@ static const float kReverbParams[8][4]
 static int DelayLineMaxSamples(float sr, float i_pitch_mod, int n);
 //static int InitDelayLine(dsy_reverbsc_dl *lp, int n);
 static int         DelayLineBytesAlloc(float sr, float i_pitch_mod, int n);
-static const float kOutputGain = 0.35;
-static const float kJpScale    = 0.25;
 
 int ReverbSc::Init(float sr)
 {
     i_sample_rate_ = sr;
     sample_rate_   = sr;
     feedback_      = 0.97;
+    feedback_smooth_ = feedback_;
+    feedback_coef_   = 1.0f - expf(-1.0f / (0.01f * sr));
     lpfreq_        = 10000;
     i_pitch_mod_   = 1;
     i_skip_init_   = 0;
@@ -139,6 +137,17 @@ int ReverbSc::InitDelayLine(ReverbScDl *lp, int n)
     return REVSC_OK;
 }
 
+void ReverbSc::UpdateDampFact()
+{
+    if(lpfreq_ != prv_lpfreq_)
+    {
+        prv_lpfreq_ = lpfreq_;
+        float damp_fact
+            = 2.0f - cosf(prv_lpfreq_ * (2.0f * (float)M_PI) / sample_rate_);
+        damp_fact_ = damp_fact - sqrtf(damp_fact * damp_fact - 1.0f);
+    }
+}
+
 int ReverbSc::Process(const float &in1,
                       const float &in2,
                       float *      out1,
@@ -157,14 +166,9 @@ int ReverbSc::Process(const float &in1,
         return REVSC_NOT_OK;
 
     /* calculate tone filter coefficient if frequency changed */
-    if(lpfreq_ != prv_lpfreq_)
-    {
-        prv_lpfreq_ = lpfreq_;
-        damp_fact
-            = 2.0f - cosf(prv_lpfreq_ * (2.0f * (float)M_PI) / sample_rate_);
-        damp_fact = damp_fact_
-            = damp_fact - sqrtf(damp_fact * damp_fact - 1.0f);
-    }
+    UpdateDampFact();
+    damp_fact        = damp_fact_;
+    feedback_smooth_ = feedback_;
 
     /* calculate "resultant junction pressure" and mix to input signals */
 
@@ -281,3 +285,93 @@ int ReverbSc::Process(const float &in1,
     *out2 = a_out_r * kOutputGain;
     return REVSC_OK;
 }
+
+/* The built-in copy of the lane loop; SetLanesKernel() may swap in one
+   built for a wider instruction set. */
+static void DefaultLanes(ReverbScLanes &s,
+                         const float *  in1,
+                         const float *  in2,
+                         float *        out1,
+                         float *        out2,
+                         size_t         size)
+{
+    ReverbScRunLanes(s, in1, in2, out1, out2, size);
+}
+
+static ReverbScLanesFn lanes_kernel_ = DefaultLanes;
+
+void ReverbSc::SetLanesKernel(ReverbScLanesFn fn)
+{
+    lanes_kernel_ = fn ? fn : DefaultLanes;
+}
+
+/* Block path: same algorithm as Process(), with the line state copied into
+   per-lane arrays (ReverbScLanes) for the duration of the block. The fixed
+   8-trip lane loops carry no dependencies between lanes, so they vectorize
+   (2 x SSE, 1 x AVX); the delay writes and the 4-tap gather are the only
+   per-lane scalar work. The block runs in stretches between the ends of
+   the lines' random segments, which start the next segment. */
+void ReverbSc::ProcessBlock(const float *in1,
+                            const float *in2,
+                            float *      out1,
+                            float *      out2,
+                            size_t       size)
+{
+    if(init_done_ <= 0)
+        return;
+
+    UpdateDampFact();
+    ReverbScLanes s;
+    s.feedback        = feedback_smooth_;
+    s.feedback_target = feedback_;
+    s.feedback_coef   = feedback_coef_;
+    s.damp_fact       = damp_fact_;
+    for(int l = 0; l < 8; l++)
+    {
+        const ReverbScDl &lp   = delay_lines_[l];
+        s.write_pos[l]         = lp.write_pos;
+        s.buffer_size[l]       = lp.buffer_size;
+        s.read_pos[l]          = lp.read_pos;
+        s.read_pos_frac[l]     = lp.read_pos_frac;
+        s.read_pos_frac_inc[l] = lp.read_pos_frac_inc;
+        s.line_cnt[l]          = lp.rand_line_cnt > 0 ? lp.rand_line_cnt : 1;
+        s.filter_state[l]      = lp.filter_state;
+        s.buf[l]               = lp.buf;
+    }
+
+    for(size_t done = 0; done < size;)
+    {
+        size_t run = size - done;
+        for(int l = 0; l < 8; l++)
+            if((size_t)s.line_cnt[l] < run)
+                run = (size_t)s.line_cnt[l];
+        lanes_kernel_(s, in1 + done, in2 + done, out1 + done, out2 + done, run);
+        done += run;
+
+        /* start the next random line segment where one has ended */
+        for(int l = 0; l < 8; l++)
+        {
+            if(s.line_cnt[l] > 0)
+                continue;
+            ReverbScDl *lp    = &delay_lines_[l];
+            lp->write_pos     = s.write_pos[l];
+            lp->read_pos      = s.read_pos[l];
+            lp->read_pos_frac = s.read_pos_frac[l];
+            NextRandomLineseg(lp, l);
+            s.read_pos_frac_inc[l] = lp->read_pos_frac_inc;
+            s.line_cnt[l]          = lp->rand_line_cnt > 0 ? lp->rand_line_cnt : 1;
+        }
+    }
+
+    for(int l = 0; l < 8; l++)
+    {
+        ReverbScDl &lp       = delay_lines_[l];
+        lp.write_pos         = s.write_pos[l];
+        lp.read_pos          = s.read_pos[l];
+        lp.read_pos_frac     = s.read_pos_frac[l];
+        lp.read_pos_frac_inc = s.read_pos_frac_inc[l];
+        lp.rand_line_cnt     = s.line_cnt[l];
+        lp.filter_state      = s.filter_state[l];
+    }
+    feedback_smooth_ = s.feedback;
+}
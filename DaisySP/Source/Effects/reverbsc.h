@@ -2,6 +2,8 @@
 #ifndef DSYSP_REVERBSC_H
 #define DSYSP_REVERBSC_H
 
+#include <stddef.h>
+
 #define DSY_REVERBSC_MAX_SIZE 98936
 
 namespace daisysp
@@ -22,6 +24,16 @@ typedef struct
     float *buf;               /**< buffer ptr */
 } ReverbScDl;
 
+struct ReverbScLanes; // reverbsc_lanes.h
+
+/** ProcessBlock's per-sample loop over the eight lines (reverbsc_lanes.h) */
+typedef void (*ReverbScLanesFn)(ReverbScLanes &s,
+                                const float *  in1,
+                                const float *  in2,
+                                float *        out1,
+                                float *        out2,
+                                size_t         size);
+
 /** Stereo Reverb
 
 Reverb SC:               Ported from csound/soundpipe
@@ -48,6 +60,27 @@ class ReverbSc
     */
     int Process(const float &in1, const float &in2, float *out1, float *out2);
 
+    /** Processes a block of samples. The eight delay lines run as eight lanes
+        (structure-of-arrays copies of their state) so the interpolation,
+        feedback and damping math compiles to SIMD; only the delay reads and
+        writes stay per line. Feedback glides to the last SetFeedback() value
+        over ~10 ms, so it can be set once per block instead of per sample.
+        Outputs may alias the inputs.
+        \param in1, in2 - left / right input, size samples each
+        \param out1, out2 - left / right output, size samples each
+    */
+    void ProcessBlock(const float *in1,
+                      const float *in2,
+                      float *      out1,
+                      float *      out2,
+                      size_t       size);
+
+    /** Replaces ProcessBlock's lane loop for every instance, e.g. with a
+        copy of ReverbScRunLanes() built for a wider instruction set. Call
+        before any block is processed; nullptr restores the built-in loop.
+    */
+    static void SetLanesKernel(ReverbScLanesFn fn);
+
     /** controls the reverb time. reverb tail becomes infinite when set to 1.0
         \param fb - sets reverb time. range: 0.0 to 1.0
     */
@@ -60,7 +93,9 @@ class ReverbSc
   private:
     void       NextRandomLineseg(ReverbScDl *lp, int n);
     int        InitDelayLine(ReverbScDl *lp, int n);
+    void       UpdateDampFact();
     float      feedback_, lpfreq_;
+    float      feedback_smooth_, feedback_coef_; // ProcessBlock glide
     float      i_sample_rate_, i_pitch_mod_, i_skip_init_;
     float      sample_rate_;
     float      damp_fact_;
@@ -0,0 +1,156 @@
+#pragma once
+#ifndef DSYSP_REVERBSC_LANES_H
+#define DSYSP_REVERBSC_LANES_H
+
+#include <stddef.h>
+
+#define DELAYPOS_SHIFT 28
+#define DELAYPOS_SCALE 0x10000000
+#define DELAYPOS_MASK 0x0FFFFFFF
+
+namespace daisysp
+{
+static const float kOutputGain = 0.35;
+static const float kJpScale    = 0.25;
+
+/** ReverbSc::ProcessBlock's working copy of the eight delay lines: one
+    array element (lane) per line, so the per-line math compiles to SIMD.
+*/
+struct ReverbScLanes
+{
+    int    write_pos[8], buffer_size[8], read_pos[8];
+    int    read_pos_frac[8], read_pos_frac_inc[8], line_cnt[8];
+    float  filter_state[8];
+    float *buf[8];
+    float  feedback;        /**< smoothed, gliding toward feedback_target */
+    float  feedback_target; /**< the last SetFeedback() value */
+    float  feedback_coef;   /**< glide per sample */
+    float  damp_fact;
+};
+
+/** Runs the lanes for size samples and counts line_cnt down by size. No
+    random line segment may end inside the run (every line_cnt >= size):
+    ReverbSc::ProcessBlock starts the next segments between runs.
+
+    Included by reverbsc.cpp and by anything that builds its own copy of
+    the loop (with other compiler flags) for ReverbSc::SetLanesKernel();
+    static, so each copy stays in its own translation unit.
+*/
+static inline void ReverbScRunLanes(ReverbScLanes &s,
+                                    const float *  in1,
+                                    const float *  in2,
+                                    float *        out1,
+                                    float *        out2,
+                                    size_t         size)
+{
+    const float damp_fact = s.damp_fact;
+    const float target    = s.feedback_target;
+    const float coef      = s.feedback_coef;
+    float       fb        = s.feedback;
+
+    /* locals, not s: the delay writes can't alias them */
+    alignas(32) int   write_pos[8], buffer_size[8], read_pos[8];
+    alignas(32) int   read_pos_frac[8], read_pos_frac_inc[8];
+    alignas(32) float filter_state[8];
+    alignas(32) float vm1[8], v0[8], v1[8], v2[8];
+    float *           buf[8];
+
+    for(int l = 0; l < 8; l++)
+    {
+        write_pos[l]         = s.write_pos[l];
+        buffer_size[l]       = s.buffer_size[l];
+        read_pos[l]          = s.read_pos[l];
+        read_pos_frac[l]     = s.read_pos_frac[l];
+        read_pos_frac_inc[l] = s.read_pos_frac_inc[l];
+        filter_state[l]      = s.filter_state[l];
+        buf[l]               = s.buf[l];
+    }
+
+    for(size_t i = 0; i < size; i++)
+    {
+        fb += (target - fb) * coef;
+
+        /* resultant junction pressure, mixed to the inputs */
+        float jp = 0.0f;
+        for(int l = 0; l < 8; l++)
+            jp += filter_state[l];
+        jp *= kJpScale;
+        const float a_in_l = jp + in1[i];
+        const float a_in_r = jp + in2[i];
+
+        /* write input and feedback, advance positions */
+        for(int l = 0; l < 8; l++)
+            buf[l][write_pos[l]] = (l & 1 ? a_in_r : a_in_l) - filter_state[l];
+        for(int l = 0; l < 8; l++)
+        {
+            write_pos[l] += 1;
+            write_pos[l] -= write_pos[l] >= buffer_size[l] ? buffer_size[l] : 0;
+            /* frac stays in [0, 2 * DELAYPOS_SCALE): carry is 0 or 1 */
+            read_pos[l] += read_pos_frac[l] >> DELAYPOS_SHIFT;
+            read_pos_frac[l] &= DELAYPOS_MASK;
+            read_pos[l] -= read_pos[l] >= buffer_size[l] ? buffer_size[l] : 0;
+        }
+
+        /* four taps for the cubic interpolation */
+        for(int l = 0; l < 8; l++)
+        {
+            const float *b  = buf[l];
+            const int    r  = read_pos[l];
+            const int    sz = buffer_size[l];
+            if(r > 0 && r < sz - 2)
+            {
+                vm1[l] = b[r - 1];
+                v0[l]  = b[r];
+                v1[l]  = b[r + 1];
+                v2[l]  = b[r + 2];
+            }
+            else
+            {
+                vm1[l] = b[r > 0 ? r - 1 : r - 1 + sz];
+                v0[l]  = b[r];
+                v1[l]  = b[r + 1 < sz ? r + 1 : r + 1 - sz];
+                v2[l]  = b[r + 2 < sz ? r + 2 : r + 2 - sz];
+            }
+        }
+
+        /* interpolate, feedback gain and lowpass */
+        for(int l = 0; l < 8; l++)
+        {
+            const float frac
+                = (float)read_pos_frac[l] * (1.0f / (float)DELAYPOS_SCALE);
+            float a2  = (frac * frac - 1.0f) * (1.0f / 6.0f);
+            float a1  = (frac + 1.0f) * 0.5f;
+            float am1 = a1 - 1.0f;
+            float a0  = 3.0f * a2;
+            a1 -= a0;
+            am1 -= a2;
+            a0 -= frac;
+
+            float v = (am1 * vm1[l] + a0 * v0[l] + a1 * v1[l] + a2 * v2[l]) * frac
+                      + v0[l];
+            v *= fb;
+            filter_state[l] = (filter_state[l] - v) * damp_fact + v;
+            read_pos_frac[l] += read_pos_frac_inc[l];
+        }
+
+        out1[i] = (filter_state[0] + filter_state[2] + filter_state[4]
+                   + filter_state[6])
+                  * kOutputGain;
+        out2[i] = (filter_state[1] + filter_state[3] + filter_state[5]
+                   + filter_state[7])
+                  * kOutputGain;
+    }
+
+    for(int l = 0; l < 8; l++)
+    {
+        s.write_pos[l]     = write_pos[l];
+        s.read_pos[l]      = read_pos[l];
+        s.read_pos_frac[l] = read_pos_frac[l];
+        s.filter_state[l]  = filter_state[l];
+        s.line_cnt[l] -= (int)size;
+    }
+    s.feedback = fb;
+}
+
+} // namespace daisysp
+#endif
@@ -1,16 +1,24 @@
 import os
-from fastapi import FastAPI, HTTPException, Body
-from fastapi.responses import JSONResponse
+import hashlib
+from fastapi import FastAPI, HTTPException, Body, Request
+from fastapi.responses import JSONResponse, Response
 import json
 
 app = FastAPI(title="AVA JSON Server")
 
-USERS_FILE = "users.json"
 JSON_FOLDER = os.path.dirname(os.path.abspath(__file__))
+USERS_FILE = os.path.join(JSON_FOLDER, "users.json")
+ASSETS_FOLDER = os.path.join(os.path.dirname(JSON_FOLDER), "assets")
 
 # --- Allowed JSON files ---
 ALLOWED_FILES = ["dastan", "modes"]  # add all permitted files here
 
+# --- Fallbacks when <file>.json is not deployed next to this script ---
+# (lets the app be tested against a local server with the bundled catalog)
+FILE_FALLBACKS = {
+    "dastan": os.path.join(ASSETS_FOLDER, "dastandata.json"),
+}
+
 # --- Utility ---
 def load_json(file_path: str):
     if not os.path.exists(file_path):
@@ -18,9 +26,17 @@ def load_json(file_path: str):
     with open(file_path, "r", encoding="utf-8") as f:
         return json.load(f)
 
+def resolve_file(file: str) -> str:
+    path = os.path.join(JSON_FOLDER, f"{file}.json")
+    if not os.path.exists(path) and file in FILE_FALLBACKS:
+        path = FILE_FALLBACKS[file]
+    if not os.path.exists(path):
+        raise FileNotFoundError(f"{file}.json not found")
+    return path
+
 # --- Endpoint ---
 @app.post("/api/get_json")
-def get_json(data: dict = Body(...)):
+def get_json(request: Request, data: dict = Body(...)):
     name = data.get("name")
     pin = data.get("pin")
     file = data.get("file", "dastan")
@@ -38,13 +54,24 @@ def get_json(data: dict = Body(...)):
         raise HTTPException(status_code=401, detail="Invalid name or PIN")
 
     # --- Load requested JSON file ---
-    file_path = os.path.join(JSON_FOLDER, f"{file}.json")
     try:
-        data = load_json(file_path)
+        file_path = resolve_file(file)
     except FileNotFoundError:
         raise HTTPException(status_code=404, detail=f"{file}.json not found")
 
-    return JSONResponse(content=data)
+    # --- ETag: content hash of the file, 304 when the client is current ---
+    with open(file_path, "rb") as f:
+        raw = f.read()
+    etag = '"' + hashlib.sha256(raw).hexdigest()[:32] + '"'
+    if request.headers.get("if-none-match") == etag:
+        return Response(status_code=304, headers={"ETag": etag})
+
+    try:
+        data = json.loads(raw.decode("utf-8"))
+    except ValueError:
+        raise HTTPException(status_code=500, detail=f"{file}.json is not valid JSON")
+
+    return JSONResponse(content=data, headers={"ETag": etag})
 
 # --- Root ---
 @app.get("/")
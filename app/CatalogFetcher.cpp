@@ -0,0 +1,293 @@
+#include "CatalogFetcher.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <curl/curl.h>
+
+namespace fs = std::filesystem;
+
+// -------------------------
+// Helpers
+// -------------------------
+static bool readFile(const std::string& path, std::string& out) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) return false;
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    out = ss.str();
+    return true;
+}
+
+// write to <path>.tmp then rename, so a crash never leaves half a cache behind
+static bool writeFileAtomic(const std::string& path, const std::string& data) {
+    std::error_code ec;
+    fs::path p(path);
+    if (p.has_parent_path()) fs::create_directories(p.parent_path(), ec);
+
+    std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return false;
+        out.write(data.data(), (std::streamsize)data.size());
+        if (!out.good()) return false;
+    }
+    fs::rename(tmp, p, ec);
+    if (ec) {
+        // Windows refuses to rename over an existing file on some setups
+        fs::remove(p, ec);
+        fs::rename(tmp, p, ec);
+    }
+    return !ec;
+}
+
+static size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* s) {
+    s->append((char*)contents, size * nmemb);
+    return size * nmemb;
+}
+
+// Capture the ETag response header (case-insensitive name)
+static size_t HeaderCallback(char* buffer, size_t size, size_t nitems, std::string* etag) {
+    size_t len = size * nitems;
+    std::string line(buffer, len);
+    const std::string key = "etag:";
+    if (line.size() > key.size()) {
+        std::string head = line.substr(0, key.size());
+        std::transform(head.begin(), head.end(), head.begin(),
+                       [](unsigned char c) { return (char)std::tolower(c); });
+        if (head == key) {
+            std::string v = line.substr(key.size());
+            auto notSpace = [](unsigned char c) { return !std::isspace(c); };
+            v.erase(v.begin(), std::find_if(v.begin(), v.end(), notSpace));
+            v.erase(std::find_if(v.rbegin(), v.rend(), notSpace).base(), v.end());
+            *etag = v;
+        }
+    }
+    return len;
+}
+
+// Non-zero aborts the transfer (CURLE_ABORTED_BY_CALLBACK)
+static int ProgressCallback(void* cancel, curl_off_t, curl_off_t, curl_off_t, curl_off_t) {
+    return static_cast<std::atomic<bool>*>(cancel)->load() ? 1 : 0;
+}
+
+// -------------------------
+// CatalogFetcher
+// -------------------------
+CatalogFetcher::CatalogFetcher(Config c) : cfg(std::move(c)) {}
+
+CatalogFetcher::~CatalogFetcher() {
+    // the transfer checks `cancel` from its progress callback (libcurl calls
+    // it at least once a second, also while connecting), so exit never
+    // waits out the network timeouts
+    cancel.store(true);
+    if (worker.joinable()) worker.join();
+}
+
+CatalogFetcher::Config CatalogFetcher::configFromEnv(Config base) {
+    if (const char* v = std::getenv("AVA_API_URL"))  base.url  = v;
+    if (const char* v = std::getenv("AVA_API_USER")) base.user = v;
+    if (const char* v = std::getenv("AVA_API_PIN"))  base.pin  = v;
+    return base;
+}
+
+uint64_t CatalogFetcher::contentHash(const std::string& body) {
+    uint64_t h = 1469598103934665603ull;
+    for (unsigned char c : body) {
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+bool CatalogFetcher::validate(const json& j) const {
+    // Same shape ModeLoader expects: a non-empty array of {gah_name, ratio, ...}
+    if (!j.is_array() || j.empty()) return false;
+    for (const auto& e : j) {
+        if (!e.is_object()) return false;
+        if (!e.contains("gah_name") || !e.contains("ratio")) return false;
+        if (!e["ratio"].is_number()) return false;
+    }
+    return true;
+}
+
+void CatalogFetcher::readMeta() {
+    std::string body;
+    if (!readFile(cfg.cachePath + ".meta", body)) return;
+    try {
+        json m = json::parse(body);
+        etag = m.value("etag", "");
+    } catch (const std::exception&) {
+        etag.clear();
+    }
+}
+
+void CatalogFetcher::writeCache(const std::string& body, const std::string& newEtag, uint64_t hash) {
+    if (!writeFileAtomic(cfg.cachePath, body)) {
+        std::cerr << "[Catalog] could not write cache " << cfg.cachePath << "\n";
+        return;
+    }
+    json m = { {"etag", newEtag}, {"hash", hash} };
+    writeFileAtomic(cfg.cachePath + ".meta", m.dump());
+}
+
+CatalogFetcher::json CatalogFetcher::loadLocal() {
+    const std::pair<const std::string*, const char*> candidates[] = {
+        { &cfg.cachePath,   "cache"   },
+        { &cfg.bundledPath, "bundled" },
+    };
+
+    for (const auto& [path, label] : candidates) {
+        std::string body;
+        if (!readFile(*path, body)) continue;
+        try {
+            json j = json::parse(body);
+            if (!validate(j)) {
+                std::cerr << "[Catalog] ignoring invalid " << label << " file " << *path << "\n";
+                continue;
+            }
+            std::lock_guard<std::mutex> lock(mtx);
+            currentHash   = contentHash(body);
+            currentSource = label;
+            if (path == &cfg.cachePath) readMeta();
+            std::cout << "[Catalog] loaded " << j.size() << " entries from " << label
+                      << " (" << *path << ")\n";
+            return j;
+        } catch (const std::exception& ex) {
+            std::cerr << "[Catalog] failed to parse " << *path << ": " << ex.what() << "\n";
+        }
+    }
+
+    std::cerr << "[Catalog] no local catalog available\n";
+    return json::array();
+}
+
+void CatalogFetcher::startRefresh() {
+    if (busy.exchange(true)) return;
+    if (worker.joinable()) worker.join();   // previous run already finished
+
+    std::string knownEtag;
+    uint64_t knownHash;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        knownEtag = etag;
+        knownHash = currentHash;
+    }
+    worker = std::thread(&CatalogFetcher::refreshTask, this, knownEtag, knownHash);
+}
+
+void CatalogFetcher::refreshTask(std::string knownEtag, uint64_t knownHash) {
+    struct BusyReset {
+        std::atomic<bool>& b;
+        ~BusyReset() { b.store(false); }
+    } reset{busy};
+
+    CURL* curl = curl_easy_init();
+    if (!curl) {
+        std::cerr << "[Catalog] failed to initialize CURL\n";
+        return;
+    }
+
+    std::string response, newEtag;
+    json req = { {"name", cfg.user}, {"pin", cfg.pin}, {"file", cfg.file} };
+    std::string postData = req.dump();
+
+    struct curl_slist* headers = nullptr;
+    headers = curl_slist_append(headers, "Content-Type: application/json");
+    if (!knownEtag.empty()) {
+        std::string h = "If-None-Match: " + knownEtag;
+        headers = curl_slist_append(headers, h.c_str());
+    }
+
+    curl_easy_setopt(curl, CURLOPT_URL, cfg.url.c_str());
+    curl_easy_setopt(curl, CURLOPT_POST, 1L);
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, postData.c_str());
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
+    curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, HeaderCallback);
+    curl_easy_setopt(curl, CURLOPT_HEADERDATA, &newEtag);
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, cfg.connectTimeoutSec);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, cfg.timeoutSec);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);   // required off the main thread
+    curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+    curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, ProgressCallback);
+    curl_easy_setopt(curl, CURLOPT_XFERINFODATA, &cancel);
+
+    CURLcode res = curl_easy_perform(curl);
+    long status = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+    curl_slist_free_all(headers);
+    curl_easy_cleanup(curl);
+
+    if (cancel.load()) return;   // shutting down: nothing left to hand over
+    if (res != CURLE_OK) {
+        std::cerr << "[Catalog] refresh failed: " << curl_easy_strerror(res) << "\n";
+        return;
+    }
+    if (status == 304) {
+        std::cout << "[Catalog] up to date (etag " << knownEtag << ")\n";
+        return;
+    }
+    if (status != 200) {
+        std::cerr << "[Catalog] refresh rejected, HTTP " << status << "\n";
+        return;
+    }
+
+    uint64_t hash = contentHash(response);
+    if (hash == knownHash) {
+        // same bytes, possibly a server without ETag support: just remember the tag
+        bool tagChanged = false;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (!newEtag.empty() && newEtag != etag) {
+                etag = newEtag;
+                tagChanged = true;
+            }
+        }
+        // the disk write outside the lock: readers don't wait on it
+        if (tagChanged) writeCache(response, newEtag, hash);
+        std::cout << "[Catalog] unchanged (hash match)\n";
+        return;
+    }
+
+    json j;
+    try {
+        j = json::parse(response);
+    } catch (const std::exception& ex) {
+        std::cerr << "[Catalog] server sent invalid JSON: " << ex.what() << "\n";
+        return;
+    }
+    if (!validate(j)) {
+        std::cerr << "[Catalog] server catalog failed validation, keeping current\n";
+        return;
+    }
+
+    writeCache(response, newEtag, hash);
+
+    std::lock_guard<std::mutex> lock(mtx);
+    etag          = newEtag;
+    currentHash   = hash;
+    currentSource = "network";
+    pending       = std::move(j);
+    hasPending    = true;
+    std::cout << "[Catalog] update received (" << pending.size() << " entries)\n";
+}
+
+bool CatalogFetcher::poll(json& out) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (!hasPending) return false;
+    out = std::move(pending);
+    pending = json();
+    hasPending = false;
+    return true;
+}
+
+std::string CatalogFetcher::source() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return currentSource;
+}
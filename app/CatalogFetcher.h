@@ -0,0 +1,74 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "json.hpp"
+
+// -------------------------
+// CatalogFetcher
+// -------------------------
+// Serves the mode catalog (dastan JSON) without ever blocking startup:
+//   1) loadLocal()     → on-disk cache, else the bundled assets/ file
+//   2) startRefresh()  → background POST to the API (If-None-Match / ETag)
+//   3) poll()          → main loop picks up a validated, changed catalog
+//
+// The server URL can be pointed at the bundled api/main.py with
+//   AVA_API_URL=http://127.0.0.1:8000/api/get_json
+class CatalogFetcher {
+public:
+    using json = nlohmann::json;
+
+    struct Config {
+        std::string url         = "https://ava-api.doxameter.com/api/get_json";
+        std::string user        = "ali";
+        std::string pin         = "1234";
+        std::string file        = "dastan";
+        std::string cachePath   = "cache/dastan.json";      // + ".meta" for etag/hash
+        std::string bundledPath = "assets/dastandata.json";
+        long connectTimeoutSec  = 5;
+        long timeoutSec         = 20;
+    };
+
+    explicit CatalogFetcher(Config cfg);
+    ~CatalogFetcher();
+
+    CatalogFetcher(const CatalogFetcher&) = delete;
+    CatalogFetcher& operator=(const CatalogFetcher&) = delete;
+
+    // Synchronous, disk only. Returns an empty array if nothing usable exists.
+    json loadLocal();
+
+    // Kick off one background refresh (no-op while one is still running).
+    void startRefresh();
+
+    // Main thread: true once per accepted update, `out` receives the catalog.
+    bool poll(json& out);
+
+    // Where the current catalog came from: "cache", "bundled", "network" or "none".
+    std::string source() const;
+
+    static uint64_t contentHash(const std::string& body);   // FNV-1a 64
+    static Config configFromEnv(Config base);          // AVA_API_URL / _USER / _PIN
+    static Config configFromEnv() { return configFromEnv(Config{}); }
+
+private:
+    Config cfg;
+
+    std::thread worker;
+    std::atomic<bool> busy{false};
+    std::atomic<bool> cancel{false};   // set by the destructor, aborts the transfer
+
+    mutable std::mutex mtx;      // guards everything below
+    std::string etag;
+    uint64_t    currentHash = 0;
+    std::string currentSource = "none";
+    bool        hasPending = false;
+    json        pending;
+
+    void refreshTask(std::string knownEtag, uint64_t knownHash);
+    bool validate(const json& j) const;
+    void readMeta();
+    void writeCache(const std::string& body, const std::string& newEtag, uint64_t hash);
+};
@@ -0,0 +1,211 @@
+// -------------------------
+// AVA_FastMathBench: dsp/FastMath.h against libm
+// -------------------------
+// Sweeps each approximation densely over its domain, compares with
+// double-precision libm and checks the accuracy contract the header
+// documents (the bound may grow with |x|; the worst ratio of error to
+// bound must stay ≤ 1). Then times each one against the float libm
+// call, in ns per value: over a buffer in a plain loop (vectorized where
+// the call allows) and one dependent call at a time; and the tremolo
+// kernel (dsp/VoiceKernels.h), fast::sin's caller, against the same
+// kernel on std::sin, in ns per frame. Exits with 1 when a contract is
+// broken.
+//
+//   AVA_FastMathBench [--verify] [--seconds S]
+//
+// --verify checks only. S is the time spent per function (0.2).
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "dsp/FastMath.h"
+#include "dsp/VoiceKernels.h"
+
+#if defined(_MSC_VER)
+#define AVA_RESTRICT __restrict
+#else
+#define AVA_RESTRICT __restrict__
+#endif
+
+namespace fast = ava::dsp::fast;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+// Concrete types all the way down: measure() inlines the calls into its
+// own loops, as they are inlined at the engine's call sites.
+template <class Fast, class Libm, class Exact, class Bound>
+struct Case {
+    const char* name;
+    double lo, hi;                    // domain swept
+    bool logSweep;                    // geometric steps (lo > 0)
+    Fast approx;
+    Libm libm;
+    Exact exact;
+    // the contract at x and the exact value: largest allowed |error|
+    Bound bound;
+};
+
+template <class Fast, class Libm, class Exact, class Bound>
+Case<Fast, Libm, Exact, Bound> makeCase(const char* name, double lo, double hi, bool logSweep,
+                                        Fast approx, Libm libm, Exact exact, Bound bound) {
+    return { name, lo, hi, logSweep, approx, libm, exact, bound };
+}
+
+auto cases() {
+    return std::make_tuple(
+        makeCase("log2", 1e-37, 1e37, true,
+            [](float x) { return fast::log2(x); }, [](float x) { return std::log2(x); },
+            [](double x) { return std::log2(x); },
+            [](double, double e) { return fast::Log2AbsError + std::abs(e) * fast::ArgRounding; }),
+        makeCase("sin", -100.0, 100.0, false,
+            [](float x) { return fast::sin(x); }, [](float x) { return std::sin(x); },
+            [](double x) { return std::sin(x); },
+            [](double x, double) { return fast::SinAbsError + std::abs(x) * fast::ArgRounding; }));
+}
+
+constexpr int Points = 4000000;
+
+// Worst |error| / bound over the domain, and the |error| there.
+template <class C>
+void check(const C& c, double& worstRatio, double& worstError) {
+    worstRatio = worstError = 0.0;
+    const double growth = c.logSweep ? std::pow(c.hi / c.lo, 1.0 / Points) : 0.0;
+    double x = c.lo;
+    for (int i = 0; i <= Points; i++) {
+        const float xf = (float)x;
+        const double exact = c.exact((double)xf);
+        const double err = std::abs((double)c.approx(xf) - exact);
+        const double ratio = err / c.bound((double)xf, exact);
+        if (!(ratio <= worstRatio)) {   // NaN counts as worst
+            worstRatio = ratio;
+            worstError = err;
+        }
+        x = c.logSweep ? x * growth : c.lo + (c.hi - c.lo) * (i + 1) / Points;
+    }
+}
+
+// The two ways the engine calls these: a loop over a buffer, which
+// vectorizes when f does (restrict: the buffers don't overlap, so no
+// runtime alias check), and one call whose result the next one needs, so
+// calls neither overlap nor vectorize, as at a per-span call site.
+template <class F>
+void loop(F f, const float* AVA_RESTRICT in, float* AVA_RESTRICT out, size_t n) {
+    for (size_t i = 0; i < n; i++) out[i] = f(in[i]);
+}
+
+template <class F>
+float chain(F f, const float* in, float* out, size_t n, float y) {
+    for (size_t i = 0; i < n; i++) y = out[i] = f(in[i] + std::clamp(y, -1.0f, 1.0f) * 0.0f);
+    return y;
+}
+
+// ns per value over a 4096-value buffer spread over the domain.
+template <bool Chained, class F, class C>
+double measure(F f, const C& c, double seconds) {
+    std::vector<float> in(4096), out(4096);
+    for (size_t i = 0; i < in.size(); i++) {
+        const double t = (double)i / in.size();
+        in[i] = (float)(c.logSweep ? c.lo * std::pow(c.hi / c.lo, t) : c.lo + (c.hi - c.lo) * t);
+    }
+    float y = 0.0f;
+    uint64_t values = 0;
+    const auto t0 = Clock::now();
+    double elapsed = 0.0;
+    do {
+        if constexpr (Chained) y = chain(f, in.data(), out.data(), in.size(), y);
+        else                   loop(f, in.data(), out.data(), in.size());
+        values += in.size();
+        elapsed = std::chrono::duration<double>(Clock::now() - t0).count();
+    } while (elapsed < seconds);
+    volatile float sink = out[values % out.size()];
+    (void)sink;
+    return 1e9 * elapsed / (double)values;
+}
+
+// voice::tremolo with std::sin in place of fast::sin
+void tremoloLibm(float* mod, double& phase, double inc, float depth, unsigned n) {
+    namespace voice = ava::dsp::voice;
+    constexpr double TwoPi = 2.0 * 3.14159265358979323846;
+    for (unsigned i = 0; i < n; i += voice::Lanes) {
+        const unsigned m = n - i < voice::Lanes ? n - i : voice::Lanes;
+        float ph[voice::Lanes] = {};
+        for (unsigned j = 0; j < m; j++) {
+            phase += inc;
+            if (phase >= TwoPi)
+                phase -= TwoPi;
+            ph[j] = (float)phase;
+        }
+        float t[voice::Lanes];
+        for (unsigned j = 0; j < voice::Lanes; j++) t[j] = 1.0f + depth * 0.3f * std::sin(ph[j]);
+        for (unsigned j = 0; j < m; j++) mod[i + j] = t[j];
+    }
+}
+
+// ns per frame of a tremolo kernel over 64-frame spans (Key::VoiceBlockFrames)
+template <class F>
+double measureTremolo(F f, double seconds) {
+    float mod[64];
+    double phase = 0.0;
+    uint64_t frames = 0;
+    const auto t0 = Clock::now();
+    double elapsed = 0.0;
+    do {
+        for (int r = 0; r < 64; r++) f(mod, phase, 2.0 * M_PI * 3.1 / 48000.0, 0.5f, 64);
+        frames += 64 * 64;
+        elapsed = std::chrono::duration<double>(Clock::now() - t0).count();
+    } while (elapsed < seconds);
+    volatile float sink = mod[frames % 64];
+    (void)sink;
+    return 1e9 * elapsed / (double)frames;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    bool verifyOnly = false;
+    double seconds = 0.2;
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        if (a == "--verify")                       verifyOnly = true;
+        else if (a == "--seconds" && i + 1 < argc) seconds = std::max(0.01, std::atof(argv[++i]));
+    }
+
+    const auto all = cases();
+
+    // --- Accuracy contracts ---
+    int failures = 0;
+    std::apply([&](const auto&... c) {
+        auto one = [&](const auto& c) {
+            double ratio, err;
+            check(c, ratio, err);
+            const bool ok = ratio <= 1.0;
+            failures += !ok;
+            std::printf("[Check] %-16s worst %.2e (%3.0f%% of the bound)%s\n", c.name, err, 100.0 * ratio,
+                        ok ? "" : " FAIL");
+        };
+        (one(c), ...);
+    }, all);
+    std::printf("[Check] %s\n", failures ? "contracts broken" : "all contracts hold");
+    if (verifyOnly) return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+
+    // --- Cost against libm: in a loop, and one call at a time ---
+    std::printf("[Bench] %-16s %9s %9s %8s   %9s %9s %8s\n", "ns/value",
+                "libm", "fast", "loop", "libm", "fast", "call");
+    std::apply([&](const auto&... c) {
+        auto one = [&](const auto& c) {
+            const double slow = measure<false>(c.libm, c, seconds), quick = measure<false>(c.approx, c, seconds);
+            const double slow1 = measure<true>(c.libm, c, seconds), quick1 = measure<true>(c.approx, c, seconds);
+            std::printf("[Bench] %-16s %9.2f %9.2f %7.2fx   %9.2f %9.2f %7.2fx\n", c.name,
+                        slow, quick, slow / quick, slow1, quick1, slow1 / quick1);
+        };
+        (one(c), ...);
+    }, all);
+    const double slow = measureTremolo(tremoloLibm, seconds), quick = measureTremolo(ava::dsp::voice::tremolo, seconds);
+    std::printf("[Bench] %-16s %9.2f %9.2f %7.2fx   (ns/frame)\n", "tremolo kernel", slow, quick, slow / quick);
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
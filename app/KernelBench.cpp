@@ -0,0 +1,271 @@
+// -------------------------
+// AVA_KernelBench: the kernel tables, checked and timed
+// -------------------------
+// Runs every kernel of every table this CPU can run (dsp/Kernels.h) on the
+// same seeded input as the scalar reference, in blocks of varying length
+// (whole lane groups, leftovers, single frames), and compares: the largest
+// difference must stay inside the kernel's tolerance. Then times each
+// kernel per table over 64-frame blocks, in ns per frame, with the speedup
+// over scalar. Exits with 1 when a table disagrees with the reference.
+//
+//   AVA_KernelBench [--verify] [--seconds S]
+//
+// --verify checks only. S is the time spent per kernel and table (0.2).
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+#include "dsp/Kernels.h"
+#include "Effects/reverbsc_lanes.h"
+
+using namespace ava::dsp;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+constexpr unsigned Frames = 8192;
+constexpr unsigned Block = 64;
+// block lengths the check cycles through
+constexpr unsigned Lengths[] = { 64, 1, 17, 63, 48, 64, 5, 32, 16, 33 };
+
+// Deterministic input shared by the reference and the table under test.
+struct Input {
+    std::vector<float> a, b, frac;
+    std::vector<int32_t> index;
+    std::vector<float> table;
+    std::vector<float> params;        // per-block gains, steps, targets
+
+    Input() {
+        std::mt19937 rng(2024);
+        std::uniform_real_distribution<float> u(-1.0f, 1.0f), p(0.0f, 1.0f);
+        a.resize(Frames); b.resize(Frames); frac.resize(Frames); index.resize(Frames);
+        for (unsigned i = 0; i < Frames; i++) {
+            a[i] = u(rng);
+            b[i] = u(rng);
+            frac[i] = p(rng);
+        }
+        // two 2048-sample morph layers; indices into the first
+        table.resize(4096);
+        for (size_t i = 0; i < table.size(); i++) table[i] = u(rng);
+        for (unsigned i = 0; i < Frames; i++) index[i] = (int32_t)(rng() % 2048);
+        params.resize(Frames);
+        for (auto& x : params) x = p(rng);
+    }
+};
+
+// Everything one kernel needs, mutable: fresh for each table.
+struct State {
+    std::vector<float> l, r, out;
+    BiquadCascade cascade;
+    Limiter limiter{48000.0f, 80.0f};
+    daisysp::ReverbScLanes lanes{};
+    std::vector<std::vector<float>> lines;
+    float carry = 0.0f;               // a gain / mix value handed block to block
+
+    explicit State(const Input& in) : l(in.a), r(in.b), out(2 * Frames, 0.0f) {
+        // the bus's lowpass at 6 kHz, two stages, gliding a little every block
+        const float w0 = 2.0f * 3.14159265f * 6000.0f / 48000.0f;
+        const float c = std::cos(w0), alpha = std::sin(w0) / (2.0f * 0.707f), a0 = 1.0f + alpha;
+        cascade.k = { (1.0f - c) * 0.5f / a0, (1.0f - c) / a0, (1.0f - c) * 0.5f / a0, -2.0f * c / a0, (1.0f - alpha) / a0 };
+        cascade.step = { 1e-7f, 2e-7f, 1e-7f, -1e-7f, 1e-7f };
+        cascade.stages = 2;
+
+        // ReverbSc's line lengths at 48 kHz, each read ~half a line back
+        const int sizes[8] = { 2473, 2767, 3217, 3557, 3907, 4127, 2143, 1933 };
+        std::mt19937 rng(99);
+        std::uniform_real_distribution<float> u(-0.5f, 0.5f);
+        lines.resize(8);
+        for (int k = 0; k < 8; k++) {
+            lines[k].resize((size_t)sizes[k] + 64);
+            for (auto& x : lines[k]) x = u(rng);
+            lanes.buffer_size[k] = (int)lines[k].size();
+            lanes.buf[k] = lines[k].data();
+            lanes.write_pos[k] = (int)(rng() % lines[k].size());
+            lanes.read_pos[k] = (lanes.write_pos[k] + lanes.buffer_size[k] / 2) % lanes.buffer_size[k];
+            lanes.read_pos_frac[k] = (int)(rng() % DELAYPOS_SCALE);
+            lanes.read_pos_frac_inc[k] = DELAYPOS_SCALE + (int)(rng() % 4096) - 2048;
+            lanes.line_cnt[k] = 1 << 30;
+            lanes.filter_state[k] = u(rng);
+        }
+        lanes.feedback = 0.85f;
+        lanes.feedback_target = 0.9f;
+        lanes.feedback_coef = 1e-3f;
+        lanes.damp_fact = 0.6f;
+    }
+};
+
+struct Case {
+    const char* name;
+    float tolerance;                  // largest |difference| from scalar
+    // one block of n frames at offset i; p is that block's parameter
+    std::function<void(const Kernels&, const Input&, State&, unsigned i, unsigned n, float p)> run;
+    std::function<std::vector<float>(const State&)> result;
+};
+
+std::vector<float> signal(const State& s) {
+    std::vector<float> v(s.l);
+    v.insert(v.end(), s.r.begin(), s.r.end());
+    return v;
+}
+
+const std::vector<Case>& cases() {
+    static const std::vector<Case> all = {
+        { "add", 0.0f,
+          [](const Kernels& k, const Input& in, State& s, unsigned i, unsigned n, float) { k.add(&s.l[i], &in.b[i], n); },
+          signal },
+        { "scale", 0.0f,
+          [](const Kernels& k, const Input&, State& s, unsigned i, unsigned n, float p) { k.scale(&s.l[i], p, n); },
+          signal },
+        { "blend", 1e-6f,
+          [](const Kernels& k, const Input& in, State& s, unsigned i, unsigned n, float p) {
+              k.blend(&s.l[i], &s.l[i], p, &in.b[i], 1.0f - p, n);
+          },
+          signal },
+        { "crossfade", 1e-5f,
+          [](const Kernels& k, const Input& in, State& s, unsigned i, unsigned n, float p) {
+              s.carry = k.crossfade(&s.l[i], &in.b[i], s.carry, (p - 0.5f) * 0.05f, n);
+          },
+          signal },
+        { "interleave", 0.0f,
+          [](const Kernels& k, const Input& in, State& s, unsigned i, unsigned n, float) {
+              k.interleave(&s.out[2 * i], &in.a[i], &in.b[i], n);
+          },
+          [](const State& s) { return s.out; } },
+        { "tableRead", 0.0f,
+          [](const Kernels& k, const Input& in, State& s, unsigned i, unsigned n, float) {
+              k.tableRead(&s.l[i], in.table.data(), &in.index[i], &in.frac[i], 0, n);
+          },
+          signal },
+        { "tableRead morph", 1e-6f,
+          [](const Kernels& k, const Input& in, State& s, unsigned i, unsigned n, float) {
+              k.tableRead(&s.l[i], in.table.data(), &in.index[i], &in.frac[i], 2048, n);
+          },
+          signal },
+        { "rampGain", 1e-5f,
+          [](const Kernels& k, const Input&, State& s, unsigned i, unsigned n, float p) {
+              s.carry = k.rampGain(&s.l[i], s.carry, (p - s.carry) / (float)n, n);
+          },
+          signal },
+        { "chaseGain", 1e-5f,
+          [](const Kernels& k, const Input&, State& s, unsigned i, unsigned n, float p) {
+              s.carry = k.chaseGain(&s.l[i], s.carry, p, p < 0.5f ? 0.9995f : 0.998f, n);
+          },
+          signal },
+        { "biquadCascade", 1e-4f,
+          [](const Kernels& k, const Input&, State& s, unsigned i, unsigned n, float) {
+              k.biquadCascade(&s.l[i], &s.r[i], n, s.cascade);
+          },
+          signal },
+        { "limit", 1e-5f,
+          [](const Kernels& k, const Input&, State& s, unsigned i, unsigned n, float p) {
+              for (unsigned j = i; j < i + n; j++) { s.l[j] *= 3.0f; s.r[j] *= 3.0f; }   // over the threshold
+              k.limit(&s.l[i], &s.r[i], n, s.limiter, 0.5f + 0.4f * p);
+          },
+          signal },
+        { "reverbLanes", 1e-4f,
+          [](const Kernels& k, const Input& in, State& s, unsigned i, unsigned n, float) {
+              k.reverbLanes(s.lanes, &in.a[i], &in.b[i], &s.l[i], &s.r[i], n);
+          },
+          signal },
+    };
+    return all;
+}
+
+// Largest difference from the scalar reference over the whole input.
+float check(const Case& c, const Kernels& k, const Input& in) {
+    State ref(in), test(in);
+    unsigned i = 0, step = 0;
+    while (i < Frames) {
+        const unsigned n = std::min(Lengths[step % std::size(Lengths)], Frames - i);
+        c.run(*kernelsFor(Isa::Scalar), in, ref, i, n, in.params[step]);
+        c.run(k, in, test, i, n, in.params[step]);
+        i += n;
+        step++;
+    }
+    const std::vector<float> a = c.result(ref), b = c.result(test);
+    float worst = 0.0f;
+    for (size_t j = 0; j < a.size(); j++) {
+        const float d = std::abs(a[j] - b[j]);
+        if (!(d <= worst)) worst = d;   // NaN counts as worst
+    }
+    return worst;
+}
+
+// ns per frame over 64-frame blocks
+double measure(const Case& c, const Kernels& k, const Input& in, double seconds) {
+    State s(in);
+    s.cascade.step = Biquad{0, 0, 0, 0, 0};   // no glide over seconds of blocks
+    uint64_t frames = 0;
+    const auto t0 = Clock::now();
+    double elapsed = 0.0;
+    do {
+        for (unsigned i = 0; i + Block <= Frames; i += Block)
+            c.run(k, in, s, i, Block, 0.5f);
+        frames += Frames;
+        elapsed = std::chrono::duration<double>(Clock::now() - t0).count();
+        // the limiter and ramps keep their signal bounded; refresh the rest
+        if ((frames / Frames) % 64 == 0) { s.l = in.a; s.r = in.b; }
+    } while (elapsed < seconds);
+    return 1e9 * elapsed / (double)frames;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    bool verifyOnly = false;
+    double seconds = 0.2;
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        if (a == "--verify")                       verifyOnly = true;
+        else if (a == "--seconds" && i + 1 < argc) seconds = std::max(0.01, std::atof(argv[++i]));
+    }
+
+    const Input in;
+    std::vector<const Kernels*> tables;
+    for (Isa isa : { Isa::Scalar, Isa::Sse2, Isa::Avx2, Isa::Avx512 })
+        if (const Kernels* k = kernelsFor(isa)) tables.push_back(k);
+
+    const Kernels& selected = selectKernels();
+    std::fflush(stdout);
+    std::printf("[Bench] cpu: %s; tables:", cpuFeatures());
+    for (const Kernels* k : tables) std::printf(" %s", k->name);
+    std::printf("; selected: %s\n", selected.name);
+
+    // --- Equivalence with the scalar reference ---
+    int failures = 0;
+    for (const Case& c : cases()) {
+        std::printf("[Check] %-16s", c.name);
+        for (size_t t = 1; t < tables.size(); t++) {
+            const float d = check(c, *tables[t], in);
+            const bool ok = d <= c.tolerance;
+            failures += !ok;
+            std::printf(" %s %.1e%s", tables[t]->name, d, ok ? "" : " FAIL");
+        }
+        std::printf("\n");
+    }
+    std::printf("[Check] %s\n", failures ? "tables differ from the reference" : "all tables match the reference");
+    if (verifyOnly) return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+
+    // --- Cost per table ---
+    std::printf("[Bench] %-16s", "ns/frame");
+    for (const Kernels* k : tables) std::printf(" %9s", k->name);
+    std::printf("   best speedup\n");
+    for (const Case& c : cases()) {
+        std::printf("[Bench] %-16s", c.name);
+        double scalar = 0.0, best = 1e30;
+        for (size_t t = 0; t < tables.size(); t++) {
+            const double ns = measure(c, *tables[t], in, seconds);
+            if (t == 0) scalar = ns;
+            best = std::min(best, ns);
+            std::printf(" %9.2f", ns);
+        }
+        std::printf("   %5.2fx\n", scalar / best);
+    }
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include "Keyboard.h"
+#include "Mode.h"
+#include "audio/Improviser.h"
+
+// --- Keyboard Layout Helper ---
+// Shared by the app and the offline renderer so a replayed session builds
+// exactly the keys the player had.
+
+// Keys on the keyboard and the first key's pitch. Anything built ahead of
+// the keyboard for its keys (the startup wavetables) uses these too.
+constexpr int    KeyboardKeys   = 30;
+constexpr double KeyboardBaseHz = 55.0;
+
+inline void layoutKeyboard(Keyboard& kb, int winW, int winH, const Mode& mode, int numKeys = KeyboardKeys) {
+    float gap = 0.0f; // min 2px gap between keys
+
+    // compute key width so that left/right padding == key width
+    float keyWidth = (winW - (numKeys - 1) * gap) / (numKeys + 2);
+    float keyHeight = winH * 0.66f;   // 75% height
+    float startX = keyWidth;          // padding = key width
+    float yPos = winH * 0.2f;
+
+    kb = Keyboard(
+        numKeys,
+        KeyboardBaseHz,
+        mode.ratios,
+        mode.labels,
+        Key::Sine,
+        keyWidth,
+        keyHeight,
+        gap,       // ✅ proper gap
+        startX,
+        yPos
+    );
+}
+
+// Where generated phrases are played: the lower-left part of the keys.
+inline void placeImproviser(ava::audio::Improviser& im, int winW, int winH) {
+    im.setBounds(0.03125f * winW, winH * 0.25f, winW * 0.5f, winH * 0.40f, winW, winH);
+}
+
+// The stress test plays over every key.
+inline void spreadImproviser(ava::audio::Improviser& im, int winW, int winH) {
+    im.setBounds(0.0f, winH * 0.2f, (float)winW, winH * 0.86f, winW, winH);
+}
@@ -0,0 +1,308 @@
+// -------------------------
+// AVA_Render: offline session renderer
+// -------------------------
+// Replays a session log (core/SessionLog.h) through the same Keyboard and
+// AudioEngine code the app runs, as fast as the CPU allows, with no window
+// or audio device. Writes the result to a float WAV and reports how long
+// each block took against its real-time budget, so CPU spikes players
+// report can be reproduced, profiled and bisected on a real performance.
+//
+//   AVA_Render <session.avs> [out.wav] [--block N] [--tail SECONDS] [--no-wav]
+//              [--reverb ID] [--ir impulse.wav] [--governor] [--pipeline]
+//              [--voice-threads N]
+//
+// --reverb pins one engine from audio/Reverb.h (overriding logged tier
+// changes) to compare what each costs on the same performance; --ir pins
+// the convolution reverb with that impulse response. Reverbs that use a
+// worker thread run it inline here, so renders stay deterministic.
+//
+// The quality governor is off unless --governor is given: it reacts to
+// measured load, which would make renders differ run to run. With it on,
+// load is against the real-time budget, as in the app.
+//
+// --pipeline renders with the effects on the FX worker thread, one block
+// behind the voices (AudioEngine::setPipelined): the WAV is the inline
+// render delayed by one block. --voice-threads N renders the keys on N
+// helper threads besides this one (AudioEngine::setVoiceThreads).
+//
+// Built with AVA_RT_CHECKS (audio/RtCheck.h), every heap call, lock, I/O
+// call or late block inside render() is reported with a backtrace, and
+// any violation makes the render exit non-zero.
+//
+// --stress runs the StressTest ramp instead of a session (no WAV unless an
+// output path is given): the CPU ceiling of this machine, without a device.
+//
+//   AVA_Render --stress [out.wav] [--performers N] [--step N] [--step-seconds S]
+//              [--stroke-ms MS] [--seed X] [--block N] [--governor]
+#include <SDL.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "core/SessionLog.h"
+#include "audio/AudioEngine.h"
+#include "audio/RtCheck.h"
+#include "audio/StressTest.h"
+#include "Keyboard.h"
+#include "Mode.h"
+#include "Panel.h"          // Slider: same enabled/scaled mapping as the panel
+#include "KeyboardLayout.h"
+#include "dr_wav.h"
+
+using ava::audio::AudioEngine;
+using Clock = std::chrono::steady_clock;
+
+// the per-frame panel → engine update from main.cpp
+static void applyPanel(AudioEngine& audio, const Slider* s) {
+    if (s[SessionEvent::TremoloDepth].enabled()) {
+        audio.setTremoloRate(s[SessionEvent::TremoloRate].scaledValue());
+        audio.setTremoloDepth(s[SessionEvent::TremoloDepth].scaledValue());
+    } else {
+        audio.setTremoloDepth(0.0f);
+    }
+    if (s[SessionEvent::ReverbMix].enabled()) {
+        audio.setReverbDecay(s[SessionEvent::ReverbDecay].scaledValue());
+        audio.setReverbMix(s[SessionEvent::ReverbMix].scaledValue());
+        audio.setReverbRoomSize(s[SessionEvent::RoomSize].scaledValue());
+    } else {
+        audio.setReverbMix(0.0f);
+    }
+}
+
+static WaveformInfo waveformByName(const std::string& name) {
+    for (const auto& wf : Waveform::available())
+        if (wf.name == name) return wf;
+    return Waveform::available()[0];
+}
+
+int main(int argc, char* argv[]) {
+    std::string inPath, outPath;
+    unsigned block = 256;
+    double tailSeconds = 3.0;
+    bool writeWav = true;
+    bool stress = false;
+    int reverbId = -1;
+    std::string irPath;
+    bool governor = false;
+    bool pipelined = false;
+    int voiceHelpers = 0;
+
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        if (a == "--block" && i + 1 < argc)      block = (unsigned)std::max(16, std::atoi(argv[++i]));
+        else if (a == "--tail" && i + 1 < argc)  tailSeconds = std::max(0.0, std::atof(argv[++i]));
+        else if (a == "--no-wav")                writeWav = false;
+        else if (a == "--stress")                stress = true;
+        else if (a == "--reverb" && i + 1 < argc) reverbId = std::atoi(argv[++i]);
+        else if (a == "--ir" && i + 1 < argc)    irPath = argv[++i];
+        else if (a == "--governor")              governor = true;
+        else if (a == "--pipeline")              pipelined = true;
+        else if (a == "--voice-threads" && i + 1 < argc) voiceHelpers = std::atoi(argv[++i]);
+        else if (a.rfind("--", 0) == 0)          i++;   // stress options, see configFromArgs
+        else if (stress && outPath.empty())      outPath = a;
+        else if (inPath.empty())                 inPath = a;
+        else if (outPath.empty())                outPath = a;
+    }
+    if (stress) {
+        writeWav = writeWav && !outPath.empty();
+    } else if (inPath.empty()) {
+        std::cerr << "usage: AVA_Render <session.avs> [out.wav] [--block N] [--tail S] [--no-wav] [--reverb ID]\n"
+                     "                  [--ir impulse.wav] [--governor] [--pipeline] [--voice-threads N]\n"
+                     "       AVA_Render --stress [out.wav] [--performers N] [--step N] [--step-seconds S]\n"
+                     "                  [--stroke-ms MS] [--seed X] [--block N] [--governor]\n";
+        return EXIT_FAILURE;
+    }
+    if (outPath.empty() && !stress) {
+        outPath = inPath;
+        size_t dot = outPath.find_last_of('.');
+        if (dot != std::string::npos && outPath.find_first_of("/\\", dot) == std::string::npos)
+            outPath.resize(dot);
+        outPath += ".wav";
+    }
+
+    std::vector<SessionEvent> events;
+    if (!stress && (!SessionReader::read(inPath, events) || events.empty())) return EXIT_FAILURE;
+
+    // --- Same starting state as the app: 12-TET, startup waveform, default sliders ---
+    int winW = 1920, winH = 1080;
+    for (const auto& ev : events) {
+        if (ev.type == SessionEvent::Window) { winW = ev.w; winH = ev.h; break; }
+    }
+
+    AudioEngine audio;
+    const unsigned sr = audio.getSampleRate();
+    audio.setTremoloWaveform(0);
+    audio.setOffline(true);
+    ava::audio::enableDenormalFlush();   // same float mode as the callback thread
+    audio.qualityGovernor().setEnabled(governor);
+    audio.setPipelined(pipelined);
+    if (voiceHelpers > 0) audio.setVoiceThreads(voiceHelpers);
+    if (!irPath.empty()) {
+        if (!audio.loadImpulseResponse(irPath)) return EXIT_FAILURE;
+        reverbId = ava::audio::ReverbConvolution;
+    } else if (reverbId >= 0) {
+        audio.setReverbEngine(reverbId);
+    }
+
+    Mode mode = Mode::equalTemperament(12, "|ET|12-TET");
+    Keyboard keyboard(KeyboardKeys, KeyboardBaseHz, mode.ratios, mode.labels, Key::Sine, 0, 0, 0, 0, 0);
+    layoutKeyboard(keyboard, winW, winH, mode);
+    keyboard.resize(winW, winH);
+    WaveformInfo wave = Waveform::available()[1];
+    keyboard.setWaveform(wave);
+    audio.setKeys(keyboard.getKeyPtrs());
+
+    std::vector<Slider> sliders(SessionEvent::ParamCount, Slider(0, 0, 0, 0, ""));
+    applyPanel(audio, sliders.data());
+    placeImproviser(audio.improviser(), winW, winH);
+
+    auto apply = [&](const SessionEvent& ev) {
+        switch (ev.type) {
+            case SessionEvent::FingerDown:
+            case SessionEvent::FingerMotion:
+            case SessionEvent::FingerUp:
+                keyboard.handleEvent(ev.toSDL(), winW, winH);
+                break;
+            case SessionEvent::Window:
+                if (ev.w != winW || ev.h != winH) {
+                    winW = ev.w;
+                    winH = ev.h;
+                    layoutKeyboard(keyboard, winW, winH, mode);
+                    audio.setKeys(keyboard.getKeyPtrs());
+                    placeImproviser(audio.improviser(), winW, winH);
+                }
+                break;
+            case SessionEvent::ModeChange:
+                mode = Mode(ev.name, ev.ratios, ev.labels);
+                layoutKeyboard(keyboard, winW, winH, mode);
+                audio.setKeys(keyboard.getKeyPtrs());
+                // the app re-applies the selector's entry, not a rebuilt Custom table
+                keyboard.setWaveform(waveformByName(wave.name));
+                break;
+            case SessionEvent::WaveformChange:
+                wave = (ev.name == "Custom") ? Waveform::custom(ev.real, ev.imag)
+                                             : waveformByName(ev.name);
+                keyboard.setWaveform(wave);
+                break;
+            case SessionEvent::Param:
+                if (ev.param == SessionEvent::Improviser) {
+                    // same seed → the same phrases, now on exact samples
+                    if (ev.value != 0.0f) audio.improviser().enable((uint32_t)ev.value);
+                    else                  audio.improviser().disable();
+                } else if (ev.param == SessionEvent::ReverbTier) {
+                    if (reverbId < 0) audio.setReverbTier((ava::audio::ReverbTier)(int)ev.value);
+                } else if (ev.param < SessionEvent::ParamCount) {
+                    sliders[ev.param].value = ev.value;
+                    applyPanel(audio, sliders.data());
+                }
+                break;
+        }
+    };
+
+    // --- Output ---
+    drwav* wav = nullptr;
+    if (writeWav) {
+        drwav_data_format fmt;
+        fmt.container = drwav_container_riff;
+        fmt.format = DR_WAVE_FORMAT_IEEE_FLOAT;
+        fmt.channels = 2;
+        fmt.sampleRate = sr;
+        fmt.bitsPerSample = 32;
+        wav = drwav_open_file_write(outPath.c_str(), &fmt);
+        if (!wav) {
+            std::cerr << "[Render] cannot open " << outPath << "\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    // --- Render: events are applied at the block they fall in, like the
+    // app applies them between callbacks ---
+    std::unique_ptr<ava::audio::StressTest> stressTest;
+    if (stress) {
+        stressTest = std::make_unique<ava::audio::StressTest>(
+            audio, ava::audio::StressTest::configFromArgs(argc, argv));
+        spreadImproviser(audio.improviser(), winW, winH);
+        stressTest->start(0.0);
+    }
+
+    const uint64_t endFrame = stress ? UINT64_MAX : std::max<uint64_t>(block,
+        (uint64_t)((events.back().timeMs / 1000.0 + tailSeconds) * sr));
+    const double budgetUs = 1e6 * block / sr;
+    std::vector<float> out((size_t)block * 2);
+    std::vector<double> blockUs;
+    if (!stress) blockUs.reserve((size_t)(endFrame / block) + 1);
+
+    size_t next = 0;
+    float peak = 0.0f;
+    auto t0 = Clock::now();
+    for (uint64_t frame = 0; frame < endFrame; frame += block) {
+        if (stressTest && !stressTest->update((double)frame / sr)) break;
+
+        const uint64_t nowMs = frame * 1000 / sr;
+        while (next < events.size() && events[next].timeMs <= nowMs)
+            apply(events[next++]);
+
+        auto b0 = Clock::now();
+        audio.render(out.data(), block);
+        blockUs.push_back(std::chrono::duration<double, std::micro>(Clock::now() - b0).count());
+
+        for (float v : out) peak = std::max(peak, std::abs(v));
+        if (wav) drwav_write(wav, out.size(), out.data());
+
+        ava::audio::QualityGovernor::Transition qt;
+        while (audio.qualityGovernor().pollTransition(qt))
+            ava::audio::QualityGovernor::print(std::cout, qt);
+    }
+    const double wallMs = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+    if (wav) drwav_close(wav);
+
+    // --- Report ---
+    std::vector<double> sorted = blockUs;
+    std::sort(sorted.begin(), sorted.end());
+    auto pct = [&](double p) { return sorted[std::min(sorted.size() - 1, (size_t)(p * sorted.size()))]; };
+    double sum = 0.0;
+    for (double v : blockUs) sum += v;
+    size_t over = std::count_if(blockUs.begin(), blockUs.end(), [&](double v) { return v > budgetUs; });
+
+    const double audioSec = (double)blockUs.size() * block / sr;
+    std::printf("[Render] %zu events, %.1f s of audio in %.0f ms (%.1fx real time), peak %.3f\n",
+                events.size(), audioSec, wallMs, audioSec * 1000.0 / std::max(1e-9, wallMs), peak);
+    std::printf("[Render] block %u (budget %.0f us): mean %.1f  p50 %.1f  p99 %.1f  max %.1f us, %zu over budget\n",
+                block, budgetUs, sum / blockUs.size(), pct(0.50), pct(0.99), sorted.back(), over);
+
+    // where the worst blocks are, to line them up with the performance
+    std::vector<size_t> worst(blockUs.size());
+    for (size_t i = 0; i < worst.size(); i++) worst[i] = i;
+    size_t shown = std::min<size_t>(5, worst.size());
+    std::partial_sort(worst.begin(), worst.begin() + shown, worst.end(),
+                      [&](size_t a, size_t b) { return blockUs[a] > blockUs[b]; });
+    for (size_t i = 0; i < shown; i++) {
+        size_t b = worst[i];
+        std::printf("[Render]   %8.3f s  %7.1f us  (%.0f%% of budget)\n",
+                    (double)b * block / sr, blockUs[b], 100.0 * blockUs[b] / budgetUs);
+    }
+    if (pipelined)
+        std::printf("[Render] pipelined: %llu of %zu blocks waited on the FX worker\n",
+                    (unsigned long long)audio.stats().fxWaits, blockUs.size());
+    if (voiceHelpers > 0) {
+        const auto st = audio.stats();
+        std::printf("[Render] voices on %d threads: %llu chunks parallel, %llu on this thread\n",
+                    audio.voiceThreads(), (unsigned long long)st.parallelChunks,
+                    (unsigned long long)st.serialChunks);
+    }
+    if (wav) std::printf("[Render] wrote %s\n", outPath.c_str());
+
+    // AVA_RT_CHECKS builds: any violation fails the render (CI gate)
+    if (ava::audio::RtCheck::enabled) {
+        const uint64_t v = ava::audio::RtCheck::violations();
+        std::printf("[RtCheck] %llu violation%s in the callback\n",
+                    (unsigned long long)v, v == 1 ? "" : "s");
+        if (v) return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,87 @@
+// -------------------------
+// AVA_ReverbBench: reverb engine cost
+// -------------------------
+// Runs every engine in audio/Reverb.h over the same input (noise bursts,
+// roughly a note every half second) in engine-sized blocks and reports the
+// CPU each one needs per second of audio, including work an engine hands
+// to its own thread (ConvolutionReverb's tail). The costUs column in
+// reverbEngines[] comes from this; the wet RMS is what the adapter gains
+// are matched on.
+//
+// The cost tables in the tree (reverbEngines[] from this bench, physicalModels[]
+// and VoiceWorkers::estimateCost() from AVA_VoiceBench) were all taken on
+// one x86-64 core, GCC -O2. Re-run both on the target machine to see where
+// its own budget lands.
+//
+//   AVA_ReverbBench [--seconds S] [--block N] [--decay FB]
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+#include "audio/Reverb.h"
+
+using namespace ava::audio;
+using Clock = std::chrono::steady_clock;
+
+int main(int argc, char* argv[]) {
+    double seconds = 20.0;
+    unsigned block = 256;
+    float decay = 0.85f;
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        if (a == "--seconds" && i + 1 < argc)    seconds = std::max(1.0, std::atof(argv[++i]));
+        else if (a == "--block" && i + 1 < argc) block = (unsigned)std::max(16, std::atoi(argv[++i]));
+        else if (a == "--decay" && i + 1 < argc) decay = (float)std::atof(argv[++i]);
+    }
+
+    const double sr = 48000.0;
+    const size_t frames = (size_t)(seconds * sr);
+
+    // input: 80 ms noise bursts, exponential decay, every 0.5 s
+    std::vector<float> in(frames);
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> noise(-1.0f, 1.0f);
+    for (size_t i = 0; i < frames; i++) {
+        const double t = std::fmod((double)i / sr, 0.5);
+        in[i] = t < 0.08 ? 0.3f * noise(rng) * (float)std::exp(-t * 40.0) : 0.0f;
+    }
+
+    std::vector<float> outL(block), outR(block);
+    double refRms = 0.0;
+
+    std::printf("[Bench] %.0f s at %.0f Hz, block %u, decay %.2f (T60 %.1f s)\n",
+                seconds, sr, block, decay, t60FromFeedback(decay));
+    std::printf("[Bench] %-14s %-5s %10s %8s %9s %10s\n",
+                "engine", "tier", "us/s", "core", "wet rms", "vs table");
+
+    for (int id = 0; id < ReverbCount; id++) {
+        auto rev = makeReverb(id, sr);
+        if (!rev) continue;              // convolution without the FFT
+        rev->setDecay(decay);
+        rev->setOffline(true);           // worker-thread stages count too
+
+        double busy = 0.0, sq = 0.0;
+        for (size_t pos = 0; pos < frames; pos += block) {
+            const size_t n = std::min<size_t>(block, frames - pos);
+            auto t0 = Clock::now();
+            rev->process(&in[pos], &in[pos], outL.data(), outR.data(), n);
+            busy += std::chrono::duration<double, std::micro>(Clock::now() - t0).count();
+            for (size_t i = 0; i < n; i++) sq += outL[i] * outL[i] + outR[i] * outR[i];
+        }
+
+        const double usPerSec = busy / seconds;
+        const double rms = std::sqrt(sq / (2.0 * frames));
+        if (id == 0) refRms = rms;
+        const ReverbInfo& info = reverbEngines[id];
+        std::printf("[Bench] %-14s %-5s %10.0f %7.2f%% %9.4f %9.2fx\n",
+                    info.name, tierName(info.tier), usPerSec, usPerSec / 1e4,
+                    rms, usPerSec / info.costUs);
+    }
+    std::printf("[Bench] wet rms relative to %s: match the adapter gains to it (now %.4f)\n",
+                reverbEngines[0].name, refRms);
+    return EXIT_SUCCESS;
+}
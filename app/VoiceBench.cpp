@@ -0,0 +1,185 @@
+// -------------------------
+// AVA_VoiceBench: voice rendering across threads
+// -------------------------
+// Sounds N keys of one source on an AudioEngine with the effects bypassed,
+// restriking them every half second, and renders the same audio with the
+// voices on 1, 2, … T threads (AudioEngine::setVoiceThreads). Reports the
+// time per block, the speedup over one thread and the scaling efficiency
+// (speedup / threads). The per-voice column at one thread is what
+// VoiceWorkers::estimateCost() and physicalModels[].costUs are matched on
+// (same machine as AVA_ReverbBench's numbers, see there).
+//
+//   AVA_VoiceBench [--verify] [--source NAME] [--voices N] [--threads T] [--seconds S] [--block N]
+//
+// NAME is a physical model (Tar, Pluck, Santur, Kamancheh, String, Setar,
+// Modal), Additive or Wavetable; default Setar, 16 voices (one full pool).
+// T defaults to the core count; the engine never uses more helpers than
+// there are spare cores.
+//
+// --verify checks the tremolo LFO instead (verifyTremolo) and exits with
+// 1 when it fails.
+#include <SDL.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "audio/AudioEngine.h"
+#include "Key.h"
+
+using namespace ava::audio;
+using Clock = std::chrono::steady_clock;
+
+static std::vector<std::unique_ptr<Key>> makeKeys(const std::string& source, int voices) {
+    std::vector<std::unique_ptr<Key>> keys;
+    for (int i = 0; i < voices; i++) {
+        auto k = std::make_unique<Key>(60.0f * i, 0.0f, 60.0f, 100.0f);
+        k->setFrequency(110.0 * std::pow(2.0, i / 12.0));
+
+        if (source == "Additive") {
+            HarmonicSpec spec;
+            for (int h = 1; h <= 32; h++) {
+                spec.amps.push_back(1.0f / h);
+                spec.phases.push_back(0.0f);
+            }
+            k->setAdditive(spec);
+        } else if (source == "Wavetable") {
+            std::vector<float> table(2048);
+            for (size_t s = 0; s < table.size(); s++)
+                table[s] = 0.9f * std::sin(2.0f * (float)M_PI * s / table.size());
+            k->setWavetable(table);
+            k->setFrequency(k->getFrequency());   // phaseInc follows the table size
+        } else {
+            for (int m = 0; m < PhysicalModelCount; m++)
+                if (source == physicalModels[m].name) k->setPhysical(m);
+        }
+        keys.push_back(std::move(k));
+    }
+    return keys;
+}
+
+// Two sine keys with tremolo, summed by VoiceWorkers (on two threads when
+// there is a spare core) a chunk at a time with the engine's clock,
+// against the same keys without tremolo times the LFO in closed form at
+// that clock. Any phase a key advanced for itself, or carried wrongly
+// across a chunk, shows as a mismatch.
+static bool verifyTremolo() {
+    const double sr = 48000.0;
+    const unsigned n = VoiceWorkers::MaxFrames;
+    const int chunks = (int)(2.0 * sr / n);
+
+    std::vector<std::unique_ptr<Key>> keys;   // 0, 1 with tremolo; 2, 3 without
+    for (int i = 0; i < 4; i++) {
+        auto k = std::make_unique<Key>(60.0f * (i % 2), 0.0f, 60.0f, 100.0f);
+        k->setOscillator(Key::Sine);
+        k->setFrequency(i % 2 ? 330.0 : 220.0);
+        k->tremRateParam = 0.3f;              // 3.1 Hz: no whole number of cycles per chunk
+        k->tremDepthParam = i < 2 ? 1.0f : 0.0f;
+        k->driveOn(k->x + 0.5f * k->w, k->y + 0.25f * k->h);   // a light touch: deep tremolo
+        keys.push_back(std::move(k));
+    }
+    const float depth = 0.3f * keys[0]->tremDepthParam * (1.0f - keys[0]->targetGain);
+    const double rateHz = 1.0 + keys[0]->tremRateParam * 7.0;
+
+    VoiceWorkers workers(1, sr);
+    workers.setMinCost(0.0f);
+    float wet[VoiceWorkers::MaxFrames], dry[VoiceWorkers::MaxFrames];
+    double worst = 0.0, peak = 0.0;
+    for (int c = 0; c < chunks; c++) {
+        const uint64_t clock = (uint64_t)c * n;
+        workers.clear();
+        workers.add(keys[0].get(), nullptr);
+        workers.add(keys[1].get(), nullptr);
+        workers.render(wet, n, clock);
+        std::fill(dry, dry + n, 0.0f);
+        keys[2]->render(dry, n, sr, clock);
+        keys[3]->render(dry, n, sr, clock);
+
+        for (unsigned i = 0; i < n; i++) {
+            // frame f plays the phase at f + 1, as process() does
+            const double cycles = rateHz * (double)(clock + i + 1) / sr;
+            const double lfo = 1.0 + depth * std::sin(2.0 * M_PI * (cycles - std::floor(cycles)));
+            worst = std::max(worst, std::abs(wet[i] - dry[i] * lfo));
+            peak = std::max(peak, (double)std::abs(dry[i]));
+        }
+    }
+    const bool ok = peak > 0.0 && worst <= 1e-5 * peak;
+    std::printf("[Check] tremolo          2 keys, %d threads, %d chunks: worst %.2e (peak %.2f)%s\n",
+                workers.threads(), chunks, worst, peak, ok ? "" : " FAIL");
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+    std::string source = "Setar";
+    int voices = 16;
+    int maxThreads = (int)std::clamp(std::thread::hardware_concurrency(), 1u, (unsigned)VoiceWorkers::MaxThreads);
+    double seconds = 10.0;
+    unsigned block = 256;
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        if (a == "--verify")                        return verifyTremolo() ? EXIT_SUCCESS : EXIT_FAILURE;
+        else if (a == "--source" && i + 1 < argc)   source = argv[++i];
+        else if (a == "--voices" && i + 1 < argc)   voices = std::max(1, std::atoi(argv[++i]));
+        else if (a == "--threads" && i + 1 < argc)  maxThreads = std::clamp(std::atoi(argv[++i]), 1, VoiceWorkers::MaxThreads);
+        else if (a == "--seconds" && i + 1 < argc)  seconds = std::max(1.0, std::atof(argv[++i]));
+        else if (a == "--block" && i + 1 < argc)    block = (unsigned)std::max(16, std::atoi(argv[++i]));
+    }
+
+    const double sr = 48000.0;
+    const uint64_t frames = (uint64_t)(seconds * sr);
+    const uint64_t restrike = (uint64_t)(0.5 * sr);
+    const double budgetUs = 1e6 * block / sr;
+    std::vector<float> out((size_t)block * 2);
+
+    std::printf("[Bench] %d %s voices, %.0f s at %.0f Hz, block %u (budget %.0f us)\n",
+                voices, source.c_str(), seconds, sr, block, budgetUs);
+    std::printf("[Bench] %7s %10s %8s %10s %8s %10s %9s\n",
+                "threads", "us/block", "budget", "us/s/voice", "speedup", "efficiency", "parallel");
+
+    double baseUs = 0.0;
+    for (int threads = 1; threads <= maxThreads; threads++) {
+        AudioEngine audio;
+        audio.setOffline(true);
+        audio.qualityGovernor().setEnabled(false);
+        audio.setTremoloDepth(0.0f);
+        audio.setReverbMix(0.0f);
+        audio.setVoiceThreads(threads - 1);
+        if (audio.voiceThreads() < threads) break;   // no spare core for another helper
+
+        auto keys = makeKeys(source, voices);
+        std::vector<Key*> ptrs;
+        for (auto& k : keys) ptrs.push_back(k.get());
+        audio.setKeys(ptrs);
+
+        double busy = 0.0;
+        uint64_t blocks = 0;
+        for (uint64_t frame = 0; frame < frames; frame += block) {
+            if (frame % restrike < block) {
+                for (auto& k : keys) {
+                    k->driveOff();
+                    k->driveOn(k->x + 0.5f * k->w, k->y + 0.5f * k->h);
+                }
+            }
+            auto t0 = Clock::now();
+            audio.render(out.data(), block);
+            busy += std::chrono::duration<double, std::micro>(Clock::now() - t0).count();
+            blocks++;
+        }
+        audio.clearKeys();
+
+        const double usPerBlock = busy / blocks;
+        if (threads == 1) baseUs = usPerBlock;
+        const double speedup = baseUs / usPerBlock;
+        const auto st = audio.stats();
+        const uint64_t chunks = st.parallelChunks + st.serialChunks;
+        std::printf("[Bench] %7d %10.1f %7.1f%% %10.0f %7.2fx %9.0f%% %8.0f%%\n",
+                    threads, usPerBlock, 100.0 * usPerBlock / budgetUs,
+                    busy / seconds / voices, speedup, 100.0 * speedup / threads,
+                    chunks ? 100.0 * st.parallelChunks / chunks : 0.0);
+    }
+    return EXIT_SUCCESS;
+}
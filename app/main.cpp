@@ -1,6 +1,8 @@
 #include <SDL.h>
 #include <cstdio>
 #include <cstdlib>
+#include <memory>
+#include <random>
 #include <map>
 #include <string>
 #include <vector>
@@ -10,19 +12,26 @@
 #include "WaveDiagram.h"
 #include "Keyboard.h"
 #include "Mode.h"
-#include "improviser.h"
 #include "Diagnostics.h"
 #include "TouchCrosshair.h"
 #include "Key.h"
 #include <glad/gl.h>
 #include "json.hpp"
 #include "ModeLoader.h"
+#include "ModeIndex.h"
 #include <nanovg.h>
 #include <nanovg_gl.h>
 #include "core/EventRouter.h"
+#include "core/StartupGraph.h"
+#include "core/SessionLog.h"
 #include "audio/AudioEngine.h"
+#include "audio/SpectrumAnalyzer.h"
+#include "audio/Recorder.h"
+#include "audio/StressTest.h"
 #include "UI.h"
 #include "Panel.h"
+#include "CatalogFetcher.h"
+#include "KeyboardLayout.h"
 #include <iostream>
 #include <string>
 #include <curl/curl.h>
@@ -149,103 +158,53 @@ static bool initGL(SDL_Window*& window, SDL_GLContext& glctx,
 
 
 
-// --- Keyboard Layout Helper ---
-    void layoutKeyboard(Keyboard& kb, int winW, int winH, const Mode& mode, int numKeys = 30) {
-    float gap = 0.0f; // min 2px gap between keys
-
-    // compute key width so that left/right padding == key width
-    float keyWidth = (winW - (numKeys - 1) * gap) / (numKeys + 2);
-    float keyHeight = winH * 0.66f;   // 75% height
-    float startX = keyWidth;          // padding = key width
-    float yPos = winH * 0.2f;
-
-    kb = Keyboard(
-        numKeys,
-        55.0,
-        mode.ratios,
-        mode.labels,
-        Key::Sine,
-        keyWidth,
-        keyHeight,
-        gap,       // ✅ proper gap
-        startX,
-        yPos
-    );
-}
-
-
-// helper json
-#include <nlohmann/json.hpp>
-
-using json = nlohmann::json;
-
-// Callback to capture curl response
-size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* s) {
-    s->append((char*)contents, size * nmemb);
-    return size * nmemb;
-}
-
-// Function to fetch JSON from API
-json fetch_json(const std::string& name, const std::string& pin, const std::string& file) {
-    CURL* curl = curl_easy_init();
-    if (!curl) throw std::runtime_error("Failed to initialize CURL");
-
-    std::string response;
-    std::string postData = R"({"name":")" + name + R"(","pin":")" + pin + R"(","file":")" + file + R"("})";
-
-    curl_easy_setopt(curl, CURLOPT_URL, "https://ava-api.doxameter.com/api/get_json");
-    curl_easy_setopt(curl, CURLOPT_POST, 1L);
-    struct curl_slist* headers = nullptr;
-    headers = curl_slist_append(headers, "Content-Type: application/json");
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, postData.c_str());
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-
-    CURLcode res = curl_easy_perform(curl);
-    curl_easy_cleanup(curl);
-    curl_slist_free_all(headers);
-
-    if (res != CURLE_OK) 
-        throw std::runtime_error(curl_easy_strerror(res));
-
-    return json::parse(response);
-}
-
-
-//end json helper
-
-
 // -------------------------
 // Main
 // -------------------------
 int main(int argc, char* argv[]) {
-    
-
-   // Declare JSON variables
-    json dastanj;
-
-    try {
-        // Fetch dastan
-        dastanj = fetch_json("ali", "1234", "dastan");
-        if (dastanj.is_array() && !dastanj.empty()) {
-            std::cout << "First element of dastan:\n";
-            std::cout << dastanj[0].dump(4) << "\n";
-        } else {
-            std::cout << "No elements found in dastan.\n";
-        }
-
-    } catch (const std::exception& e) {
-        std::cerr << "Error fetching JSON: " << e.what() << "\n";
+    // --replay <session.avs>: play a logged session back instead of logging one
+    // --stress [--performers N ...]: ramp the improviser up to find the ceiling
+    // --ir <impulse.wav>: convolution reverb with this impulse response
+    // --mlock: lock the real-time memory arena in RAM (may need privileges)
+    // --pipeline: effects on their own thread, one block behind the voices
+    // --voice-threads N: render keys on N more cores when polyphony is heavy
+    std::string replayPath, irPath;
+    bool stressRequested = false;
+    bool lockMemory = false;
+    bool pipelineFx = false;
+    int voiceHelpers = 0;
+    for (int i = 1; i < argc; i++) {
+        std::string a = argv[i];
+        if (a == "--replay" && i + 1 < argc) replayPath = argv[++i];
+        else if (a == "--stress") stressRequested = true;
+        else if (a == "--ir" && i + 1 < argc) irPath = argv[++i];
+        else if (a == "--mlock") lockMemory = true;
+        else if (a == "--pipeline") pipelineFx = true;
+        else if (a == "--voice-threads" && i + 1 < argc) voiceHelpers = std::atoi(argv[++i]);
     }
 
 
-
-    SDL_SetHint(SDL_HINT_ORIENTATIONS, "LandscapeLeft LandscapeRight");
-    #ifdef _WIN32
-        // 🚫 Disable Windows Ink / Touch visualization feedback
-        DisableWindowsTouchFeedback();
-    #endif
+    // -------------------------
+    // Startup graph
+    // -------------------------
+    // Independent phases run concurrently; GL/window work stays on this
+    // thread. Every phase is timed and logged as "[Startup] ...".
+    //
+    //   catalog ─────────────┐
+    //   tables ──────────────┼─ keyboard ─┐
+    //   gl ─── font          ┘            ├─ first-sound
+    //   audio-open ───────────────────────┘
+    StartupGraph boot;
+
+    // --- Mode catalog: local first, network refresh in the background ---
+    // libcurl's global state, cleaned up after the fetcher (declared
+    // below, so destroyed first) has joined its thread
+    struct CurlGlobal {
+        CurlGlobal()  { curl_global_init(CURL_GLOBAL_DEFAULT); }
+        ~CurlGlobal() { curl_global_cleanup(); }
+    } curlGlobal;
+    CatalogFetcher catalog(CatalogFetcher::configFromEnv());
+    json dastanj;
 
     SDL_Window* window = nullptr;
     SDL_GLContext glctx = nullptr;
@@ -253,42 +212,9 @@ int main(int argc, char* argv[]) {
     int fbW = 0, fbH = 0;
     float pxRatio = 1.0f;
 
-    if (!initGL(window, glctx, winW, winH, fbW, fbH, pxRatio))
-        return EXIT_FAILURE;
-
     float ddpi=96, hdpi=96, vdpi=96;
-    SDL_GetDisplayDPI(0, &ddpi, &hdpi, &vdpi);
-
-    NVGcontext* vg = nvgCreateGL3(NVG_ANTIALIAS | NVG_STENCIL_STROKES);
-    if (!vg) return EXIT_FAILURE;
-
-    int fontUi = nvgCreateFont(vg, "ui", "assets/Inconsolata-Light.ttf");
-    // int fontUi = nvgCreateFont(vg, "ui", "assets/FreeFarsi-Mono.ttf");
-
-    if (fontUi == -1) {
-        std::fprintf(stderr, "Failed to load Inconsolata-Light.ttf\n");
-        return EXIT_FAILURE;
-    }
-
-    
-
-    Calligraphy calligraphy(winW, winH);   // ✅ New Calligraphy
-    bool calligraphyEnabled = true;
-
-    bool running = true;
-    SDL_Event e;
-    EventRouter router(&running);
-    SDL_StartTextInput();
-
-    float avgDpi = (hdpi + vdpi) * 0.5f;
-    Units u(winW, winH, avgDpi);
-
-    Palette p;
-    HLine headerDivider(0, u.percentH(0.15f), winW, 2.0f, p.border);
-
-   
-
-
+    NVGcontext* vg = nullptr;
+    int fontUi = -1;
 
     // --- Keyboard Mode from Babel ---
 // Mode mode = Mode::Babel()[0];   // get the first mode in Babel
@@ -298,16 +224,6 @@ int main(int argc, char* argv[]) {
 
 
 std::vector<Mode> modes;
-try {
-    // modes = ModeLoader::fromJSON("assets/modes_eng.json");
-    // modes = ModeLoader::fromJSON("assets/dastandataeng.json");
-    modes = ModeLoader::fromJSON(dastanj);
-
-    std::cout << "Loaded " << modes.size() << " modes\n";
-} catch (const std::exception& ex) {
-    std::cerr << "JSON load failed: " << ex.what() << std::endl;
-    return EXIT_FAILURE;
-}
 
     // // load JSON modes
     // auto modes = ModeLoader::fromJSON("assets/dastandata.json");
@@ -338,8 +254,8 @@ try {
 
     // now build keyboard from that mode
     Keyboard keyboard(
-        30,                // numKeys
-        55.0,             // base frequency
+        KeyboardKeys,
+        KeyboardBaseHz,
         mode.ratios,       // ✅ from JSON
         mode.labels,       // ✅ from JSON
         Key::Sine,
@@ -347,20 +263,151 @@ try {
         0, 0
     );
 
-    layoutKeyboard(keyboard, winW, winH, mode, 30);
+    // Real-time arena (audio/RtMemory.h): key lists and wavetables the
+    // callback reads. Built and prefaulted by the engine's constructor.
+    ava::audio::RtArena::Config arenaCfg;
+    arenaCfg.lock = lockMemory;
+    ava::audio::RtArena::configure(arenaCfg);
 
-    AudioEngine audio;
+    AudioEngine audio;   // cheap: the device is opened by the audio-open phase
+    {
+        auto as = ava::audio::RtArena::global().stats();
+        std::cout << "[Memory] RT arena " << (as.capacity >> 20) << " MiB prefaulted"
+                  << (as.locked ? ", locked" : "") << "\n";
+    }
+
+    // Initial waveform (panel.oscWave index 1), tables prebuilt off-thread
+    const int startWaveIndex = 1;
+    const WaveformInfo startWave = Waveform::available()[startWaveIndex];
+    std::vector<std::vector<float>> startTables;
+
+    int phCatalog = boot.add("catalog", [&] {
+        dastanj = catalog.loadLocal();   // cache → bundled assets, never the network
+        catalog.startRefresh();
+        try {
+            // modes = ModeLoader::fromJSON("assets/modes_eng.json");
+            // modes = ModeLoader::fromJSON("assets/dastandataeng.json");
+            modes = ModeLoader::fromJSON(dastanj);
+
+            std::cout << "Loaded " << modes.size() << " modes (" << catalog.source() << ")\n";
+        } catch (const std::exception& ex) {
+            // not fatal: the ET keyboard still works, a refresh may fill this in
+            std::cerr << "JSON load failed: " << ex.what() << std::endl;
+        }
+        return true;
+    });
+
+    int phTables = boot.add("tables", [&] {
+        // same keys layoutKeyboard() will build, geometry doesn't matter here
+        Keyboard probe(KeyboardKeys, KeyboardBaseHz, mode.ratios, mode.labels, Key::Sine, 0, 0, 0, 0, 0);
+        startTables = probe.buildTables(startWave);
+        return true;
+    });
+
+    int phAudio = boot.add("audio-open", [&] {
+        return audio.open();
+    });
+
+    int phGL = boot.add("gl", [&] {
+        SDL_SetHint(SDL_HINT_ORIENTATIONS, "LandscapeLeft LandscapeRight");
+        #ifdef _WIN32
+            // 🚫 Disable Windows Ink / Touch visualization feedback
+            DisableWindowsTouchFeedback();
+        #endif
+
+        if (!initGL(window, glctx, winW, winH, fbW, fbH, pxRatio))
+            return false;
+
+        SDL_GetDisplayDPI(0, &ddpi, &hdpi, &vdpi);
+
+        vg = nvgCreateGL3(NVG_ANTIALIAS | NVG_STENCIL_STROKES);
+        return vg != nullptr;
+    }, {}, StartupGraph::Main);
+
+    int phFont = boot.add("font", [&] {
+        fontUi = nvgCreateFont(vg, "ui", "assets/Inconsolata-Light.ttf");
+        // int fontUi = nvgCreateFont(vg, "ui", "assets/FreeFarsi-Mono.ttf");
+
+        if (fontUi == -1) {
+            std::fprintf(stderr, "Failed to load Inconsolata-Light.ttf\n");
+            return false;
+        }
+        return true;
+    }, {phGL}, StartupGraph::Main);
+
+    int phKeyboard = boot.add("keyboard", [&] {
+        layoutKeyboard(keyboard, winW, winH, mode);
+
+        keyboard.resize(winW, winH);
+        keyboard.applyTables(startWave, startTables);
+        return true;
+    }, {phGL, phTables}, StartupGraph::Main);
+
+    boot.add("first-sound", [&] {
+        audio.setKeys(keyboard.getKeyPtrs());
         // Force tremolo waveform to Sine
-    audio.setKeys(keyboard.getKeyPtrs());
+        audio.setTremoloWaveform(0);
+        audio.setPipelined(pipelineFx);
+        if (voiceHelpers > 0) audio.setVoiceThreads(voiceHelpers);
+        audio.start();
+        boot.mark("first sound");
+        return true;
+    }, {phKeyboard, phAudio}, StartupGraph::Main);
+
+    if (!irPath.empty()) {
+        // long IRs take a while to read and transform: off the main thread
+        boot.add("impulse-response", [&] {
+            return audio.loadImpulseResponse(irPath);
+        }, {phAudio});
+    }
+
+    if (!boot.run()) {
+        // only the window/GL side is fatal; no audio device just means silence
+        if (!boot.ok(phGL) || !boot.ok(phFont)) return EXIT_FAILURE;
+        std::cerr << "Startup incomplete, continuing without some phases\n";
+    }
+    if (!boot.ok(phKeyboard)) keyboard.resize(winW, winH);
+
+    // --- Spectrum analyzer (header strip), fed by an engine output tap ---
+    ava::audio::SpectrumAnalyzer analyzer(audio.getSampleRate());
+    std::vector<float> spectrumDb;
+    bool analyzerOn = ava::audio::SpectrumAnalyzer::available()
+                      && audio.addTap(&analyzer.tap())
+                      && analyzer.start();
+
+    // --- Performance recorder (Rec button in the panel) ---
+    ava::audio::Recorder recorder(audio.getSampleRate());
+    audio.addTap(&recorder.tap());
+
+    // --- Session log (sessions/*.avs), or a replay of one ---
+    // Logging is on by default; AVA_SESSION_LOG=0 turns it off.
+    SessionWriter sessionLog;
+    std::unique_ptr<SessionPlayer> replay;
+    if (!replayPath.empty()) {
+        std::vector<SessionEvent> events;
+        if (SessionReader::read(replayPath, events))
+            replay = std::make_unique<SessionPlayer>(std::move(events));
+    } else {
+        const char* env = std::getenv("AVA_SESSION_LOG");
+        if (!env || std::string(env) != "0") sessionLog.open();
+    }
+    sessionLog.window(SDL_GetTicks(), winW, winH);
+    sessionLog.mode(SDL_GetTicks(), mode.name, mode.ratios, mode.labels);
 
-    audio.setTremoloWaveform(0);
+    Calligraphy calligraphy(winW, winH);   // ✅ New Calligraphy
+    bool calligraphyEnabled = true;
+
+    bool running = true;
+    uint64_t reportedXruns = 0;   // underflows already reported
+    SDL_Event e;
+    EventRouter router(&running);
+    SDL_StartTextInput();
+
+    float avgDpi = (hdpi + vdpi) * 0.5f;
+    Units u(winW, winH, avgDpi);
 
-    // --- Global AudioBus tuning ---
-    keyboard.setMasterGain(0.8f);
-    keyboard.setLimiterThreshold(0.98f);
-    keyboard.setLowpassHz(6000.0f);       // safe cutoff
-    keyboard.setLowpassQ(0.707f);         // smooth slope
-    keyboard.setLowpassEnabled(true);     // enable LPF
+    Palette p;
+    HLine headerDivider(0, u.percentH(0.15f), winW, 2.0f, p.border);
 
     // --- Keyboard Mode from JSON ---
     // Mode mode("empty", {}, {}); // placeholder
@@ -388,15 +435,21 @@ try {
     // ✅ Start diagnostics on all keys
     // Diagnostics::start(keyboard.getKeyPtrs(), 200, 0.9f, 8, 0.2f);
 
-    keyboard.resize(winW, winH);
-
    
 
-    TouchSketchGenerator improvLeft(winW, winH);
-    // TouchSketchGenerator improvRight(winW, winH);
-
-    improvLeft.setBounds(.03125*winW, winH * 0.25f, winW * 0.5f, winH * 0.40f);
-    // improvRight.setBounds(winW * 0.5f, winH * 0.25f, winW, winH * 0.85f);
+    // --- Improviser: plays inside the audio callback; strokes come back
+    // through its mark feed for drawing only ---
+    auto& improv = audio.improviser();
+    placeImproviser(improv, winW, winH);
+    uint32_t improvSeed = 0;   // next seed to use; a replay sets the logged one
+
+    std::unique_ptr<ava::audio::StressTest> stress;
+    if (stressRequested) {
+        stress = std::make_unique<ava::audio::StressTest>(
+            audio, ava::audio::StressTest::configFromArgs(argc, argv));
+        spreadImproviser(improv, winW, winH);
+        stress->start(SDL_GetTicks() / 1000.0);
+    }
 
     
 
@@ -441,54 +494,109 @@ try {
 
 
 // --- Panel ---
-Panel panel(keyboard, improvLeft);
+Panel panel(keyboard);
 panel.layout(winW, winH);
 
+panel.onImprov = [&](bool on) {
+    uint32_t seed = 0;
+    if (on) {
+        seed = improvSeed ? improvSeed : ((std::random_device{}() & 0xFFFFFFu) | 1u);
+        improvSeed = 0;
+        improv.enable(seed);
+    } else {
+        improv.disable();
+    }
+    sessionLog.param(SDL_GetTicks(), SessionEvent::Improviser, (float)seed);
+};
+
+
+panel.onReverbTier = [&](int tier) {
+    audio.setReverbTier((ava::audio::ReverbTier)tier);
+    sessionLog.param(SDL_GetTicks(), SessionEvent::ReverbTier, (float)tier);
+};
+
+panel.onRecord = [&](bool on) {
+    if (!on) { recorder.stop(); return false; }
+    return recorder.start();
+};
 
 FingerStatusBar fingerBar;   // ✅ new
 
     // --- 🔹 Define helper here ---
+    // The selector shows the current search result; shownModes maps its
+    // option index back into the full catalog.
+    ModeIndex modeIndex;
+    std::vector<int> shownModes;
+
+    // Rebuilds the keyboard for m; the selector and the replay both go through here.
+    auto applyMode = [&](const Mode& m) {
+        // ✅ Stop using old keys before building new ones
+        audio.clearKeys();
+        audio.stop();
+
+        mode = m;
+
+        // build keyboard with enum waveform type
+        keyboard = Keyboard(
+            KeyboardKeys, KeyboardBaseHz,
+            mode.ratios,
+            mode.labels,
+            Key::Sine,   // just a placeholder
+            0, 0, 0,
+            0, 0
+        );
+        layoutKeyboard(keyboard, winW, winH, mode);
+        audio.setKeys(keyboard.getKeyPtrs());
+        // ✅ Restart audio safely with new keys
+        audio.start();
+
+        // then sync with panel waveform
+        auto wf = panel.oscWave ? panel.oscWave->selected()
+                                : Waveform::available()[0];
+        keyboard.setWaveform(wf);
+
+        sessionLog.mode(SDL_GetTicks(), mode.name, mode.ratios, mode.labels);
+        // mode.debugPrint("Selected", 30, 110.0);
+    };
+
     auto populateModeSelector = [&](Panel& panel, const std::vector<Mode>& allModes) {
         if (!panel.modeSelector) return;
 
-        std::vector<std::string> names;
-        for (auto& m : allModes) {
-            names.push_back(m.name);
-        }
+        modeIndex.build(allModes);
 
-        panel.modeSelector->setOptions(names);
+        auto showMatches = [&](const std::string& text) {
+            ModeQuery q = ModeQuery::parse(text);
+            q.limit = allModes.size();
+            shownModes = modeIndex.search(q);
+
+            std::vector<std::string> names;
+            names.reserve(shownModes.size());
+            for (int i : shownModes) {
+                names.push_back(allModes[i].name);
+            }
+            panel.modeSelector->setOptions(names);
+        };
+        showMatches(panel.modeSearch ? panel.modeSearch->text : "");
 
         panel.modeSelector->onSelect = [&](int idx, const std::string&) {
-            if (idx < 0 || idx >= static_cast<int>(allModes.size())) return;
-                
-            // ✅ Stop using old keys before building new ones
-            audio.clearKeys();
-            audio.stop();
-
-            mode = allModes[idx];
-
-            // build keyboard with enum waveform type
-            keyboard = Keyboard(
-                30, 110.0,
-                mode.ratios,
-                mode.labels,
-                Key::Sine,   // just a placeholder
-                0, 0, 0,
-                0, 0
-            );
-            layoutKeyboard(keyboard, winW, winH, mode, 30);
-            audio.setKeys(keyboard.getKeyPtrs());
-            // ✅ Restart audio safely with new keys
-            audio.start();
-
-            // then sync with panel waveform
-            auto wf = panel.oscWave ? panel.oscWave->selected()
-                                    : Waveform::available()[0];
-            keyboard.setWaveform(wf);
-
-            // mode.debugPrint("Selected", 30, 110.0);
+            if (idx < 0 || idx >= static_cast<int>(shownModes.size())) return;
+            int modeIdx = shownModes[idx];
+            if (modeIdx < 0 || modeIdx >= static_cast<int>(allModes.size())) return;
+
+            applyMode(allModes[modeIdx]);
         };
 
+        // 🔹 Search: filter while typing, Enter picks the best match. Not on
+        // blur: a click on a result blurs the field first, and would pick
+        // result 0 instead of the one clicked.
+        if (panel.modeSearch) {
+            panel.modeSearch->onChange = [&, showMatches](const std::string& text) {
+                showMatches(text);
+            };
+            panel.modeSearch->onSubmit = [&](const std::string&) {
+                if (!shownModes.empty()) panel.modeSelector->select(0);
+            };
+        }
     };
 
 
@@ -499,10 +607,11 @@ FingerStatusBar fingerBar;   // ✅ new
 
 
 // 🔹 Connect callbacks
-panel.oscWave->onSelect = [&](int idx) {
+auto onWaveSelect = [&](int idx) {
     auto wf = panel.oscWave->selected();
     if (wf.name != "Custom") {
         keyboard.setWaveform(wf);
+        sessionLog.waveform(SDL_GetTicks(), wf.name);
     } else {
         // ✅ Ensure defaults appear in the input fields
         if (panel.realField->text == "Real")
@@ -510,37 +619,106 @@ panel.oscWave->onSelect = [&](int idx) {
         if (panel.imagField->text == "Imag")
             panel.imagField->text = "0 0 0 0";
 
-        auto parseList = [](const std::string& txt) {
-            std::vector<float> vals;
-            std::stringstream ss(txt);
-            float v;
-            while (ss >> v) vals.push_back(v);
-            return vals;
-        };
-
-        auto table = Waveform::buildTable(
-            parseList(panel.realField->text),
-            parseList(panel.imagField->text),
-            2048
-        );
-        WaveformInfo customWF {"Custom", [table]() { return table; }};
-        keyboard.setWaveform(customWF);
+        keyboard.setWaveform(Waveform::custom(panel.realField->text, panel.imagField->text));
+        sessionLog.waveform(SDL_GetTicks(), wf.name, panel.realField->text, panel.imagField->text);
     }
 };
+panel.oscWave->onSelect = onWaveSelect;
 
 // connectPanel();
 
 
 
 
-panel.oscWave->currentIndex = 1;
-if (panel.oscWave->onSelect)
-    panel.oscWave->onSelect(1);
+panel.oscWave->currentIndex = startWaveIndex;
+// tables for this waveform were already applied by the "keyboard" phase
+if (!boot.ok(phKeyboard) && panel.oscWave->onSelect)
+    panel.oscWave->onSelect(startWaveIndex);
+else
+    sessionLog.waveform(SDL_GetTicks(), startWave.name);
+
+    // Panel sliders by SessionEvent::ParamId (pointers change on relayout)
+    auto panelSlider = [&](uint8_t id) -> Slider* {
+        switch (id) {
+            case SessionEvent::TremoloRate:  return panel.tremRate;
+            case SessionEvent::TremoloDepth: return panel.tremDepth;
+            case SessionEvent::ReverbDecay:  return panel.reverbDecay;
+            case SessionEvent::ReverbMix:    return panel.reverbMix;
+            case SessionEvent::RoomSize:     return panel.roomSize;
+            default:                         return nullptr;
+        }
+    };
+
+    // Replayed input takes the same paths as live input: fingers go back
+    // into the SDL queue, modes/waveforms through the selector callbacks,
+    // slider values into the panel (read by the per-frame update below).
+    auto replayEvent = [&](const SessionEvent& ev) {
+        if (ev.isFinger()) {
+            SDL_Event fe = ev.toSDL();
+            SDL_PushEvent(&fe);
+        } else if (ev.type == SessionEvent::ModeChange) {
+            applyMode(Mode(ev.name, ev.ratios, ev.labels));
+        } else if (ev.type == SessionEvent::WaveformChange) {
+            auto& opts = panel.oscWave->options;
+            for (int i = 0; i < (int)opts.size(); i++) {
+                if (opts[i].name != ev.name) continue;
+                if (ev.name == "Custom") {
+                    panel.realField->text = ev.real;
+                    panel.imagField->text = ev.imag;
+                }
+                panel.oscWave->currentIndex = i;
+                if (panel.oscWave->onSelect) panel.oscWave->onSelect(i);
+                break;
+            }
+        } else if (ev.type == SessionEvent::Param) {
+            if (ev.param == SessionEvent::Improviser) {
+                improvSeed = (uint32_t)ev.value;
+                panel.setImproviser(ev.value != 0.0f);
+            } else if (ev.param == SessionEvent::ReverbTier) {
+                panel.setReverbTier((int)ev.value);
+            } else if (Slider* s = panelSlider(ev.param)) {
+                s->value = ev.value;
+            }
+        }
+        // window size: finger coordinates are normalized, nothing to do
+    };
+    if (replay) {
+        std::cout << "[Session] replaying " << replayPath << " ("
+                  << replay->lengthMs() / 1000.0 << " s)\n";
+        replay->start(SDL_GetTicks());
+    }
+
     std::map<SDL_FingerID, int> fingerToKey;
     // --- Loop ---
     while (running) {
+        // --- Session replay: whatever came due since the last frame ---
+        if (replay) {
+            replay->poll(SDL_GetTicks(), replayEvent);
+            if (replay->done()) {
+                std::cout << "[Session] replay finished\n";
+                replay.reset();
+            }
+        }
+
+        // --- Catalog update from the background fetch ---
+        json freshCatalog;
+        if (catalog.poll(freshCatalog)) {
+            try {
+                auto updated = ModeLoader::fromJSON(freshCatalog);
+                if (!updated.empty()) {
+                    modes = std::move(updated);
+                    populateModeSelector(panel, modes);
+                    std::cout << "Catalog updated: " << modes.size() << " modes\n";
+                }
+            } catch (const std::exception& ex) {
+                std::cerr << "Catalog update rejected: " << ex.what() << std::endl;
+            }
+        }
+
         while (SDL_PollEvent(&e)) {
             if (e.type == SDL_QUIT) running = false;
+            if (e.type == SDL_FINGERDOWN || e.type == SDL_FINGERMOTION || e.type == SDL_FINGERUP)
+                sessionLog.finger(e.tfinger);
             router.processEvent(e);
             crosshair.handleEvent(e, winW, winH);
             // ✅ Calligraphy events
@@ -586,35 +764,19 @@ if (panel.oscWave->onSelect)
                 calligraphy.resize(winW, winH);
                 calligraphy.clear();
                 headerDivider = HLine(0, u.percentH(0.15f), winW, 2.0f, p.border);
-                layoutKeyboard(keyboard, winW, winH, mode, 30);
+                audio.clearKeys();   // the old keys are destroyed by the relayout
+                layoutKeyboard(keyboard, winW, winH, mode);
                 // 🔹 update audio with new key pointers
                 audio.setKeys(keyboard.getKeyPtrs());
                 // Diagnostics::start(keyboard.getKeyPtrs(), 200, 0.9f, 8, 0.2f);
                 fingerBar.clear();   // ✅ clear slots on resize
                 panel.layout(winW, winH);
+                if (stress) spreadImproviser(improv, winW, winH);
+                else placeImproviser(improv, winW, winH);
                 populateModeSelector(panel, modes);
                 // re-assign callback after relayout
-                panel.oscWave->onSelect = [&](int idx) {
-                    auto wf = panel.oscWave->selected();
-                    if (wf.name != "Custom") {
-                        keyboard.setWaveform(wf);
-                    } else {
-                        auto parseList = [](const std::string& txt) {
-                            std::vector<float> vals;
-                            std::stringstream ss(txt);
-                            float v;
-                            while (ss >> v) vals.push_back(v);
-                            return vals;
-                        };
-                        auto table = Waveform::buildTable(
-                            parseList(panel.realField->text),
-                            parseList(panel.imagField->text),
-                            2048
-                        );
-                        WaveformInfo customWF {"Custom", [table]() { return table; }};
-                        keyboard.setWaveform(customWF);
-                    }
-                };
+                panel.oscWave->onSelect = onWaveSelect;
+                sessionLog.window(SDL_GetTicks(), winW, winH);
                 // 🔹 Re-apply BrighterSine after resize
                 panel.oscWave->currentIndex = 1;
                 if (panel.oscWave->onSelect)
@@ -622,6 +784,20 @@ if (panel.oscWave->onSelect)
             }
         }
         
+        // --- Session log: slider moves (only changes are written) ---
+        if (sessionLog.isOpen()) {
+            const uint32_t now = SDL_GetTicks();
+            for (uint8_t id = 0; id < SessionEvent::ParamCount; id++) {
+                if (Slider* s = panelSlider(id)) sessionLog.param(now, id, s->value);
+            }
+        }
+
+        // --- Recorder: a failed write ends the take on the writer thread
+        if (panel.recordEnabled && !recorder.isRecording()) {
+            recorder.stop();   // joins the writer
+            panel.setRecording(false);
+        }
+
         // --- Audio updates with enable/disable logic
         if (panel.tremoloEnabled()) {
             audio.setTremoloRate(panel.tremoloRate());
@@ -636,12 +812,44 @@ if (panel.oscWave->onSelect)
         } else {
             audio.setReverbMix(0.0f);
         }
-        if (panel.improviserEnabled()) {
-            improvLeft.update(winW, winH);
-        } else {
-            improvLeft.releaseAll();
+        // --- Underflows the callback counted, and arena blocks it let go of ---
+        if (const uint64_t xruns = audio.stats().xruns; xruns > reportedXruns) {
+            std::cerr << "Stream underflow detected! (" << xruns << " so far)\n";
+            reportedXruns = xruns;
+        }
+        ava::audio::RtArena::global().collect();
+
+        // --- Quality governor: log every step it took since the last frame ---
+        ava::audio::QualityGovernor::Transition qt;
+        while (audio.qualityGovernor().pollTransition(qt))
+            ava::audio::QualityGovernor::print(std::cout, qt);
+
+        // --- Stress ramp (--stress): one level every few seconds ---
+        if (stress && !stress->update(SDL_GetTicks() / 1000.0)) {
+            stress.reset();
+            placeImproviser(improv, winW, winH);
+        }
+
+        // --- Improviser strokes: crosshair + calligraphy only, the engine
+        // already played them ---
+        ava::audio::Improviser::Mark mark;
+        while (improv.pollMark(mark)) {
+            SDL_Event me{};
+            me.type = mark.phase == ava::audio::Improviser::Mark::Down ? SDL_FINGERDOWN
+                    : mark.phase == ava::audio::Improviser::Mark::Up   ? SDL_FINGERUP
+                                                                       : SDL_FINGERMOTION;
+            me.tfinger.touchId  = 1;
+            me.tfinger.fingerId = 900 + mark.stroke;
+            me.tfinger.x = mark.x;
+            me.tfinger.y = mark.y;
+            me.tfinger.pressure = 1.0f;
+            crosshair.handleEvent(me, winW, winH);
+            if (keyboard.calligraphyEnabled) {
+                if (me.type == SDL_FINGERDOWN) calligraphy.startStroke(me.tfinger);
+                else if (me.type == SDL_FINGERMOTION) calligraphy.moveStroke(me.tfinger);
+                else calligraphy.endStroke(me.tfinger);
+            }
         }
-        // improvRight.update(winW, winH);
 
         // --- Draw ---
         glViewport(0, 0, fbW, fbH);
@@ -649,6 +857,12 @@ if (panel.oscWave->onSelect)
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
         nvgBeginFrame(vg, winW, winH, pxRatio);
         headerDivider.draw(vg);
+        if (analyzerOn && !panel.visible) {
+            analyzer.latest(spectrumDb);
+            const auto& sc = analyzer.config();
+            drawSpectrum(vg, 0, u.percentH(0.05f), winW, u.percentH(0.095f),
+                         spectrumDb, sc.fMin, sc.fMax);
+        }
         keyboard.draw(vg);
         panel.draw(vg);
         if (keyboard.calligraphyEnabled) {
@@ -661,6 +875,13 @@ if (panel.oscWave->onSelect)
         SDL_GL_SwapWindow(window);
     }
 
+    // taps must be detached before their owners (declared later) go away
+    audio.removeTap(&recorder.tap());
+    recorder.stop();
+    audio.removeTap(&analyzer.tap());
+    analyzer.stop();
+    sessionLog.close();
+
     nvgDeleteGL3(vg);
     SDL_GL_DeleteContext(glctx);
     SDL_DestroyWindow(window);
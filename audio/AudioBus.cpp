@@ -0,0 +1,120 @@
+#include "AudioBus.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace ava::audio;
+
+namespace {
+
+constexpr float kPi = 3.14159265358979f;
+constexpr float kHighpassHz = 40.0f;     // DC / rumble
+constexpr float kGlideMs = 20.0f;        // cutoff and Q glide
+constexpr float kLowpassFadeMs = 10.0f;  // lowpass on/off crossfade
+constexpr float kReleaseMs = 80.0f;      // limiter recovery
+
+} // namespace
+
+// RBJ cookbook biquads, normalized by a0
+AudioBus::Coefs AudioBus::highpass(float sr, float hz, float q) {
+    const float w0 = 2.0f * kPi * hz / sr;
+    const float c = std::cos(w0), alpha = std::sin(w0) / (2.0f * q);
+    const float a0 = 1.0f + alpha;
+    Coefs k;
+    k.b0 = (1.0f + c) * 0.5f / a0;
+    k.b1 = -(1.0f + c) / a0;
+    k.b2 = k.b0;
+    k.a1 = -2.0f * c / a0;
+    k.a2 = (1.0f - alpha) / a0;
+    return k;
+}
+
+AudioBus::Coefs AudioBus::lowpass(float sr, float hz, float q) {
+    const float w0 = 2.0f * kPi * hz / sr;
+    const float c = std::cos(w0), alpha = std::sin(w0) / (2.0f * q);
+    const float a0 = 1.0f + alpha;
+    Coefs k;
+    k.b0 = (1.0f - c) * 0.5f / a0;
+    k.b1 = (1.0f - c) / a0;
+    k.b2 = k.b0;
+    k.a1 = -2.0f * c / a0;
+    k.a2 = (1.0f - alpha) / a0;
+    return k;
+}
+
+AudioBus::AudioBus(float sampleRate)
+    : sampleRate(sampleRate), limiter(sampleRate, kReleaseMs) {
+    hp.k = highpass(sampleRate, kHighpassHz, 0.707f);
+    lp.k = lowpass(sampleRate, lowpassHz, lowpassQ);
+    lp.stages = 2;
+    designedHz = lowpassHz;
+    designedQ = lowpassQ;
+}
+
+void AudioBus::process(float* left, float* right, int numFrames) {
+    if (numFrames <= 0) return;
+    const float n = (float)numFrames;
+
+    // --- Block-rate parameter updates ---
+    const float glide = 1.0f - std::exp(-n / (kGlideMs * 0.001f * sampleRate));
+    const float nyquistGuard = 0.45f * sampleRate;
+    lowpassHz += (std::clamp(lowpassHzParam.load(std::memory_order_relaxed), 20.0f, nyquistGuard) - lowpassHz) * glide;
+    lowpassQ  += (std::clamp(lowpassQParam.load(std::memory_order_relaxed), 0.1f, 10.0f) - lowpassQ) * glide;
+
+    const bool lowpassOn = lowpassParam.load(std::memory_order_relaxed);
+    const float mixTarget = lowpassOn ? 1.0f : 0.0f;
+    if (lowpassOn && lowpassMix == 0.0f) {
+        // fading in from silence: stale state would be heard, fresh state isn't
+        for (int st = 0; st < lp.stages; st++)
+            for (int c = 0; c < 2; c++) lp.s1[st][c] = lp.s2[st][c] = 0.0f;
+    }
+    const bool runLowpass = lowpassMix > 0.0f || lowpassOn;
+    const float mixStep = (mixTarget - lowpassMix) >= 0.0f
+        ? std::min(mixTarget - lowpassMix, n / (kLowpassFadeMs * 0.001f * sampleRate)) / n
+        : std::max(mixTarget - lowpassMix, -n / (kLowpassFadeMs * 0.001f * sampleRate)) / n;
+
+    // lowpass coefficients: interpolate from the current set to the new design
+    lp.step = Coefs{0, 0, 0, 0, 0};
+    if (runLowpass && (std::abs(lowpassHz - designedHz) > 1e-4f * designedHz
+                       || std::abs(lowpassQ - designedQ) > 1e-4f)) {
+        const Coefs target = lowpass(sampleRate, lowpassHz, lowpassQ);
+        lp.step.b0 = (target.b0 - lp.k.b0) / n;
+        lp.step.b1 = (target.b1 - lp.k.b1) / n;
+        lp.step.b2 = (target.b2 - lp.k.b2) / n;
+        lp.step.a1 = (target.a1 - lp.k.a1) / n;
+        lp.step.a2 = (target.a2 - lp.k.a2) / n;
+        designedHz = lowpassHz;
+        designedQ = lowpassQ;
+    }
+
+    const float gainStep = (gainParam.load(std::memory_order_relaxed) - gain) / n;
+    const float threshold = std::max(thresholdParam.load(std::memory_order_relaxed), 1e-3f);
+
+    // --- Stages, a block at a time ---
+    const dsp::Kernels& kn = dsp::kernels();
+    for (int start = 0; start < numFrames; start += BlockFrames) {
+        const unsigned m = (unsigned)std::min(BlockFrames, numFrames - start);
+        float* l = left + start;
+        float* r = right + start;
+
+        kn.biquadCascade(l, r, m, hp);
+
+        if (runLowpass) {
+            float wetL[BlockFrames], wetR[BlockFrames];
+            std::copy(l, l + m, wetL);
+            std::copy(r, r + m, wetR);
+            kn.biquadCascade(wetL, wetR, m, lp);
+            kn.crossfade(l, wetL, lowpassMix, mixStep, m);
+            lowpassMix = kn.crossfade(r, wetR, lowpassMix, mixStep, m);
+        }
+
+        kn.rampGain(l, gain, gainStep, m);
+        gain = kn.rampGain(r, gain, gainStep, m);
+
+        kn.limit(l, r, m, limiter, threshold);
+    }
+
+    // land exactly on the targets (no drift from the per-sample steps)
+    lowpassMix = std::clamp(lowpassMix, 0.0f, 1.0f);
+    if (!lowpassOn && lowpassMix < 1e-6f) lowpassMix = 0.0f;
+    if (lowpassOn && lowpassMix > 1.0f - 1e-6f) lowpassMix = 1.0f;
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include "../dsp/Kernels.h"
+
+namespace ava {
+namespace audio {
+
+// -------------------------
+// AudioBus
+// -------------------------
+// The engine's output stage (the graph's "bus" node), over both channels:
+// 40 Hz highpass → 24 dB/oct lowpass (two biquads) → master gain →
+// stereo-linked lookahead peak limiter. Each stage is one kernel call per
+// block (dsp/Kernels.h: biquadCascade, crossfade, rampGain, limit), in
+// blocks of BlockFrames so the lowpass's copy stays on the stack.
+//
+// Parameters are read once per block and glide instead of jumping: the
+// cutoff moves toward its target over ~20 ms and the lowpass coefficients
+// are interpolated across each block, the gain ramps per sample, and
+// switching the lowpass crossfades it in or out. Filter state is never
+// reset while it is heard, so automation doesn't click.
+//
+// The limiter delays the signal by Lookahead - 1 frames (~1.5 ms at 48
+// kHz) and fades its gain down over that window, so a peak arrives already
+// at the threshold rather than being clipped, then recovers over ~80 ms.
+// Setters are for the UI thread.
+class AudioBus {
+public:
+    static constexpr int Lookahead = dsp::Limiter::Lookahead;
+    static constexpr int BlockFrames = 64;
+
+    explicit AudioBus(float sampleRate = 48000.0f);
+
+    void setMasterGain(float g)       { gainParam.store(g, std::memory_order_relaxed); }
+    void setLimiterThreshold(float t) { thresholdParam.store(t, std::memory_order_relaxed); }
+    void setLowpassHz(float hz)       { lowpassHzParam.store(hz, std::memory_order_relaxed); }
+    void setLowpassQ(float q)         { lowpassQParam.store(q, std::memory_order_relaxed); }
+    void setLowpassEnabled(bool e)    { lowpassParam.store(e, std::memory_order_relaxed); }
+
+    // Audio thread, in place.
+    void process(float* left, float* right, int numFrames);
+
+    // Limiter gain applied to the last frame (1 = no reduction).
+    float limiterGain() const { return limiter.boxSum / (float)Lookahead; }
+
+private:
+    using Coefs = dsp::Biquad;
+
+    static Coefs highpass(float sampleRate, float hz, float q);
+    static Coefs lowpass(float sampleRate, float hz, float q);
+
+    float sampleRate;
+
+    std::atomic<float> gainParam{0.8f};
+    std::atomic<float> thresholdParam{0.9f};
+    std::atomic<float> lowpassHzParam{6000.0f};
+    std::atomic<float> lowpassQParam{0.707f};
+    std::atomic<bool>  lowpassParam{true};
+
+    // audio thread
+    dsp::BiquadCascade hp;           // one stage, fixed
+    dsp::BiquadCascade lp;           // two stages, coefficients interpolated
+    float lowpassHz = 6000.0f;       // gliding toward lowpassHzParam
+    float lowpassQ = 0.707f;
+    float designedHz = 0.0f, designedQ = 0.0f;   // what `lp` targets
+    float lowpassMix = 1.0f;         // 0 = lowpass bypassed, 1 = fully in
+    float gain = 0.8f;
+
+    dsp::Limiter limiter;
+};
+
+} // namespace audio
+} // namespace ava
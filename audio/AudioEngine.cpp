@@ -1,15 +1,19 @@
 #include "AudioEngine.h"
 #include <iostream>
 #include <algorithm>
+#include <cmath>
+#include <thread>
+#include <chrono>
+#include "../dsp/Kernels.h"
 #include "../ui/Key.h"
+#include "ConvolutionReverb.h"
+#include "RtCheck.h"
 
 using namespace ava::audio;
 
 AudioEngine::AudioEngine() {
-    if (dac.getDeviceCount() < 1) {
-        std::cerr << "No audio devices found!\n";
-        return;
-    }
+    // widest kernel table this CPU runs (dsp/Kernels.h), before any DSP
+    ava::dsp::selectKernels();
 
     // Init oscillator (fallback)
     osc.Init(sampleRate);
@@ -23,38 +27,169 @@ AudioEngine::AudioEngine() {
     tremLFO.SetFreq(tremRate);
     tremLFO.SetAmp(1.0f);
 
-    // Init reverb
-    reverb.Init(sampleRate);
-    reverb.SetFeedback(reverbDecay);
-    reverb.SetLpFreq(8000.0f);
+    // Init reverb (ReverbSc, the Medium tier), and the governor's fallback
+    setReverbEngine(ReverbDaisySc);
+    reverbLite = makeReverb(ReverbStkPrc, sampleRate);
+
+    // Physical-model voices: every model's pool up front (~2 ms), so a
+    // waveform change never allocates on the audio side
+    for (int m = 0; m < PhysicalModelCount; m++)
+        voicePools[m] = std::make_unique<VoicePool>((PhysicalModel)m, sampleRate);
+
+    // arena blocks retired mid-callback wait for this counter to move on
+    RtArena::global().watch(&callbackSeq);
+
+    buildGraph();
+}
+
+// --- Signal chain: the stages the callback used to hard-code ---
+void AudioEngine::buildGraph() {
+    // the app's bus tuning: gentle top end, limiter just under full scale
+    bus.setMasterGain(0.8f);
+    bus.setLimiterThreshold(0.98f);
+    bus.setLowpassHz(6000.0f);
+    bus.setLowpassQ(0.707f);
+    bus.setLowpassEnabled(true);
+
+    graph.add("voices", makeDspNode([this](float* l, float* r, unsigned n) { renderVoices(l, r, n); }));
+    graph.add("tremolo", makeDspNode([this](float* l, float* r, unsigned n) { applyTremolo(l, r, n); }),
+              { "voices" });
+    graph.add("reverb", makeDspNode([this](float* l, float* r, unsigned n) { applyReverb(l, r, n); }),
+              { "tremolo" });
+    graph.add("bus", makeDspNode([this](float* l, float* r, unsigned n) { bus.process(l, r, (int)n); }),
+              { "reverb" });
+}
+
+bool AudioEngine::open() {
+    if (isOpen()) return true;
+
+    try {
+        // constructing RtAudio probes the host API, part of the slow path
+        dac = std::make_unique<RtAudio>();
+    }
+    catch (const std::exception& e) {
+        std::cerr << "RtAudio error: " << e.what() << "\n";
+        return false;
+    }
+
+    if (dac->getDeviceCount() < 1) {
+        std::cerr << "No audio devices found!\n";
+        return false;
+    }
 
     RtAudio::StreamParameters oParams;
-    oParams.deviceId = dac.getDefaultOutputDevice();
+    oParams.deviceId = dac->getDefaultOutputDevice();
     oParams.nChannels = 2;
     oParams.firstChannel = 0;
 
     try {
-        dac.openStream(&oParams, nullptr, RTAUDIO_FLOAT32,
-                       sampleRate, &bufferFrames,
-                       &AudioEngine::audioCallback, this);
-        dac.startStream();
+        dac->openStream(&oParams, nullptr, RTAUDIO_FLOAT32,
+                        sampleRate, &bufferFrames,
+                        &AudioEngine::audioCallback, this);
     }
     catch (const std::exception& e) {
         std::cerr << "RtAudio error: " << e.what() << "\n";
+        return false;
     }
+    return isOpen();
 }
 
 AudioEngine::~AudioEngine() {
     stop();
+    pipeline.reset();
+    voiceWorkers.reset();
+    RtArena::global().watch(nullptr);
 }
 
 void AudioEngine::start() {
-    if (!dac.isStreamRunning()) dac.startStream();
+    if (!isOpen()) return;
+    if (!dac->isStreamRunning()) dac->startStream();
 }
 
 void AudioEngine::stop() {
-    if (dac.isStreamRunning()) dac.stopStream();
-    // if (dac.isStreamOpen()) dac.closeStream();
+    if (!isOpen()) return;
+    if (dac->isStreamRunning()) dac->stopStream();
+    // if (dac->isStreamOpen()) dac->closeStream();
+}
+
+// --- Output taps ---
+bool AudioEngine::addTap(AudioTap* tap) {
+    for (auto& slot : taps) {
+        AudioTap* expected = nullptr;
+        if (slot.compare_exchange_strong(expected, tap)) return true;
+    }
+    std::cerr << "AudioEngine: no free tap slot\n";
+    return false;
+}
+
+void AudioEngine::removeTap(AudioTap* tap) {
+    for (auto& slot : taps) {
+        AudioTap* expected = tap;
+        slot.compare_exchange_strong(expected, nullptr);
+    }
+    waitForCallback();
+}
+
+// wait out a callback that may have loaded a pointer we just replaced
+void AudioEngine::waitForCallback() {
+    unsigned seq = callbackSeq.load();
+    if (seq & 1u) {
+        while (callbackSeq.load() == seq) std::this_thread::yield();
+    }
+}
+
+void AudioEngine::swapReverb(std::unique_ptr<Reverb> next, int id) {
+    next->setDecay(reverbDecay);
+    next->setOffline(offline);
+    reverb.store(next.get());
+    waitForCallback();
+    reverbOwned = std::move(next);   // frees the old engine
+    reverbId = id;
+}
+
+bool AudioEngine::loadImpulseResponse(const std::string& path) {
+    auto conv = ConvolutionReverb::fromFile(path, sampleRate);
+    if (!conv) return false;
+    swapReverb(std::move(conv), ReverbConvolution);
+    return true;
+}
+
+void AudioEngine::setPipelined(bool on) {
+    if (on == isPipelined()) return;
+    if (on) {
+        pipeline = std::make_unique<FxPipeline>(
+            [this](float* l, float* r, unsigned n) { runEffects(l, r, n); });
+        graph.setBypass("voices", true);
+    } else {
+        graph.setBypass("voices", false);
+        pipeline.reset();
+    }
+    std::cout << "AudioEngine: effects " << (on ? "pipelined on a worker thread (+1 block latency)" : "inline") << "\n";
+}
+
+void AudioEngine::setVoiceThreads(int helpers) {
+    voiceWorkers.reset();
+    if (helpers > 0) voiceWorkers = std::make_unique<VoiceWorkers>(helpers, (double)sampleRate);
+    std::cout << "AudioEngine: voices on " << voiceThreads() << " thread"
+              << (voiceThreads() == 1 ? "" : "s") << "\n";
+}
+
+void AudioEngine::setOffline(bool off) {
+    offline = off;
+    if (reverbOwned) reverbOwned->setOffline(off);
+}
+
+void AudioEngine::setReverbEngine(int id) {
+    if (id == reverbId) return;
+    auto next = makeReverb(id, sampleRate);
+    if (!next) {
+        std::cerr << "AudioEngine: reverb " << id << " unavailable\n";
+        return;
+    }
+    swapReverb(std::move(next), id);
+    std::cout << "AudioEngine: reverb " << reverbEngines[id].name << " ("
+              << tierName(reverbEngines[id].tier) << ", "
+              << reverbEngines[id].costUs / 1e4f << "% of a core)\n";
 }
 
 // --- Panel parameter setters ---
@@ -66,6 +201,7 @@ void AudioEngine::setTremoloRate(float r) {
 
 void AudioEngine::setTremoloDepth(float d) {
     tremDepth = std::clamp(d, 0.0f, 1.0f);
+    graph.setBypass("tremolo", tremDepth == 0.0f);
 }
 
 void AudioEngine::setTremoloWaveform(int w) {
@@ -86,6 +222,7 @@ void AudioEngine::setReverbDecay(float d) {
 void AudioEngine::setReverbMix(float m) {
     wetMix = std::clamp(m, 0.0f, 1.0f);
     dryMix = 1.0f - wetMix;
+    graph.setBypass("reverb", wetMix == 0.0f);
 }
 
 void AudioEngine::setReverbRoomSize(float r) {
@@ -93,6 +230,12 @@ void AudioEngine::setReverbRoomSize(float r) {
     // not currently mapped → you can use to scale reverb params if desired
 }
 
+void AudioEngine::setMasterGain(float g)      { bus.setMasterGain(g); }
+void AudioEngine::setLimiterThreshold(float t) { bus.setLimiterThreshold(t); }
+void AudioEngine::setLowpassHz(float hz)       { bus.setLowpassHz(hz); }
+void AudioEngine::setLowpassQ(float q)         { bus.setLowpassQ(q); }
+void AudioEngine::setLowpassEnabled(bool e)    { bus.setLowpassEnabled(e); }
+
 void AudioEngine::setCustomHarmonics(const std::vector<float>& real,
                                      const std::vector<float>& imag) {
     harmonicsReal = real;
@@ -100,45 +243,328 @@ void AudioEngine::setCustomHarmonics(const std::vector<float>& real,
     // TODO: pass into your custom oscillator if Key::Custom is active
 }
 
-// --- Audio Callback ---
-int AudioEngine::audioCallback(void* outputBuffer, void*,
-                               unsigned int nFrames, double,
-                               RtAudioStreamStatus status, void* userData) {
-    auto* engine = static_cast<AudioEngine*>(userData);
-    float* out = static_cast<float*>(outputBuffer);
+// --- Render (shared by the callback and the offline renderer) ---
+void AudioEngine::render(float* out, unsigned int nFrames) {
+    RtCheck::Scope rtScope;   // AVA_RT_CHECKS builds: no heap, locks or I/O from here
+    const auto t0 = std::chrono::steady_clock::now();
+    const RtArray<Key*>* list = keyList.get();
+    keys = list ? list->span() : std::span<Key* const>{};
+    applyQuality();
+
+    // split the block wherever the improviser has something due, so its
+    // notes start on their own sample rather than at a block boundary
+    unsigned int done = 0;
+    while (done < nFrames) {
+        if (pipeline) {
+            const unsigned int n = std::min(nFrames - done, FxPipeline::MaxFrames);
+            renderPipelined(out + 2 * done, n);
+            done += n;
+            continue;
+        }
+        unsigned int n = (unsigned int)improv.run(keys, (int)(nFrames - done));
+        renderSpan(out + 2 * done, n);
+        done += n;
+    }
+
+    // --- Stats ---
+    int voices = 0;
+    for (auto* k : keys) voices += (k && k->isActive());
+
+    const uint64_t busy = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::steady_clock::now() - t0).count();
+    const uint64_t audioNs = (uint64_t)nFrames * 1000000000ull / sampleRate;
+    const float load = audioNs ? (float)busy / (float)audioNs : 0.0f;
+    RtCheck::block(busy, audioNs);
+
+    statBlocks.fetch_add(1, std::memory_order_relaxed);
+    statBusyNs.fetch_add(busy, std::memory_order_relaxed);
+    statAudioNs.fetch_add(audioNs, std::memory_order_relaxed);
+    if (load > 1.0f) statOverruns.fetch_add(1, std::memory_order_relaxed);
+    if (load > statPeakLoad.load(std::memory_order_relaxed))
+        statPeakLoad.store(load, std::memory_order_relaxed);
+    statVoices.store(voices, std::memory_order_relaxed);
+    if (voices > statPeakVoices.load(std::memory_order_relaxed))
+        statPeakVoices.store(voices, std::memory_order_relaxed);
+
+    // --- Quality for the next block ---
+    quality = governor.update(load, nFrames, (double)sampleRate, voices);
+}
+
+// --- Governor level → keys (and polyphony cap), once per block ---
+void AudioEngine::applyQuality() {
+    using Q = QualityGovernor;
+    int sounding = 0;
+    for (auto* k : keys) {
+        if (!k) continue;
+        k->setQuality(quality >= Q::ShortRelease, quality >= Q::LowHarmonics, quality >= Q::NoDetune);
+        sounding += (k->isActive() && !k->isReleasing());
+    }
+    if (quality < Q::CapPolyphony) return;
+
+    // release the quietest keys over the cap
+    for (int excess = sounding - governor.voiceCap(); excess > 0; excess--) {
+        Key* quietest = nullptr;
+        for (auto* k : keys) {
+            if (!k || !k->isActive() || k->isReleasing()) continue;
+            if (!quietest || k->getGain() < quietest->getGain()) quietest = k;
+        }
+        if (!quietest) break;
+        quietest->shed();
+    }
+}
 
-    if (status) std::cerr << "Stream underflow detected!\n";
+AudioEngine::Stats AudioEngine::stats() const {
+    Stats st;
+    st.blocks     = statBlocks.load(std::memory_order_relaxed);
+    st.xruns      = statXruns.load(std::memory_order_relaxed);
+    st.overruns   = statOverruns.load(std::memory_order_relaxed);
+    st.busyNs     = statBusyNs.load(std::memory_order_relaxed);
+    st.audioNs    = statAudioNs.load(std::memory_order_relaxed);
+    st.peakLoad   = statPeakLoad.load(std::memory_order_relaxed);
+    st.voices     = statVoices.load(std::memory_order_relaxed);
+    st.peakVoices = statPeakVoices.load(std::memory_order_relaxed);
+    st.fingers    = improv.activeStrokes();
+    st.quality    = governor.level();
+    st.fxWaits    = pipeline ? pipeline->waits() : 0;
+    if (voiceWorkers) {
+        const VoiceWorkers::Stats vw = voiceWorkers->stats();
+        st.parallelChunks = vw.parallelChunks;
+        st.serialChunks   = vw.serialChunks;
+    }
+    return st;
+}
+
+void AudioEngine::resetPeaks() {
+    statPeakLoad.store(0.0f, std::memory_order_relaxed);
+    statPeakVoices.store(0, std::memory_order_relaxed);
+}
+
+void AudioEngine::renderSpan(float* out, unsigned int nFrames) {
+    for (unsigned int start = 0; start < nFrames; start += ChunkFrames) {
+        const unsigned int n = std::min(ChunkFrames, nFrames - start);
+        renderKeys(n);
+        graph.process(n);
+        voiceClock += n;
 
-    for (unsigned int i = 0; i < nFrames; i++) {
-        float drySignal = 0.0f;
+        ava::dsp::kernels().interleave(out + 2 * start, graph.leftBuffer(), graph.rightBuffer(), n);
+    }
+}
+
+// --- Pipelined: this block's voices while the worker runs the effects on
+// the last one, then the last one's output ---
+void AudioEngine::renderPipelined(float* out, unsigned int nFrames) {
+    pipeline->begin();
+    float* dryL = pipeline->dryLeft();
+    float* dryR = pipeline->dryRight();
+    unsigned int done = 0;
+    while (done < nFrames) {
+        unsigned int n = (unsigned int)improv.run(keys, (int)(nFrames - done));
+        renderDrySpan(dryL + done, dryR + done, n);
+        done += n;
+    }
+    pipeline->finish(out, nFrames);
+}
+
+void AudioEngine::renderDrySpan(float* left, float* right, unsigned int nFrames) {
+    for (unsigned int start = 0; start < nFrames; start += ChunkFrames) {
+        const unsigned int n = std::min(ChunkFrames, nFrames - start);
+        renderKeys(n);
+        renderVoices(left + start, right + start, n);
+        voiceClock += n;
+    }
+}
+
+// --- FX worker: the graph ("voices" bypassed) over a whole block ---
+void AudioEngine::runEffects(float* left, float* right, unsigned int nFrames) {
+    for (unsigned int start = 0; start < nFrames; start += ChunkFrames)
+        graph.process(left + start, right + start, std::min(ChunkFrames, nFrames - start));
+}
+
+// --- "voices": every key summed, the same signal on both channels ---
+void AudioEngine::renderVoices(float* left, float* right, unsigned int n) {
+    if (voiceMixReady) {   // summed by the voice workers
+        voiceMixReady = false;
+        std::copy(voiceMix, voiceMix + n, left);
+        std::copy(voiceMix, voiceMix + n, right);
+        return;
+    }
+
+    // Sum all keys, each a span at a time (Key::render)
+    std::fill(left, left + n, 0.0f);
+    for (auto* k : keys) {
+        if (k) k->render(left, n, sampleRate, voiceClock);
+    }
+
+    if (keys.empty() && key) {
+        key->render(left, n, sampleRate, voiceClock);
+    }
+
+    if (!key && keys.empty()) {
+        for (unsigned int i = 0; i < n; i++) left[i] = osc.Process();
+    }
+
+    std::copy(left, left + n, right);
+}
+
+// --- "tremolo": amplitude modulation ---
+void AudioEngine::applyTremolo(float* left, float* right, unsigned int n) {
+    for (unsigned int i = 0; i < n; i++) {
+        float lfo = tremLFO.Process();   // -1..1
+        float mod = 0.5f * (lfo + 1.0f); // → 0..1
+        float trem = 1.0f - tremDepth + tremDepth * mod;
+        left[i] *= trem;
+        right[i] *= trem;
+    }
+}
+
+// --- "reverb": mono send (the mid signal), wet mixed back per channel ---
+void AudioEngine::applyReverb(float* left, float* right, unsigned int n) {
+    const ava::dsp::Kernels& kn = ava::dsp::kernels();
+    float send[ChunkFrames], wetL[ChunkFrames], wetR[ChunkFrames];
+    kn.blend(send, left, 0.5f, right, 0.5f, n);
+
+    mixReverb(send, wetL, wetR, n);
+
+    kn.blend(left, left, dryMix, wetL, wetMix, n);
+    kn.blend(right, right, dryMix, wetR, wetMix, n);
+}
 
-        // Sum all keys
-        for (auto* k : engine->keys) {
-            if (k) drySignal += k->process(engine->sampleRate);
+// --- Reverb (block path, feedback glides to the panel value). At
+// LiteReverb the engine reverb hands over to reverbLite: a 50 ms crossfade
+// down, 1.5 s back up so the engine reverb's paused tail fades in under
+// fresh input. Both run only while crossfading. ---
+void AudioEngine::mixReverb(const float* dry, float* wetL, float* wetR, unsigned int n) {
+    const float target = quality >= QualityGovernor::LiteReverb ? 1.0f : 0.0f;
+    const bool runMain = liteMix < 1.0f || target < 1.0f;
+    const bool runLite = liteMix > 0.0f || target > 0.0f;
+
+    if (runMain) {
+        Reverb* rev = reverb.load(std::memory_order_acquire);
+        rev->setDecay(reverbDecay);
+        rev->process(dry, dry, wetL, wetR, n);
+    }
+    if (!runLite) return;
+
+    float liteL[ChunkFrames], liteR[ChunkFrames];
+    reverbLite->setDecay(reverbDecay);
+    reverbLite->process(dry, dry, liteL, liteR, n);
+    if (!runMain) {
+        std::copy(liteL, liteL + n, wetL);
+        std::copy(liteR, liteR + n, wetR);
+        return;
+    }
+
+    const float seconds = target > liteMix ? 0.05f : 1.5f;
+    const float step = (target > liteMix ? 1.0f : -1.0f) / (seconds * (float)sampleRate);
+    const ava::dsp::Kernels& kn = ava::dsp::kernels();
+    kn.crossfade(wetL, liteL, liteMix, step, n);
+    liteMix = kn.crossfade(wetR, liteR, liteMix, step, n);
+}
+
+// --- Keys for the next n frames: their physical voices, and with voice
+// workers the whole key sum, which "voices" then picks up ---
+void AudioEngine::renderKeys(unsigned int n) {
+    if (!voiceWorkers || keys.size() > (size_t)VoiceWorkers::MaxKeys) {
+        for (auto* k : keys) {
+            if (k) renderVoice(*k, n);
         }
+        return;
+    }
+
+    // pool bookkeeping stays on this thread; a voice a later key stole in
+    // the same pass is dropped here, so no voice is rendered twice
+    for (size_t i = 0; i < keys.size(); i++)
+        preparedVoices[i] = keys[i] ? prepareVoice(*keys[i]) : nullptr;
+    voiceWorkers->clear();
+    for (size_t i = 0; i < keys.size(); i++) {
+        Key* k = keys[i];
+        if (!k) continue;
+        VoiceSource* v = preparedVoices[i];
+        if (v && !voicePools[k->voicePool]->owns(k->voiceSlot, k->voiceGeneration)) v = nullptr;
+        voiceWorkers->add(k, v);
+    }
+    voiceWorkers->render(voiceMix, n, voiceClock);
+    voiceMixReady = true;
+}
+
+// --- Source block of one key for the next n frames: its physical-model
+// voice, or its wavetable read ahead ---
+void AudioEngine::renderVoice(Key& k, unsigned int n) {
+    if (VoiceSource* v = prepareVoice(k)) {
+        v->render(k.voiceBlock, n);
+        k.voiceFrames = (int)n;
+    } else if (k.source == Key::Wavetable) {
+        k.renderTable(n, sampleRate);
+    }
+}
 
-        if (engine->keys.empty() && engine->key) {
-            drySignal = engine->key->process(engine->sampleRate);
+// Pool bookkeeping, strike/damp and per-block controls; returns the voice
+// to render into k.voiceBlock, or nullptr.
+VoiceSource* AudioEngine::prepareVoice(Key& k) {
+    k.voiceFrames = 0;
+    k.voiceRead = 0;
+    if (k.voiceSlot < 0 && k.source != Key::Physical) return nullptr;
+
+    // drop a voice that was stolen, or belongs to the key's previous source
+    if (k.voiceSlot >= 0) {
+        VoicePool* held = voicePools[k.voicePool].get();
+        if (!held->owns(k.voiceSlot, k.voiceGeneration)) {
+            k.voiceSlot = -1;
+        } else if (k.source != Key::Physical || k.voicePool != k.voiceModel || !k.isActive()) {
+            held->release(k.voiceSlot);
+            k.voiceSlot = -1;
         }
+    }
+    if (k.source != Key::Physical || k.voiceModel < 0 || k.voiceModel >= PhysicalModelCount) return nullptr;
 
-        if (!engine->key && engine->keys.empty()) {
-            drySignal = engine->osc.Process();
+    VoicePool& pool = *voicePools[k.voiceModel];
+    const float detune = std::exp2(k.detuneAmount * (1.0f / 1200.0f));
+    const float freq = (float)k.getFrequency() * detune;
+
+    if (k.voiceStrike) {
+        k.voiceStrike = false;
+        k.voiceDamp = false;
+        if (k.voiceSlot < 0) {
+            k.voiceSlot = pool.acquire();
+            k.voicePool = k.voiceModel;
+            k.voiceGeneration = pool.generation(k.voiceSlot);
         }
+        pool.voice(k.voiceSlot).strike(freq, k.targetGain);
+    }
+    if (k.voiceSlot < 0) return nullptr;
+
+    VoiceSource& v = pool.voice(k.voiceSlot);
+    if (k.voiceDamp) {
+        k.voiceDamp = false;
+        v.release();
+    }
+    v.setFrequency(freq);
+    v.setPressure(k.targetGain);
+    return &v;
+}
+
+// --- Audio Callback ---
+int AudioEngine::audioCallback(void* outputBuffer, void*,
+                               unsigned int nFrames, double,
+                               RtAudioStreamStatus status, void* userData) {
+    RtCheck::Scope rtScope;
+    auto* engine = static_cast<AudioEngine*>(userData);
+    float* out = static_cast<float*>(outputBuffer);
 
-        // --- Tremolo (amplitude modulation) ---
-        float lfo = engine->tremLFO.Process();   // -1..1
-        float mod = 0.5f * (lfo + 1.0f);         // → 0..1
-        float trem = 1.0f - engine->tremDepth + engine->tremDepth * mod;
-        drySignal *= trem;
+    // counted only: the UI thread reports underflows (no iostream in here)
+    if (status) engine->statXruns.fetch_add(1, std::memory_order_relaxed);
 
-        // --- Reverb ---
-        float wetL = 0.0f, wetR = 0.0f;
-        engine->reverb.SetFeedback(engine->reverbDecay);
-        engine->reverb.Process(drySignal, drySignal, &wetL, &wetR);
+    engine->callbackSeq.fetch_add(1);   // seq_cst: pairs with waitForCallback()
+    enableDenormalFlush();              // per callback: hosts may switch threads
 
-        // --- Mix dry + wet ---
-        out[i * 2 + 0] = engine->dryMix * drySignal + engine->wetMix * wetL;
-        out[i * 2 + 1] = engine->dryMix * drySignal + engine->wetMix * wetR;
+    engine->render(out, nFrames);
+
+    // --- Taps (wait-free copy, drops when a reader falls behind) ---
+    for (auto& slot : engine->taps) {
+        AudioTap* tap = slot.load();
+        if (tap) tap->write(out, (size_t)nFrames * 2);
     }
+
+    engine->callbackSeq.fetch_add(1);   // seq_cst: pairs with waitForCallback()
     return 0;
 }
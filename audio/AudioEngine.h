@@ -1,9 +1,19 @@
 #pragma once
 #include <vector>
 #include <memory>
+#include <atomic>
 #include <rtaudio/RtAudio.h>
 #include "../ui/Key.h"
-#include "Effects/reverbsc.h"
+#include "AudioBus.h"
+#include "Reverb.h"
+#include "PhysicalVoice.h"
+#include "QualityGovernor.h"
+#include "SpscRing.h"
+#include "RtMemory.h"
+#include "DspGraph.h"
+#include "FxPipeline.h"
+#include "VoiceWorkers.h"
+#include "Improviser.h"
 
 // DaisySP includes
 #include "daisysp.h"
@@ -13,14 +23,31 @@ namespace audio {
 
 class AudioEngine {
 public:
-    AudioEngine();
+    AudioEngine();          // DSP setup only, cheap
     ~AudioEngine();
 
+    // Opens the output device (slow on some hosts). Safe to run on a
+    // startup worker thread; the stream is not started until start().
+    bool open();
+    bool isOpen() const { return dac && dac->isStreamOpen(); }
+
     void start();
     void stop();
 
     void setKey(Key* k) { key = k; }
-    void setKeys(const std::vector<Key*>& ks) { keys = ks; }
+    // The list is copied into the RT arena and published as one pointer;
+    // the previous list is freed once the callback is done with it. The
+    // keys' finger changes are routed to render() from here on (see
+    // Key::onTouch).
+    void setKeys(const std::vector<Key*>& ks) {
+        for (Key* k : ks) {
+            if (!k) continue;
+            k->onTouch = [this](Key& key, Key::TouchPhase phase, int held, float intensity, float detune) {
+                improv.touch(key, phase, held, intensity, detune);
+            };
+        }
+        keyList.reset(RtArray<Key*>::make(ks.data(), ks.size()));
+    }
 
     // --- Panel setters ---
     void setTremoloRate(float r);
@@ -31,25 +58,113 @@ public:
     void setReverbMix(float m);
     void setReverbRoomSize(float r);
 
+    // 🔹 Reverb engine (Reverb.h). Builds the new one on the calling (UI)
+    // thread, swaps it in and frees the old one once the callback is done
+    // with it. The new engine starts with an empty tail.
+    void setReverbEngine(int id);
+    void setReverbTier(ReverbTier t) { setReverbEngine(reverbForTier(t)); }
+    int  reverbEngine() const { return reverbId; }
+    // Impulse response (WAV) as the reverb: ConvolutionReverb.h
+    bool loadImpulseResponse(const std::string& path);
+    // render() is driven faster than real time (AVA_Render): reverbs that
+    // use a worker thread compute inline. Call before the first render().
+    void setOffline(bool off);
+
     void setCustomHarmonics(const std::vector<float>& real,
                             const std::vector<float>& imag);
 
+    // 🔹 Output bus (AudioBus.h, stereo): HPF, 24 dB LPF, master gain,
+    // lookahead limiter. The last stage of the graph; changes glide.
+    void setMasterGain(float g);
+    void setLimiterThreshold(float t);
+    void setLowpassHz(float hz);
+    void setLowpassQ(float q);
+    void setLowpassEnabled(bool e);
+
+    // 🔹 Signal chain (DspGraph.h): "voices" → "tremolo" → "reverb" → "bus".
+    // Effects are added and reordered there; a bypassed stage isn't run.
+    // Tremolo at depth 0 and reverb at mix 0 bypass themselves.
+    DspGraph& dspGraph() { return graph; }
+
+    // 🔹 Pipelined mode (FxPipeline.h): the callback renders the voices of
+    // block N while a worker thread runs the rest of the graph on block
+    // N-1. Costs one block of latency; worth it when the reverb or a
+    // convolution is the heavy part and there are idle cores. "voices"
+    // then runs ahead of the graph and shows as bypassed in it. Call while
+    // the stream is stopped (before start()).
+    void setPipelined(bool on);
+    bool isPipelined() const { return pipeline != nullptr; }
+
+    // 🔹 Voice rendering on `helpers` extra threads (VoiceWorkers.h), one
+    // per spare core at most; 0 renders every key on the callback thread.
+    // Light chunks stay on the callback either way. Call while the stream
+    // is stopped (before start()).
+    void setVoiceThreads(int helpers);
+    int  voiceThreads() const { return voiceWorkers ? voiceWorkers->threads() : 1; }
+
+    // 🔹 Output taps (analyzer, recorder): the callback copies every block
+    // into each tap's ring and never waits on it. removeTap() returns only
+    // once the callback can no longer touch the tap, so it may be freed.
+    static constexpr int MaxTaps = 4;
+    bool addTap(AudioTap* tap);
+    void removeTap(AudioTap* tap);
+
+    unsigned int getSampleRate() const { return sampleRate; }
+
+    // Renders nFrames of stereo-interleaved output without a device: the
+    // same path the callback runs (the DspGraph chain). Used by
+    // the offline renderer; don't call it while the stream is running.
+    void render(float* out, unsigned int nFrames);
+
+    // 🔹 Generated phrases, played from inside render() (see Improviser.h)
+    Improviser& improviser() { return improv; }
+
+    // 🔹 Sheds quality under load (see QualityGovernor.h). On by default;
+    // poll its transitions from the UI thread to log them.
+    QualityGovernor& qualityGovernor() { return governor; }
+
+    // 🔹 Load counters, updated by render() every block (relaxed atomics).
+    // load = render time / duration of the audio it produced.
+    struct Stats {
+        uint64_t blocks = 0;
+        uint64_t xruns = 0;       // device reported under/overflow
+        uint64_t overruns = 0;    // blocks that took longer than real time
+        uint64_t busyNs = 0;      // total time spent rendering
+        uint64_t audioNs = 0;     // total audio rendered
+        float    peakLoad = 0.0f; // worst block since resetPeaks()
+        int      voices = 0;      // keys sounding after the last block
+        int      peakVoices = 0;
+        int      fingers = 0;     // improviser strokes holding a key
+        int      quality = 0;     // QualityGovernor::Level after the last block
+        uint64_t fxWaits = 0;     // pipelined: blocks that waited on the FX worker
+        uint64_t parallelChunks = 0;   // chunks whose keys rendered on several threads
+        uint64_t serialChunks = 0;     // ... and on the callback alone (voice workers on)
+    };
+    Stats stats() const;
+    void resetPeaks();
+
+    // Returns once the callback holds no key: the keys may be destroyed.
     void clearKeys() {
-        keys.clear();
+        keyList.reset();
         key = nullptr;
+        waitForCallback();
     }
 
 private:
-    RtAudio dac;
+    std::unique_ptr<RtAudio> dac;   // created by open()
     unsigned int sampleRate = 48000;
     unsigned int bufferFrames = 256;
 
     Key* key = nullptr;
-    std::vector<Key*> keys;
+    RtPtr<RtArray<Key*>> keyList;    // setKeys()
+    std::span<Key* const> keys;        // audio thread: keyList for this block
 
     // Core DSP
     daisysp::Oscillator osc;
-    daisysp::ReverbSc   reverb;
+    std::unique_ptr<Reverb> reverbOwned;   // UI side
+    std::atomic<Reverb*>    reverb{nullptr};   // what render() runs
+    int reverbId = -1;
+    bool offline = false;
     daisysp::Oscillator tremLFO;   // tremolo LFO
 
     // Wet/dry mix
@@ -64,10 +179,68 @@ private:
     float reverbDecay = 0.85f;
     float roomSize    = 0.5f;
 
+    // Signal chain, and the output bus stage
+    DspGraph graph;
+    AudioBus bus{(float)sampleRate};
+    std::unique_ptr<FxPipeline> pipeline;   // setPipelined()
+
+    // Voice workers (setVoiceThreads()): the chunk's key sum, ready for
+    // "voices", and the voice each key renders this chunk
+    std::unique_ptr<VoiceWorkers> voiceWorkers;
+    float voiceMix[VoiceWorkers::MaxFrames] = {};
+    bool  voiceMixReady = false;
+    VoiceSource* preparedVoices[VoiceWorkers::MaxKeys] = {};
+
+    // Physical-model voices, one pool per model, built by the constructor
+    std::unique_ptr<VoicePool> voicePools[PhysicalModelCount];
+
+    // Quality governor: level for the next block, and the cheap reverb
+    // LiteReverb crossfades to (0 = engine reverb only, 1 = lite only)
+    QualityGovernor governor;
+    QualityGovernor::Level quality = QualityGovernor::Full;
+    std::unique_ptr<Reverb> reverbLite;
+    float liteMix = 0.0f;
+
+    Improviser improv{(double)sampleRate};
+
+    std::atomic<uint64_t> statBlocks{0}, statXruns{0}, statOverruns{0};
+    std::atomic<uint64_t> statBusyNs{0}, statAudioNs{0};
+    std::atomic<float>    statPeakLoad{0.0f};
+    std::atomic<int>      statVoices{0}, statPeakVoices{0};
+
+    std::atomic<AudioTap*> taps[MaxTaps] = {};
+    std::atomic<unsigned> callbackSeq{0};   // odd while the callback runs
+
     // Custom harmonics
     std::vector<float> harmonicsReal;
     std::vector<float> harmonicsImag;
 
+    // Spans are rendered in chunks of up to ChunkFrames: physical-model
+    // keys render their voice for the chunk up front, then the graph runs
+    // its stages over the chunk (keys are summed per sample by "voices").
+    static constexpr unsigned int ChunkFrames = 64;
+    static_assert(ChunkFrames <= Key::VoiceBlockFrames, "a chunk must fit a key's voice block");
+    static_assert(ChunkFrames <= DspGraph::MaxFrames, "a chunk must fit the graph's buffers");
+    static_assert(ChunkFrames <= VoiceWorkers::MaxFrames, "a chunk must fit the voice workers' lanes");
+    // Frames of voices rendered so far, advanced once per chunk after its
+    // keys: the clock Key::render reads its tremolo LFO from.
+    uint64_t voiceClock = 0;
+    void renderSpan(float* out, unsigned int nFrames);
+    void renderPipelined(float* out, unsigned int nFrames);
+    void renderDrySpan(float* left, float* right, unsigned int nFrames);
+    void runEffects(float* left, float* right, unsigned int nFrames);
+    void renderKeys(unsigned int n);
+    void renderVoice(Key& k, unsigned int n);
+    VoiceSource* prepareVoice(Key& k);
+    void buildGraph();
+    void renderVoices(float* left, float* right, unsigned int n);
+    void applyTremolo(float* left, float* right, unsigned int n);
+    void applyReverb(float* left, float* right, unsigned int n);
+    void applyQuality();
+    void mixReverb(const float* dry, float* wetL, float* wetR, unsigned int n);
+    void waitForCallback();
+    void swapReverb(std::unique_ptr<Reverb> next, int id);
+
     static int audioCallback(void* outputBuffer, void* inputBuffer,
                              unsigned int nFrames, double streamTime,
                              RtAudioStreamStatus status, void* userData);
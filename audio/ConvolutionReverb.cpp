@@ -0,0 +1,335 @@
+#include "ConvolutionReverb.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include "dr_wav.h"
+
+#if AVA_HAVE_KISSFFT
+#include "kiss_fftr.h"
+#endif
+
+using namespace ava::audio;
+
+// Wet level matched to ReverbSc on AVA_ReverbBench's input, for an IR
+// normalized to unit energy.
+static constexpr float kConvGain = 0.56f;
+
+// -------------------------
+// Stage: uniformly partitioned overlap-save convolution
+// -------------------------
+// Partition size P, FFT size 2P. Every P input samples: one forward FFT into
+// the frequency-domain delay line, K complex multiply-adds per channel
+// against the IR partitions' spectra, one inverse FFT per channel.
+class ConvolutionReverb::Stage {
+public:
+    Stage(const float* irL, const float* irR, size_t len, int p, float scale)
+        : P(p), N(2 * p), K((int)((len + p - 1) / p)), bins(p + 1) {
+#if AVA_HAVE_KISSFFT
+        fwd = kiss_fftr_alloc(N, 0, nullptr, nullptr);
+        inv = kiss_fftr_alloc(N, 1, nullptr, nullptr);
+#endif
+        window.assign(N, 0.0f);
+        time.assign(N, 0.0f);
+        accL.assign(bins * 2, 0.0f);
+        accR.assign(bins * 2, 0.0f);
+        fdl.assign((size_t)K * bins * 2, 0.0f);
+        specL.assign((size_t)K * bins * 2, 0.0f);
+        specR.assign((size_t)K * bins * 2, 0.0f);
+
+        // IR partitions, zero padded to N; kiss's inverse is unnormalized
+        const float s = scale / (float)N;
+        for (int k = 0; k < K; k++) {
+            const size_t at = (size_t)k * P;
+            const size_t n = std::min<size_t>(P, len - at);
+            for (int c = 0; c < 2; c++) {
+                const float* ir = c == 0 ? irL : irR;
+                std::fill(time.begin(), time.end(), 0.0f);
+                for (size_t i = 0; i < n; i++) time[i] = ir[at + i] * s;
+                forward(time.data(), (c == 0 ? specL : specR).data() + (size_t)k * bins * 2);
+            }
+        }
+        std::fill(time.begin(), time.end(), 0.0f);
+    }
+
+    ~Stage() {
+#if AVA_HAVE_KISSFFT
+        if (fwd) kiss_fftr_free(static_cast<kiss_fftr_cfg>(fwd));
+        if (inv) kiss_fftr_free(static_cast<kiss_fftr_cfg>(inv));
+#endif
+    }
+
+    // P samples in, P samples per channel out. compute = false only moves
+    // the input into the delay line (the output would be too late to use).
+    void process(const float* x, float* yL, float* yR, bool compute = true) {
+        std::memmove(window.data(), window.data() + P, P * sizeof(float));
+        std::memcpy(window.data() + P, x, P * sizeof(float));
+        forward(window.data(), fdl.data() + (size_t)pos * bins * 2);
+
+        if (compute) {
+            std::fill(accL.begin(), accL.end(), 0.0f);
+            std::fill(accR.begin(), accR.end(), 0.0f);
+            for (int k = 0; k < K; k++) {
+                const int slot = pos - k < 0 ? pos - k + K : pos - k;
+                const float* X  = fdl.data() + (size_t)slot * bins * 2;
+                const float* HL = specL.data() + (size_t)k * bins * 2;
+                const float* HR = specR.data() + (size_t)k * bins * 2;
+                float* aL = accL.data();
+                float* aR = accR.data();
+                for (int b = 0; b < bins * 2; b += 2) {
+                    const float xr = X[b], xi = X[b + 1];
+                    aL[b]     += xr * HL[b] - xi * HL[b + 1];
+                    aL[b + 1] += xr * HL[b + 1] + xi * HL[b];
+                    aR[b]     += xr * HR[b] - xi * HR[b + 1];
+                    aR[b + 1] += xr * HR[b + 1] + xi * HR[b];
+                }
+            }
+            inverse(accL.data(), time.data());
+            std::memcpy(yL, time.data() + P, P * sizeof(float));
+            inverse(accR.data(), time.data());
+            std::memcpy(yR, time.data() + P, P * sizeof(float));
+        }
+        pos = pos + 1 == K ? 0 : pos + 1;
+    }
+
+    int partitions() const { return K; }
+
+private:
+    const int P, N, K, bins;
+    void* fwd = nullptr;
+    void* inv = nullptr;
+    std::vector<float> window;        // last N input samples
+    std::vector<float> time;
+    std::vector<float> accL, accR;    // interleaved re/im, bins pairs
+    std::vector<float> fdl;           // K input spectra, ring at `pos`
+    std::vector<float> specL, specR;  // K IR partition spectra
+    int pos = 0;
+
+    void forward(const float* in, float* out) {
+#if AVA_HAVE_KISSFFT
+        kiss_fftr(static_cast<kiss_fftr_cfg>(fwd), in, reinterpret_cast<kiss_fft_cpx*>(out));
+#else
+        std::fill(out, out + bins * 2, 0.0f);
+#endif
+    }
+    void inverse(const float* in, float* out) {
+#if AVA_HAVE_KISSFFT
+        kiss_fftri(static_cast<kiss_fftr_cfg>(inv), reinterpret_cast<const kiss_fft_cpx*>(in), out);
+#else
+        std::fill(out, out + N, 0.0f);
+#endif
+    }
+};
+
+// -------------------------
+// ConvolutionReverb
+// -------------------------
+ConvolutionReverb::ConvolutionReverb(const std::vector<float>& irL, const std::vector<float>& irR)
+    : length(irR.empty() ? irL.size() : std::min(irL.size(), irR.size())),
+      inHist(InHistory, 0.0f),
+      outHistL(OutHistory, 0.0f),
+      outHistR(OutHistory, 0.0f) {
+    const std::vector<float>& right = irR.empty() ? irL : irR;
+
+    double energy = 0.0;
+    for (size_t i = 0; i < length; i++) energy += 0.5 * (irL[i] * irL[i] + right[i] * right[i]);
+    gain = energy > 0.0 ? kConvGain / (float)std::sqrt(energy) : 0.0f;
+
+    const size_t headLen = std::min<size_t>(length, HeadLength);
+    head = std::make_unique<Stage>(irL.data(), right.data(), std::max<size_t>(1, headLen), HeadBlock, gain);
+    if (length > (size_t)HeadLength) {
+        tail = std::make_unique<Stage>(irL.data() + HeadLength, right.data() + HeadLength,
+                                       length - HeadLength, TailBlock, gain);
+        startWorker();
+    }
+}
+
+ConvolutionReverb::~ConvolutionReverb() {
+    stopWorker();
+}
+
+bool ConvolutionReverb::available() {
+#if AVA_HAVE_KISSFFT
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::unique_ptr<ConvolutionReverb> ConvolutionReverb::fromFile(const std::string& path, double sampleRate) {
+    if (!available()) {
+        std::cerr << "[Convolution] needs the FFT (AVA_ENABLE_FFT)\n";
+        return nullptr;
+    }
+    unsigned int channels = 0, rate = 0;
+    drwav_uint64 samples = 0;
+    float* data = drwav_open_and_read_file_f32(path.c_str(), &channels, &rate, &samples);
+    if (!data || channels == 0 || samples < channels) {
+        std::cerr << "[Convolution] cannot read " << path << "\n";
+        if (data) drwav_free(data);
+        return nullptr;
+    }
+
+    // first two channels, linearly resampled to the engine rate
+    const size_t frames = (size_t)(samples / channels);
+    const double step = (double)rate / sampleRate;
+    const size_t outFrames = std::max<size_t>(1, (size_t)((double)frames / step));
+    std::vector<float> irL(outFrames), irR(channels > 1 ? outFrames : 0);
+    for (size_t i = 0; i < outFrames; i++) {
+        const double at = i * step;
+        const size_t i0 = std::min(frames - 1, (size_t)at);
+        const size_t i1 = std::min(frames - 1, i0 + 1);
+        const float f = (float)(at - (double)i0);
+        irL[i] = data[i0 * channels] + (data[i1 * channels] - data[i0 * channels]) * f;
+        if (channels > 1)
+            irR[i] = data[i0 * channels + 1] + (data[i1 * channels + 1] - data[i0 * channels + 1]) * f;
+    }
+    drwav_free(data);
+
+    std::cout << "[Convolution] " << path << ": " << channels << " ch, "
+              << (double)outFrames / sampleRate << " s\n";
+    return std::make_unique<ConvolutionReverb>(irL, irR);
+}
+
+std::unique_ptr<ConvolutionReverb> ConvolutionReverb::synthetic(float seconds, float t60, double sampleRate) {
+    if (!available()) return nullptr;
+    const size_t n = (size_t)(std::max(0.1f, seconds) * sampleRate);
+    const size_t predelay = (size_t)(0.01 * sampleRate);
+    std::vector<float> irL(n, 0.0f), irR(n, 0.0f);
+    std::mt19937 rng(1234);
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    const double perSample = -3.0 * std::log(10.0) / (std::max(0.05f, t60) * sampleRate);
+    for (size_t i = predelay; i < n; i++) {
+        const float env = (float)std::exp(perSample * (double)(i - predelay));
+        irL[i] = noise(rng) * env;
+        irR[i] = noise(rng) * env;
+    }
+    return std::make_unique<ConvolutionReverb>(irL, irR);
+}
+
+void ConvolutionReverb::setOffline(bool off) {
+    if (off == offline) return;
+    offline = off;
+    if (!tail) return;
+    if (offline) stopWorker();
+    else         startWorker();
+}
+
+// --- Audio thread ---
+void ConvolutionReverb::process(const float* inL, const float* inR,
+                                float* outL, float* outR, size_t n) {
+    for (size_t i = 0; i < n;) {
+        const size_t m = std::min<size_t>(n - i, HeadBlock - headFill);
+
+        for (size_t k = 0; k < m; k++) {
+            const float x = 0.5f * (inL[i + k] + inR[i + k]);
+            headIn[headFill + k] = x;
+            if (tail) inHist[(frame + k) % InHistory] = x;
+        }
+
+        // head output of the previous block (HeadBlock latency)
+        for (size_t k = 0; k < m; k++) {
+            outL[i + k] = headOutL[headFill + k];
+            outR[i + k] = headOutR[headFill + k];
+        }
+        if (tail) readTail(outL + i, outR + i, m);
+
+        headFill += (int)m;
+        frame += m;
+        i += m;
+        if (headFill == HeadBlock) {
+            head->process(headIn, headOutL, headOutR);
+            headFill = 0;
+        }
+        if (tail) {
+            playhead.store(frame, std::memory_order_release);
+            if (offline) while (tailStep()) {}   // inline, as soon as a block is complete
+        }
+    }
+}
+
+// Adds tail output for the m frames starting at `frame`: z[k] plays at
+// frame k + HeadLength + HeadBlock. Whatever the worker has not delivered
+// yet plays as silence.
+void ConvolutionReverb::readTail(float* outL, float* outR, size_t m) {
+    const uint64_t delay = HeadLength + HeadBlock;
+    const uint64_t ready = tailReady.load(std::memory_order_acquire);
+    for (size_t k = 0; k < m; k++) {
+        if (frame + k < delay) continue;
+        const uint64_t z = frame + k - delay;
+        if (z >= ready) break;
+        outL[k] += outHistL[z % OutHistory];
+        outR[k] += outHistR[z % OutHistory];
+    }
+}
+
+// --- Tail (worker thread, or inline when offline) ---
+// Runs the next tail block if its input is complete. Input and output are
+// indexed by absolute sample, so a stalled worker loses blocks but never
+// shifts the tail against the head.
+bool ConvolutionReverb::tailStep() {
+    const uint64_t have = playhead.load(std::memory_order_acquire);
+    uint64_t start = tailNext * TailBlock;
+    if (have < start + TailBlock) return false;
+
+    // stalled for longer than the input history: the oldest input is gone
+    if (have - start > (uint64_t)InHistory) {
+        const uint64_t next = (have - InHistory) / TailBlock + 1;
+        skipTail(next - tailNext);
+        return true;
+    }
+
+    float x[TailBlock], yL[TailBlock], yR[TailBlock];
+    for (int i = 0; i < TailBlock; i++) x[i] = inHist[(start + i) % InHistory];
+    if (playhead.load(std::memory_order_acquire) - start > (uint64_t)InHistory)
+        return true;                     // overwritten while copying: skipped next call
+
+    // the whole block would play after its time: keep the delay line in step only
+    const uint64_t due = start + HeadLength + HeadBlock;
+    const bool hopeless = playhead.load(std::memory_order_acquire) >= due + TailBlock;
+    tail->process(x, yL, yR, !hopeless);
+    for (int i = 0; i < TailBlock; i++) {
+        outHistL[(start + i) % OutHistory] = hopeless ? 0.0f : yL[i];
+        outHistR[(start + i) % OutHistory] = hopeless ? 0.0f : yR[i];
+    }
+    tailNext++;
+    tailReady.store(tailNext * TailBlock, std::memory_order_release);
+    if (playhead.load(std::memory_order_relaxed) > due)
+        lateBlocks.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void ConvolutionReverb::skipTail(uint64_t blocks) {
+    float zero[TailBlock] = {}, yL[TailBlock], yR[TailBlock];
+    // after as many silent blocks as the tail has partitions, its delay line is all zeros
+    for (uint64_t b = 0; b < std::min<uint64_t>(blocks, (uint64_t)tail->partitions()); b++)
+        tail->process(zero, yL, yR, false);
+    for (uint64_t b = tailNext + (blocks > 4 ? blocks - 4 : 0); b < tailNext + blocks; b++) {
+        for (int i = 0; i < TailBlock; i++) {
+            outHistL[(b * TailBlock + i) % OutHistory] = 0.0f;
+            outHistR[(b * TailBlock + i) % OutHistory] = 0.0f;
+        }
+    }
+    lateBlocks.fetch_add(blocks, std::memory_order_relaxed);
+    tailNext += blocks;
+    tailReady.store(tailNext * TailBlock, std::memory_order_release);
+}
+
+void ConvolutionReverb::startWorker() {
+    if (running.load() || offline) return;
+    running = true;
+    worker = std::thread(&ConvolutionReverb::run, this);
+}
+
+void ConvolutionReverb::stopWorker() {
+    running = false;
+    if (worker.joinable()) worker.join();
+}
+
+void ConvolutionReverb::run() {
+    while (running.load(std::memory_order_relaxed)) {
+        if (!tailStep()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Reverb.h"
+
+namespace ava {
+namespace audio {
+
+// -------------------------
+// ConvolutionReverb
+// -------------------------
+// Impulse-response reverb with non-uniform partitions, so IRs several
+// seconds long (halls, the hammam) run at small buffer sizes:
+//
+//   head  IR[0, HeadLength)   64-sample partitions, on the audio thread
+//   tail  IR[HeadLength, …)   1024-sample partitions, on a worker thread
+//
+// Both stages are uniformly partitioned overlap-save FFT convolutions. The
+// head covers exactly the time the tail needs to arrive: a tail block can be
+// computed once its 1024 input samples are in, and its first output sample
+// is due HeadLength + HeadBlock - TailBlock samples later (22 ms at 48 kHz).
+// Handoff is by absolute sample index through two preallocated histories:
+// whatever tail output has not arrived when it is due plays as silence and
+// the block is counted in lateTailBlocks(); the audio thread never waits.
+//
+// Latency is HeadBlock samples (1.3 ms at 48 kHz). The input is the mono sum;
+// the IR's left and right channels give the two outputs. Needs the FFT
+// (AVA_ENABLE_FFT=ON, kissfft); otherwise available() is false.
+class ConvolutionReverb : public Reverb {
+public:
+    static constexpr int HeadBlock  = 64;
+    static constexpr int TailBlock  = 1024;
+    static constexpr int HeadLength = 2 * TailBlock;
+
+    // irL / irR at the engine rate (irR empty → mono IR on both sides).
+    ConvolutionReverb(const std::vector<float>& irL, const std::vector<float>& irR);
+    ~ConvolutionReverb() override;
+
+    ConvolutionReverb(const ConvolutionReverb&) = delete;
+    ConvolutionReverb& operator=(const ConvolutionReverb&) = delete;
+
+    static bool available();
+
+    // Mono or stereo WAV at any rate (resampled). nullptr on failure.
+    static std::unique_ptr<ConvolutionReverb> fromFile(const std::string& path, double sampleRate);
+    // Decorrelated, exponentially decaying noise: a stand-in hall with the
+    // given T60, used when no IR file is loaded.
+    static std::unique_ptr<ConvolutionReverb> synthetic(float seconds, float t60, double sampleRate);
+
+    void setDecay(float) override {}    // the IR is the decay
+    void setOffline(bool offline) override;
+    void process(const float* inL, const float* inR,
+                 float* outL, float* outR, size_t n) override;
+
+    size_t irLength() const { return length; }
+    uint64_t lateTailBlocks() const { return lateBlocks.load(std::memory_order_relaxed); }
+
+private:
+    class Stage;                         // one uniformly partitioned convolver
+
+    size_t length = 0;
+    float  gain = 1.0f;
+    std::unique_ptr<Stage> head, tail;   // tail is null for IRs ≤ HeadLength
+
+    // --- audio thread ---
+    float    headIn[HeadBlock] = {};
+    float    headOutL[HeadBlock] = {}, headOutR[HeadBlock] = {};
+    int      headFill = 0;
+    uint64_t frame = 0;                  // input samples processed
+
+    // --- tail handoff: histories indexed by absolute sample ---
+    static constexpr int InHistory  = 16 * TailBlock;   // how far the worker may fall behind
+    static constexpr int OutHistory = 4 * TailBlock;
+    std::vector<float> inHist;           // mono input, written by the audio thread
+    std::vector<float> outHistL, outHistR;   // tail output, written by the worker
+    std::atomic<uint64_t> playhead{0};   // input samples in inHist
+    std::atomic<uint64_t> tailReady{0};  // tail samples in outHist
+    uint64_t tailNext = 0;               // next tail block (worker, or inline offline)
+    std::atomic<uint64_t> lateBlocks{0};
+    std::atomic<bool> running{false};
+    std::thread worker;
+    bool offline = false;
+
+    void startWorker();
+    void stopWorker();
+    void run();                          // worker loop
+    bool tailStep();
+    void skipTail(uint64_t blocks);
+    void readTail(float* outL, float* outR, size_t n);
+};
+
+} // namespace audio
+} // namespace ava
@@ -0,0 +1,91 @@
+#include "DspGraph.h"
+#include <iostream>
+
+using namespace ava::audio;
+
+int DspGraph::find(const std::string& id) const {
+    for (int i = 0; i < (int)entries.size(); i++)
+        if (entries[i].id == id) return i;
+    return -1;
+}
+
+bool DspGraph::add(const std::string& id, std::unique_ptr<DspNode> node,
+                   std::vector<std::string> after) {
+    if (!node || find(id) >= 0) return false;
+    entries.push_back({ id, std::move(node), std::move(after), false });
+    if (compile()) return true;
+    entries.pop_back();   // nothing compiled references it yet
+    return false;
+}
+
+bool DspGraph::setAfter(const std::string& id, std::vector<std::string> after) {
+    const int i = find(id);
+    if (i < 0) return false;
+    std::swap(entries[i].after, after);
+    if (compile()) return true;
+    std::swap(entries[i].after, after);
+    return false;
+}
+
+bool DspGraph::setBypass(const std::string& id, bool bypass) {
+    const int i = find(id);
+    if (i < 0) return false;
+    if (entries[i].bypass == bypass) return true;   // panel setters call this every frame
+    entries[i].bypass = bypass;
+    return compile();
+}
+
+bool DspGraph::isBypassed(const std::string& id) const {
+    const int i = find(id);
+    return i >= 0 && entries[i].bypass;
+}
+
+std::string DspGraph::describe() const {
+    std::string s;
+    for (int i : order) {
+        if (!s.empty()) s += " → ";
+        s += entries[i].bypass ? "(" + entries[i].id + ")" : entries[i].id;
+    }
+    return s;
+}
+
+// Kahn's algorithm; among ready nodes the one added first runs first, so
+// a chain declared in order compiles to exactly that order.
+bool DspGraph::compile() {
+    const int n = (int)entries.size();
+    std::vector<std::vector<int>> next(n);
+    std::vector<int> pending(n, 0);
+    for (int i = 0; i < n; i++) {
+        for (const auto& dep : entries[i].after) {
+            const int d = find(dep);
+            if (d < 0) {
+                std::cerr << "DspGraph: " << entries[i].id << " runs after unknown node " << dep << "\n";
+                return false;
+            }
+            next[d].push_back(i);
+            pending[i]++;
+        }
+    }
+
+    std::vector<int> sorted;
+    std::vector<bool> done(n, false);
+    while ((int)sorted.size() < n) {
+        int pick = -1;
+        for (int i = 0; i < n && pick < 0; i++)
+            if (!done[i] && pending[i] == 0) pick = i;
+        if (pick < 0) {
+            std::cerr << "DspGraph: cycle in the node order, keeping the previous one\n";
+            return false;
+        }
+        done[pick] = true;
+        sorted.push_back(pick);
+        for (int j : next[pick]) pending[j]--;
+    }
+
+    std::vector<DspNode*> run;
+    for (int i : sorted)
+        if (!entries[i].bypass) run.push_back(entries[i].node.get());
+    order = std::move(sorted);
+    plan.reset(RtArray<DspNode*>::make(run.data(), run.size()));
+    return true;
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+#include "RtMemory.h"
+
+namespace ava {
+namespace audio {
+
+// -------------------------
+// DspNode
+// -------------------------
+// One stage of the engine's signal chain. Every node works in place on the
+// graph's stereo chunk, so a bypassed node is simply left out of the run.
+class DspNode {
+public:
+    virtual ~DspNode() = default;
+    // Audio thread: n ≤ DspGraph::MaxFrames frames of left/right.
+    virtual void process(float* left, float* right, unsigned n) = 0;
+};
+
+// A node around a callable (the engine's own stages are lambdas on it).
+template <typename F>
+class DspFnNode : public DspNode {
+public:
+    explicit DspFnNode(F fn) : fn(std::move(fn)) {}
+    void process(float* left, float* right, unsigned n) override { fn(left, right, n); }
+private:
+    F fn;
+};
+
+template <typename F>
+std::unique_ptr<DspNode> makeDspNode(F fn) {
+    return std::make_unique<DspFnNode<F>>(std::move(fn));
+}
+
+// -------------------------
+// DspGraph
+// -------------------------
+// Nodes with "runs after" edges. Every change (add, reorder, bypass)
+// recompiles a flat execution list on the UI thread: topologically sorted,
+// ties in the order nodes were added, bypassed nodes dropped. The list
+// lives in the RT arena and is swapped in with one pointer store, so the
+// callback never walks the graph itself and a disabled stage costs
+// nothing. The stereo chunk buffers are preallocated members.
+//
+// Nodes stay owned by the graph until it is destroyed: a list the callback
+// still runs can never point at a freed node.
+class DspGraph {
+public:
+    static constexpr unsigned MaxFrames = 64;
+
+    // UI thread. False (and nothing changes) for a taken or unknown id, an
+    // unknown dependency, or an order with a cycle.
+    bool add(const std::string& id, std::unique_ptr<DspNode> node,
+             std::vector<std::string> after = {});
+    bool setAfter(const std::string& id, std::vector<std::string> after);
+    bool setBypass(const std::string& id, bool bypass);
+    bool isBypassed(const std::string& id) const;
+
+    // Execution order, e.g. "voices → tremolo → (reverb) → bus", bypassed
+    // nodes in parentheses.
+    std::string describe() const;
+
+    // Audio thread: the compiled list over left()/right(), or over the
+    // caller's buffers (the FX pipeline's slots).
+    void process(unsigned n) { process(left, right, n); }
+    void process(float* l, float* r, unsigned n) {
+        if (const RtArray<DspNode*>* run = plan.get())
+            for (DspNode* node : run->span()) node->process(l, r, n);
+    }
+    float* leftBuffer()  { return left; }
+    float* rightBuffer() { return right; }
+
+private:
+    struct Entry {
+        std::string id;
+        std::unique_ptr<DspNode> node;
+        std::vector<std::string> after;
+        bool bypass = false;
+    };
+    std::vector<Entry> entries;
+    std::vector<int> order;                 // last compiled order, bypassed included
+    RtPtr<RtArray<DspNode*>> plan;          // what process() runs
+
+    alignas(64) float left[MaxFrames] = {};
+    alignas(64) float right[MaxFrames] = {};
+
+    int  find(const std::string& id) const;
+    bool compile();
+};
+
+} // namespace audio
+} // namespace ava
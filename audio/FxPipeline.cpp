@@ -0,0 +1,89 @@
+#include "FxPipeline.h"
+#include <algorithm>
+#include <iostream>
+#include "../dsp/Kernels.h"
+#include "RtCheck.h"
+#include "RtMemory.h"
+#include "RtThread.h"
+
+using namespace ava::audio;
+
+FxPipeline::FxPipeline(Fx fx) : fx(std::move(fx)) {
+    for (Slot& s : slots) {
+        s.left.assign(MaxFrames, 0.0f);
+        s.right.assign(MaxFrames, 0.0f);
+    }
+    carry.assign(2 * MaxFrames, 0.0f);
+    worker = std::thread(&FxPipeline::run, this);
+    if (!raiseToRealtime(worker))
+        std::cerr << "[Pipeline] FX worker at normal priority (no real-time scheduling permission)\n";
+}
+
+FxPipeline::~FxPipeline() {
+    running.store(false);
+    job.fetch_add(1, std::memory_order_release);
+    job.notify_one();
+    if (worker.joinable()) worker.join();
+}
+
+void FxPipeline::begin() {
+    const int prev = cur ^ 1;
+    pending = slots[prev].frames > 0;
+    if (!pending) return;           // first block: nothing rendered yet
+    jobSlot = prev;
+    job.fetch_add(1, std::memory_order_release);
+    job.notify_one();
+}
+
+void FxPipeline::finish(float* out, unsigned n) {
+    const int prev = cur ^ 1;
+
+    // wet frames left over from a longer block go out first
+    const unsigned c = std::min(carried, n);
+    std::copy(carry.begin(), carry.begin() + 2 * c, out);
+    std::copy(carry.begin() + 2 * c, carry.begin() + 2 * carried, carry.begin());
+    carried -= c;
+    unsigned m = c;
+
+    if (pending) {
+        const unsigned want = job.load(std::memory_order_relaxed);
+        // the worker is usually done or nearly: a short spin before sleeping
+        for (int spin = 0; spin < 2048 && done.load(std::memory_order_acquire) != want; spin++) {}
+        if (done.load(std::memory_order_acquire) != want) {
+            waitCount.fetch_add(1, std::memory_order_relaxed);
+            for (unsigned d; (d = done.load(std::memory_order_acquire)) != want;)
+                done.wait(d, std::memory_order_acquire);
+        }
+        const Slot& s = slots[prev];
+        const unsigned fit = std::min(s.frames, n - m);
+        ava::dsp::kernels().interleave(out + 2 * m, s.left.data(), s.right.data(), fit);
+        m += fit;
+        // the block shrank: keep the rest for the next callback
+        ava::dsp::kernels().interleave(carry.data() + 2 * carried, s.left.data() + fit,
+                                       s.right.data() + fit, s.frames - fit);
+        carried += s.frames - fit;
+    }
+    // first block, or the block grew past what is buffered: silence for the gap
+    std::fill(out + 2 * m, out + 2 * n, 0.0f);
+
+    slots[cur].frames = n;
+    cur = prev;
+}
+
+void FxPipeline::run() {
+    unsigned seen = 0;
+    for (;;) {
+        job.wait(seen, std::memory_order_acquire);
+        seen = job.load(std::memory_order_acquire);
+        if (!running.load()) break;
+
+        {
+            RtCheck::Scope rtScope;
+            enableDenormalFlush();
+            Slot& s = slots[jobSlot];
+            fx(s.left.data(), s.right.data(), s.frames);
+        }
+        done.store(seen, std::memory_order_release);
+        done.notify_one();
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace ava {
+namespace audio {
+
+// -------------------------
+// FxPipeline
+// -------------------------
+// Runs the effect stages one block behind the voices, on a worker thread
+// of their own. In the callback for block N:
+//
+//   begin()     the worker starts on block N-1's dry signal, in place
+//   ...         the callback renders block N's voices into dryLeft/Right()
+//   finish()    waits for the worker, writes block N-1's wet signal to out
+//
+// So a block costs max(voices, effects) instead of their sum, for one
+// block of extra latency. The two slots are the double buffer: the worker
+// only ever touches the one the callback finished last block. Handoff is
+// two sequence counters (futex wait/notify, no locks); the worker always
+// finishes before finish() returns, so it never runs outside the
+// callback and anything the callback may use stays safe to swap with
+// waitForCallback() and the RT arena as before. A block size change
+// keeps the wet stream continuous: a shrink carries the surplus into the
+// next callback, a growth past what is buffered pads with silence.
+//
+// The worker asks for real-time priority (RtThread.h); without permission
+// it runs at normal priority and says so once.
+class FxPipeline {
+public:
+    static constexpr unsigned MaxFrames = 4096;
+
+    // Effect stages over one slot, in place; n ≤ MaxFrames.
+    using Fx = std::function<void(float* left, float* right, unsigned n)>;
+
+    explicit FxPipeline(Fx fx);     // starts the worker
+    ~FxPipeline();                  // stops and joins it
+
+    FxPipeline(const FxPipeline&) = delete;
+    FxPipeline& operator=(const FxPipeline&) = delete;
+
+    // Audio thread, once per block of n ≤ MaxFrames frames.
+    void   begin();
+    float* dryLeft()  { return slots[cur].left.data(); }
+    float* dryRight() { return slots[cur].right.data(); }
+    void   finish(float* out, unsigned n);
+
+    // Blocks where finish() had to wait: the effects took longer than the voices.
+    uint64_t waits() const { return waitCount.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot {
+        std::vector<float> left, right;
+        unsigned frames = 0;       // dry frames rendered into it
+    };
+
+    Fx   fx;
+    Slot slots[2];
+    int  cur = 0;                  // the callback's slot this block
+    int  jobSlot = 0;              // the worker's, published by `job`
+    bool pending = false;          // a job was started this block
+
+    // Wet frames finished but not yet written, interleaved: when the block
+    // shrinks, the previous slot holds more than fits in out. Bounded by
+    // the largest block since the last gap, so MaxFrames frames suffice.
+    std::vector<float> carry;
+    unsigned carried = 0;
+
+    alignas(64) std::atomic<unsigned> job{0};    // callback → worker
+    alignas(64) std::atomic<unsigned> done{0};   // worker → callback
+    std::atomic<bool> running{true};
+    std::atomic<uint64_t> waitCount{0};
+    std::thread worker;
+
+    void run();
+};
+
+} // namespace audio
+} // namespace ava
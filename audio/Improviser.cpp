@@ -0,0 +1,295 @@
+#include "Improviser.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include "../ui/Key.h"
+
+using namespace ava::audio;
+
+Improviser::Improviser(double sr)
+    : sampleRate(sr > 0.0 ? sr : 48000.0),
+      commands(1024),   // finger moves arrive at event rate
+      marks(4096) {
+    resetPhrase();
+}
+
+// --- UI thread ---
+void Improviser::enable(uint32_t seed) {
+    Command c{};
+    c.type = Command::Enable;
+    c.seed = seed;
+    send(c);
+}
+
+void Improviser::disable() {
+    Command c{};
+    c.type = Command::Disable;
+    send(c);
+}
+
+void Improviser::setBounds(float x0, float y0, float x1, float y1, int w, int h) {
+    Command c{};
+    c.type = Command::Bounds;
+    c.x0 = x0; c.y0 = y0; c.x1 = x1; c.y1 = y1;
+    c.w = w;   c.h = h;
+    send(c);
+}
+
+void Improviser::setConcurrency(int n) {
+    Command c{};
+    c.type = Command::Concurrency;
+    c.w = n;
+    send(c);
+}
+
+void Improviser::setStyle(int ms, bool phrases) {
+    Command c{};
+    c.type = Command::Style;
+    c.w = ms;
+    c.h = phrases ? 1 : 0;
+    send(c);
+}
+
+void Improviser::touch(Key& key, int phase, int held, float intensity, float detune) {
+    Command c{};
+    c.type = Command::Touch;
+    c.key = &key;
+    c.seed = key.serial;
+    c.w = phase;
+    c.h = held;
+    c.x0 = intensity;
+    c.y0 = detune;
+    send(c);
+}
+
+void Improviser::send(const Command& c) {
+    if (commands.push(&c, 1) == 1) return;
+    // the audio thread isn't draining the ring (stream stopped or stalled)
+    if (dropped.fetch_add(1, std::memory_order_relaxed) == 0)
+        std::cerr << "[Improviser] command ring full, dropping commands\n";
+}
+
+// --- Audio thread ---
+void Improviser::apply(const Command& c, std::span<Key* const> keys) {
+    switch (c.type) {
+        case Command::Enable:
+            rng.seed(c.seed);
+            resetPhrase();
+            enabled = true;
+            pauseUntil = nextTick = nextMark = now;
+            break;
+        case Command::Disable:
+            releaseAll(keys);
+            enabled = false;
+            break;
+        case Command::Bounds:
+            minX = std::min(c.x0, c.x1); maxX = std::max(c.x0, c.x1);
+            minY = std::min(c.y0, c.y1); maxY = std::max(c.y0, c.y1);
+            winW = std::max(1, c.w);
+            winH = std::max(1, c.h);
+            break;
+        case Command::Concurrency:
+            concurrency = std::clamp(c.w, 1, MaxStrokes);
+            break;
+        case Command::Style:
+            strokeMs = std::max(20, c.w);
+            phrasing = c.h != 0;
+            break;
+        case Command::Touch:
+            // a key of a keyboard that has since been rebuilt isn't listed
+            for (Key* k : keys) {
+                if (k != c.key || k->serial != c.seed) continue;
+                k->touch((Key::TouchPhase)c.w, c.h, c.x0, c.y0);
+                break;
+            }
+            break;
+    }
+}
+
+int Improviser::run(std::span<Key* const> keys, int maxFrames) {
+    Command c;
+    while (commands.pop(&c, 1) == 1) apply(c, keys);
+
+    // keys rebuilt (mode change, relayout): their touches went with them
+    if (keys.data() != lastKeys || keys.size() != lastKeyCount) {
+        for (auto& s : strokes) {
+            if (!s.live) continue;
+            float x, y;
+            position(s, (float)(now - s.startAt) / (float)std::max<uint64_t>(1, s.endAt - s.startAt), x, y);
+            pushMark((int)(&s - strokes), Mark::Up, x, y);
+            s.live = s.down = false;
+        }
+        sounding = 0;
+        lastKeys = keys.data();
+        lastKeyCount = keys.size();
+    }
+
+    if (!enabled) {
+        fingers.store(sounding, std::memory_order_relaxed);
+        now += maxFrames;
+        return maxFrames;
+    }
+
+    // 1. strokes ending on this sample
+    for (auto& s : strokes) {
+        if (s.live && s.endAt <= now) finish(s, keys);
+    }
+
+    // 2. new strokes, unless the phrase is pausing
+    if (now >= pauseUntil) {
+        int live = 0;
+        for (auto& s : strokes) live += s.live;
+        for (auto& s : strokes) {
+            if (live >= concurrency) break;
+            if (s.live) continue;
+            spawn(s);
+            update(s, keys, true);
+            live++;
+            if (phrasing && ++strokeCount >= phraseLength) {
+                std::uniform_int_distribution<int> pauseDist(0, 1);
+                int pauseMs = (pauseDist(rng) == 0 ? 500 : 1000);
+                pauseUntil = now + (uint64_t)(pauseMs * sampleRate / 1000.0);
+                resetPhrase();
+                break;
+            }
+        }
+    }
+
+    // 3. control-rate curve update
+    if (now >= nextTick) {
+        const bool mark = now >= nextMark;
+        for (auto& s : strokes) {
+            if (s.live) update(s, keys, mark);
+        }
+        nextTick = now + ControlPeriod;
+        if (mark) nextMark = now + (uint64_t)(sampleRate / 60.0);
+    }
+
+    // render up to the next thing that has to happen on its own sample
+    uint64_t next = nextTick;
+    if (pauseUntil > now) next = std::min(next, pauseUntil);
+    for (const auto& s : strokes) {
+        if (s.live) next = std::min(next, s.endAt);
+    }
+    int n = (int)std::clamp<uint64_t>(next - now, 1, (uint64_t)maxFrames);
+    fingers.store(sounding, std::memory_order_relaxed);
+    now += n;
+    return n;
+}
+
+void Improviser::resetPhrase() {
+    std::uniform_int_distribution<int> phraseDist(3, 8);
+    phraseLength = phraseDist(rng);
+    strokeCount = 0;
+}
+
+void Improviser::spawn(Stroke& s) {
+    std::uniform_real_distribution<float> xDist(minX, maxX);
+    std::uniform_real_distribution<float> yDist(minY, maxY);
+    s.x0 = xDist(rng);
+    s.y0 = yDist(rng);
+
+    std::uniform_real_distribution<float> dxDist(-0.15f * winW, 0.15f * winW);
+    std::uniform_real_distribution<float> dyDist(-0.2f * winH, 0.2f * winH);
+    s.x1 = std::clamp(s.x0 + dxDist(rng), minX, maxX);
+    s.y1 = std::clamp(s.y0 + dyDist(rng), minY, maxY);
+
+    std::uniform_int_distribution<int> curveDist(0, 2);
+    s.curve = static_cast<Curve>(curveDist(rng));
+
+    s.startAt = now;
+    s.endAt   = now + (uint64_t)(strokeMs * sampleRate / 1000.0);
+    s.key  = -1;
+    s.down = false;
+    s.started = false;
+    s.live = true;
+}
+
+void Improviser::position(const Stroke& s, float t, float& x, float& y) const {
+    t = std::clamp(t, 0.0f, 1.0f);
+    x = s.x0 + (s.x1 - s.x0) * t;
+    switch (s.curve) {
+        case Curve::Linear:
+            y = s.y0 + (s.y1 - s.y0) * t;
+            break;
+        case Curve::Quadratic:
+            y = s.y0 + (s.y1 - s.y0) * t * t;
+            break;
+        case Curve::Exponential: {
+            const float k = 2.0f;
+            y = s.y0 + (s.y1 - s.y0) * (std::exp(k * t) - 1.0f) / (std::exp(k) - 1.0f);
+            break;
+        }
+    }
+}
+
+// Mirrors what Keyboard::handleEvent does with a finger's down/motion:
+// a stroke that lands between keys is never tracked, sliding onto another
+// key moves the note there, sliding off every key releases it.
+void Improviser::update(Stroke& s, std::span<Key* const> keys, bool mark) {
+    const float t = (float)(now - s.startAt) / (float)std::max<uint64_t>(1, s.endAt - s.startAt);
+    float x, y;
+    position(s, t, x, y);
+    const int k = keyAt(keys, x, y);
+    const int idx = (int)(&s - strokes);
+
+    if (!s.started) {
+        s.started = true;
+        if (k >= 0) {
+            keys[k]->driveOn(x, y);
+            s.key = k;
+            s.down = true;
+            sounding++;
+        }
+        pushMark(idx, Mark::Down, x, y);
+        return;
+    }
+
+    if (s.key >= 0) {
+        if (k == s.key) {
+            if (s.down) keys[k]->driveMove(x, y);
+        } else if (k >= 0) {
+            if (s.down) keys[s.key]->driveOff();
+            else sounding++;
+            keys[k]->driveOn(x, y);
+            s.key = k;
+            s.down = true;
+        } else if (s.down) {
+            keys[s.key]->driveOff();
+            s.down = false;
+            sounding--;
+        }
+    }
+    if (mark) pushMark(idx, Mark::Move, x, y);
+}
+
+void Improviser::finish(Stroke& s, std::span<Key* const> keys) {
+    if (s.down && s.key < (int)keys.size()) {
+        keys[s.key]->driveOff();
+        sounding--;
+    }
+    float x, y;
+    position(s, 1.0f, x, y);
+    pushMark((int)(&s - strokes), Mark::Up, x, y);
+    s.live = false;
+    s.down = false;
+}
+
+void Improviser::releaseAll(std::span<Key* const> keys) {
+    for (auto& s : strokes) {
+        if (s.live) finish(s, keys);
+    }
+    sounding = 0;
+}
+
+int Improviser::keyAt(std::span<Key* const> keys, float x, float y) const {
+    for (int i = 0; i < (int)keys.size(); i++) {
+        if (keys[i] && keys[i]->isInside(x, y)) return i;
+    }
+    return -1;
+}
+
+void Improviser::pushMark(int stroke, Mark::Phase phase, float x, float y) {
+    Mark m{(uint8_t)stroke, phase, x / winW, y / winH};
+    marks.push(&m, 1);
+}
@@ -0,0 +1,133 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <vector>
+#include "SpscRing.h"
+
+class Key;
+
+namespace ava {
+namespace audio {
+
+// -------------------------
+// Improviser
+// -------------------------
+// Generated phrases played straight into the keys from the audio callback,
+// instead of synthetic SDL events pushed once per video frame.
+//
+//   UI thread  ── commands (SpscRing) ──▶  run() in AudioEngine::render()
+//   UI thread  ◀── marks   (SpscRing) ───  (strokes, for drawing only)
+//
+// Real fingers take the same ring (touch(), from Key::onTouch), so every
+// key's note state is written by the audio thread alone.
+//
+// Stroke curves (linear / quadratic / exponential) are evaluated every
+// ControlPeriod samples; stroke starts and ends fall on their exact sample
+// because render() splits the block there. Phrasing follows the old
+// TouchSketchGenerator: phrases of 3-8 strokes, 0.5 or 1 s pauses.
+// Everything is preallocated; run() never locks or allocates.
+class Improviser {
+public:
+    static constexpr int MaxStrokes    = 20;
+    static constexpr int ControlPeriod = 32;    // 0.67 ms at 48 kHz
+    static constexpr int DefaultConcurrency = 2;
+    static constexpr int DefaultStrokeMs    = 2000;
+
+    enum class Curve : uint8_t { Linear, Quadratic, Exponential };
+
+    // UI feed: one mark per stroke start/end and ~60 per second while moving.
+    struct Mark {
+        enum Phase : uint8_t { Down, Move, Up };
+        uint8_t stroke;
+        Phase   phase;
+        float   x, y;           // normalized window coordinates, like tfinger
+    };
+
+    explicit Improviser(double sampleRate);
+
+    Improviser(const Improviser&) = delete;
+    Improviser& operator=(const Improviser&) = delete;
+
+    // --- UI thread ---
+    void enable(uint32_t seed);               // same seed → same phrases
+    void disable();                           // releases every generated note
+    // Stroke area and window size in pixels (the keys' coordinate space).
+    void setBounds(float x0, float y0, float x1, float y1, int winW, int winH);
+    void setConcurrency(int strokes);         // simultaneous strokes, 1..MaxStrokes
+    // Stroke length, and whether phrases pause between them (off = a new
+    // stroke the moment one ends: the densest the stress test can play).
+    void setStyle(int strokeMs, bool phrasing);
+    // A finger change on `key` (Key::touch() arguments), applied by the
+    // next run() if the key is still one the engine plays.
+    void touch(Key& key, int phase, int held, float intensity, float detune);
+    bool pollMark(Mark& m) { return marks.pop(&m, 1) == 1; }
+    // Commands lost because the ring was full (the audio thread stalled).
+    uint64_t droppedCommands() const { return dropped.load(std::memory_order_relaxed); }
+
+    // --- Audio thread ---
+    // Applies everything due at the current sample, then returns how many
+    // frames (1..maxFrames) can be rendered before the next control tick,
+    // stroke start or stroke end.
+    int run(std::span<Key* const> keys, int maxFrames);
+
+    int activeStrokes() const { return fingers.load(std::memory_order_relaxed); }
+
+private:
+    struct Command {
+        enum Type : uint8_t { Enable, Disable, Bounds, Concurrency, Style, Touch } type;
+        uint32_t seed;
+        float x0, y0, x1, y1;
+        int w, h;
+        Key* key;           // Touch (seed: its serial): only followed once found in the keys
+    };
+
+    struct Stroke {
+        bool     live = false;
+        bool     started = false;    // first update done (the "finger down")
+        float    x0, y0, x1, y1;
+        Curve    curve;
+        uint64_t startAt, endAt;     // samples
+        int      key = -1;           // key it went down on / moved to
+        bool     down = false;       // key is holding a generated touch
+    };
+
+    double sampleRate;
+    SpscRing<Command> commands;
+    SpscRing<Mark>    marks;
+    std::atomic<uint64_t> dropped{0};
+
+    // audio-thread state
+    bool enabled = false;
+    std::mt19937 rng;
+    float minX = 0, minY = 0, maxX = 1, maxY = 1;
+    int   winW = 1, winH = 1;
+    int   concurrency = DefaultConcurrency;
+    int   strokeMs = DefaultStrokeMs;
+    bool  phrasing = true;
+    uint64_t now = 0;                 // samples since construction
+    uint64_t nextTick = 0;            // next control-rate update
+    uint64_t nextMark = 0;            // next UI move mark
+    uint64_t pauseUntil = 0;
+    int   phraseLength = 0, strokeCount = 0;
+    int   sounding = 0;                 // strokes holding a key
+    std::atomic<int> fingers{0};      // `sounding`, published once per run()
+    Stroke strokes[MaxStrokes];
+    const Key* const* lastKeys = nullptr;
+    size_t lastKeyCount = 0;
+
+    void send(const Command& c);
+    void apply(const Command& c, std::span<Key* const> keys);
+    void releaseAll(std::span<Key* const> keys);
+    void spawn(Stroke& s);
+    void resetPhrase();
+    void position(const Stroke& s, float t, float& x, float& y) const;
+    void update(Stroke& s, std::span<Key* const> keys, bool mark);
+    void finish(Stroke& s, std::span<Key* const> keys);
+    int  keyAt(std::span<Key* const> keys, float x, float y) const;
+    void pushMark(int stroke, Mark::Phase phase, float x, float y);
+};
+
+} // namespace audio
+} // namespace ava
@@ -0,0 +1,223 @@
+#include "PhysicalVoice.h"
+#include <algorithm>
+#include <cmath>
+#include "PhysicalModeling/KarplusString.h"
+#include "PhysicalModeling/stringvoice.h"
+#include "PhysicalModeling/modalvoice.h"
+
+#include "Sitar.h"
+#include "Plucked.h"
+#include "StifKarp.h"
+#include "Bowed.h"
+#include "SKINImsg.h"
+
+using namespace ava::audio;
+
+namespace {
+
+// Lowest pitch the STK delay lines are sized for (the keyboard starts at 55 Hz)
+constexpr double kLowestHz = 20.0;
+
+// Output gains that bring every model near the wavetable voices' level
+// for a full-intensity note.
+constexpr float kSitarGain       = 3.4f;
+constexpr float kPluckedGain     = 1.7f;
+constexpr float kStifKarpGain    = 1.2f;
+constexpr float kBowedGain       = 2.5f;
+constexpr float kStringGain      = 1.4f;
+constexpr float kStringVoiceGain = 0.9f;
+constexpr float kModalGain       = 0.4f;
+
+// -------------------------
+// STK
+// -------------------------
+// Model::tick() is called qualified, so the per-sample call is direct and
+// inlinable; Instrmnt::tick(StkFrames&) would dispatch every sample.
+template <typename Model>
+class StkPluckedVoice : public VoiceSource {
+public:
+    explicit StkPluckedVoice(float gain) : model(kLowestHz), gain(gain) {}
+
+    void strike(float freq, float velocity) override {
+        lastFreq = freq;
+        model.noteOn(freq, std::clamp(velocity, 0.05f, 1.0f));
+    }
+    void setFrequency(float freq) override {
+        if (freq == lastFreq) return;     // setFrequency re-randomizes Sitar's delay
+        lastFreq = freq;
+        model.setFrequency(freq);
+    }
+    void release() override { model.noteOff(0.5); }
+
+    void render(float* out, size_t n) override {
+        for (size_t i = 0; i < n; i++) out[i] = (float)model.Model::tick() * gain;
+    }
+
+protected:
+    Model model;
+    float gain;
+    float lastFreq = 0.0f;
+};
+
+class StkBowedVoice : public VoiceSource {
+public:
+    StkBowedVoice() : model(kLowestHz) {
+        model.controlChange(__SK_BowPosition_, 20.0);
+        model.controlChange(__SK_ModWheel_, 10.0);   // light vibrato
+    }
+
+    void strike(float freq, float velocity) override {
+        lastFreq = freq;
+        lastPressure = -1.0f;
+        model.noteOn(freq, std::clamp(velocity, 0.2f, 1.0f));
+        setPressure(velocity);
+    }
+    void setFrequency(float freq) override {
+        if (freq == lastFreq) return;
+        lastFreq = freq;
+        model.setFrequency(freq);
+    }
+    // touch intensity leans on the bow: pressure and loudness together
+    void setPressure(float p) override {
+        if (std::abs(p - lastPressure) < 0.01f) return;
+        lastPressure = p;
+        model.controlChange(__SK_BowPressure_, 40.0 + 70.0 * p);
+        model.controlChange(__SK_AfterTouch_Cont_, 40.0 + 88.0 * p);
+    }
+    void release() override { model.noteOff(0.5); }
+
+    void render(float* out, size_t n) override {
+        for (size_t i = 0; i < n; i++) out[i] = (float)model.stk::Bowed::tick() * kBowedGain;
+    }
+
+private:
+    stk::Bowed model;
+    float lastFreq = 0.0f;
+    float lastPressure = -1.0f;
+};
+
+// -------------------------
+// DaisySP
+// -------------------------
+// daisysp::String only filters its input: excite it with one period of
+// noise, scaled by the velocity.
+class DaisyStringVoice : public VoiceSource {
+public:
+    explicit DaisyStringVoice(float sr) : sampleRate(sr) {
+        string.Init(sr);
+        string.SetBrightness(0.5f);
+        string.SetDamping(0.6f);
+        string.SetNonLinearity(0.1f);
+    }
+
+    void strike(float freq, float velocity) override {
+        setFrequency(freq);
+        string.SetDamping(0.6f);
+        burst = (int)(sampleRate / std::max(freq, 20.0f));
+        burstLevel = velocity;
+    }
+    void setFrequency(float freq) override { string.SetFreq(freq); }
+    void release() override { string.SetDamping(0.2f); }
+
+    void render(float* out, size_t n) override {
+        for (size_t i = 0; i < n; i++) {
+            float x = 0.0f;
+            if (burst > 0) {
+                burst--;
+                seed = seed * 1664525u + 1013904223u;
+                x = burstLevel * ((float)(seed >> 8) * (2.0f / 16777216.0f) - 1.0f);
+            }
+            out[i] = string.Process(x) * kStringGain;
+        }
+    }
+
+private:
+    daisysp::String string;
+    float    sampleRate;
+    int      burst = 0;
+    float    burstLevel = 0.0f;
+    uint32_t seed = 22222u;
+};
+
+// StringVoice / ModalVoice: Trig() + accent; damping is how long they ring
+template <typename Model>
+class DaisyTriggeredVoice : public VoiceSource {
+public:
+    DaisyTriggeredVoice(float sr, float structure, float brightness, float damping, float gain)
+        : damping(damping), gain(gain) {
+        model.Init(sr);
+        model.SetSustain(false);
+        model.SetStructure(structure);
+        model.SetBrightness(brightness);
+        model.SetDamping(damping);
+    }
+
+    void strike(float freq, float velocity) override {
+        model.SetFreq(freq);
+        model.SetAccent(velocity);
+        model.SetDamping(damping);
+        model.Trig();
+    }
+    void setFrequency(float freq) override { model.SetFreq(freq); }
+    void release() override { model.SetDamping(0.0f); }
+
+    void render(float* out, size_t n) override {
+        for (size_t i = 0; i < n; i++) out[i] = model.Process() * gain;
+    }
+
+private:
+    Model model;
+    float damping;
+    float gain;
+};
+
+} // namespace
+
+std::unique_ptr<VoiceSource> ava::audio::makeVoice(PhysicalModel model, double sampleRate) {
+    stk::Stk::setSampleRate(sampleRate);
+    const float sr = (float)sampleRate;
+    switch (model) {
+        case ModelSitar:       return std::make_unique<StkPluckedVoice<stk::Sitar>>(kSitarGain);
+        case ModelPlucked:     return std::make_unique<StkPluckedVoice<stk::Plucked>>(kPluckedGain);
+        case ModelStifKarp:    return std::make_unique<StkPluckedVoice<stk::StifKarp>>(kStifKarpGain);
+        case ModelBowed:       return std::make_unique<StkBowedVoice>();
+        case ModelString:      return std::make_unique<DaisyStringVoice>(sr);
+        case ModelStringVoice: return std::make_unique<DaisyTriggeredVoice<daisysp::StringVoice>>(
+                                   sr, 0.15f, 0.45f, 0.75f, kStringVoiceGain);   // curved bridge buzz
+        case ModelModalVoice:  return std::make_unique<DaisyTriggeredVoice<daisysp::ModalVoice>>(
+                                   sr, 0.3f, 0.5f, 0.6f, kModalGain);
+        default:               return nullptr;
+    }
+}
+
+// -------------------------
+// VoicePool
+// -------------------------
+VoicePool::VoicePool(PhysicalModel model, double sampleRate) : kind(model) {
+    for (auto& s : slots) s.voice = makeVoice(model, sampleRate);
+}
+
+VoicePool::~VoicePool() = default;
+
+int VoicePool::acquire() {
+    int pick = 0;
+    for (int i = 0; i < Voices; i++) {
+        if (slots[i].acquiredAt == 0) { pick = i; break; }
+        if (slots[i].acquiredAt < slots[pick].acquiredAt) pick = i;   // held longest
+    }
+    slots[pick].generation++;
+    slots[pick].acquiredAt = ++acquires;
+    return pick;
+}
+
+void VoicePool::release(int slot) {
+    if (slot < 0 || slot >= Voices) return;
+    slots[slot].acquiredAt = 0;
+    slots[slot].generation++;
+}
+
+int VoicePool::inUse() const {
+    int n = 0;
+    for (const auto& s : slots) n += (s.acquiredAt != 0);
+    return n;
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace ava {
+namespace audio {
+
+// -------------------------
+// Physical-model voices
+// -------------------------
+// String and bowed models vendored in the tree (STK, DaisySP) as a Key
+// source. A voice renders a whole block per call: one virtual call per key
+// per engine chunk, and the model's own per-sample tick is called
+// non-virtually inside it. Voices come from a VoicePool built up front, so
+// nothing is allocated once the callback runs. STK models tick in double
+// (StkFloat) and size their delay lines from Stk::sampleRate(), which
+// makeVoice() sets before constructing one.
+enum PhysicalModel : int {
+    ModelSitar,          // stk::Sitar: jittered plucked string → tar
+    ModelPlucked,        // stk::Plucked: plain Karplus-Strong
+    ModelStifKarp,       // stk::StifKarp: stiff string, struck → santur
+    ModelBowed,          // stk::Bowed: bowed string, sustains while held → kamancheh
+    ModelString,         // daisysp::String: Karplus-Strong with dispersion
+    ModelStringVoice,    // daisysp::StringVoice: excited string, curved bridge → setar
+    ModelModalVoice,     // daisysp::ModalVoice: modal resonator, struck
+    PhysicalModelCount
+};
+
+struct PhysicalModelInfo {
+    const char* name;    // waveform selector label
+    bool        bowed;   // sounds only while held (touch = bow pressure)
+    float       costUs;  // µs of CPU per second of one sounding voice, 48 kHz
+};
+
+// Costs from AVA_VoiceBench --source NAME (app/VoiceBench.cpp). The two
+// Plaits-derived DaisySP voices recompute their filters every sample.
+inline constexpr PhysicalModelInfo physicalModels[PhysicalModelCount] = {
+    { "Tar",       false,  1330.0f },
+    { "Pluck",     false,   410.0f },
+    { "Santur",    false,  1440.0f },
+    { "Kamancheh", true,   2840.0f },
+    { "String",    false,  3790.0f },
+    { "Setar",     false, 41800.0f },
+    { "Modal",     false, 38600.0f },
+};
+
+// One voice of a model. Audio thread only, after construction.
+class VoiceSource {
+public:
+    virtual ~VoiceSource() = default;
+
+    // Pluck / strike / start bowing at `velocity` (0..1, the touch intensity).
+    virtual void strike(float freq, float velocity) = 0;
+    // Held note: pitch (detune) and touch intensity, once per block.
+    virtual void setFrequency(float freq) = 0;
+    virtual void setPressure(float) {}
+    // Finger lifted: damp the string / lift the bow.
+    virtual void release() = 0;
+
+    virtual void render(float* out, size_t n) = 0;
+};
+
+// -------------------------
+// VoicePool
+// -------------------------
+// Voices of one model, allocated by the constructor (UI thread). acquire()
+// and release() run on the audio thread only and never allocate: with every
+// voice taken, acquire() steals the one held longest. A holder keeps the
+// slot's generation and checks owns() to learn it was stolen.
+class VoicePool {
+public:
+    static constexpr int Voices = 16;
+
+    VoicePool(PhysicalModel model, double sampleRate);
+    ~VoicePool();
+
+    PhysicalModel model() const { return kind; }
+
+    int  acquire();
+    void release(int slot);
+    bool owns(int slot, uint32_t generation) const {
+        return slot >= 0 && slot < Voices && slots[slot].generation == generation;
+    }
+    uint32_t generation(int slot) const { return slots[slot].generation; }
+    VoiceSource& voice(int slot) { return *slots[slot].voice; }
+
+    int inUse() const;
+
+private:
+    struct Slot {
+        std::unique_ptr<VoiceSource> voice;
+        uint32_t generation = 0;
+        uint64_t acquiredAt = 0;   // acquire() count when taken; 0 = free
+    };
+    PhysicalModel kind;
+    Slot slots[Voices];
+    uint64_t acquires = 0;
+};
+
+// nullptr for an unknown model.
+std::unique_ptr<VoiceSource> makeVoice(PhysicalModel model, double sampleRate);
+
+} // namespace audio
+} // namespace ava
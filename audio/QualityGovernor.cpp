@@ -0,0 +1,66 @@
+#include "QualityGovernor.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+using namespace ava::audio;
+
+const char* QualityGovernor::levelName(Level l) {
+    switch (l) {
+        case Full:         return "Full";
+        case ShortRelease: return "ShortRelease";
+        case LowHarmonics: return "LowHarmonics";
+        case NoDetune:     return "NoDetune";
+        case LiteReverb:   return "LiteReverb";
+        case CapPolyphony: return "CapPolyphony";
+        default:           return "?";
+    }
+}
+
+QualityGovernor::Level QualityGovernor::update(float load, unsigned nFrames,
+                                               double sampleRate, int voices) {
+    const double dt = (double)nFrames / sampleRate;
+    clock += dt;
+
+    const float a = 1.0f - (float)std::exp(-dt * 1000.0 / cfg.smoothMs);
+    ema += a * (load - ema);
+    if (ema >= cfg.low) calmSince = clock;
+
+    const Level l = current.load(std::memory_order_relaxed);
+    if (!enabled.load(std::memory_order_relaxed)) {
+        if (l != Full) moveTo(Full, voices);
+        return Full;
+    }
+
+    // one slow block can be preemption; two in a row are load
+    panicBlocks = load >= cfg.panic ? panicBlocks + 1 : 0;
+    const bool hot = ema >= cfg.high || panicBlocks >= 2;
+    if (hot && l + 1 < LevelCount && (clock - lastChange) * 1000.0 >= cfg.downHoldMs) {
+        if (l + 1 == CapPolyphony) cap = std::max(MinVoices, voices * 3 / 4);
+        moveTo((Level)(l + 1), voices);
+    } else if (l > Full && (clock - calmSince) * 1000.0 >= cfg.upHoldMs
+               && (clock - lastChange) * 1000.0 >= cfg.upHoldMs) {
+        moveTo((Level)(l - 1), voices);
+    }
+    return current.load(std::memory_order_relaxed);
+}
+
+void QualityGovernor::moveTo(Level to, int voices) {
+    Transition t;
+    t.seconds = clock;
+    t.from = current.load(std::memory_order_relaxed);
+    t.to = to;
+    t.load = ema;
+    t.voices = voices;
+    current.store(to, std::memory_order_relaxed);
+    lastChange = clock;
+    transitions.push(&t, 1);   // dropped (and counted) if nobody polls
+}
+
+void QualityGovernor::print(std::ostream& os, const Transition& t) {
+    char line[160];
+    std::snprintf(line, sizeof line, "[Quality] %.1f s  %s → %s  (load %.0f%%, %d voices)\n",
+                  t.seconds, levelName((Level)t.from), levelName((Level)t.to),
+                  t.load * 100.0f, t.voices);
+    os << line;
+}
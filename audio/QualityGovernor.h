@@ -0,0 +1,96 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include "SpscRing.h"
+
+namespace ava {
+namespace audio {
+
+// -------------------------
+// QualityGovernor
+// -------------------------
+// Watches the callback's measured load (render time / audio time) and gives
+// up quality one step at a time before the deadline is missed, in this order:
+//
+//   ShortRelease   release tails ~0.1 s instead of ~0.4 s (fewer voices linger)
+//   LowHarmonics   morph keys read one layer, additive keys ≤ 8 partials
+//   NoDetune       one oscillator per key, no detuned double
+//   LiteReverb     the engine's reverb crossfades to STK PRCRev
+//   CapPolyphony   voices over the cap are released, quietest first
+//
+// Steps down when the smoothed load passes `high` (or two blocks in a row
+// pass `panic`), at most once per downHoldMs so each step can show its effect.
+// Steps back up one level after the smoothed load stayed under `low` for
+// upHoldMs. update() runs on the audio thread, once per block; every
+// transition is queued for the UI thread to log (pollTransition).
+class QualityGovernor {
+public:
+    enum Level : uint8_t {
+        Full, ShortRelease, LowHarmonics, NoDetune, LiteReverb, CapPolyphony,
+        LevelCount
+    };
+
+    struct Config {
+        float  high = 0.75f;        // smoothed load that starts shedding
+        float  panic = 0.90f;       // two blocks in a row this slow shed at once
+        float  low = 0.45f;         // smoothed load that may restore
+        double smoothMs = 100.0;    // load smoothing time constant
+        double downHoldMs = 100.0;
+        double upHoldMs = 3000.0;
+    };
+
+    struct Transition {
+        double  seconds = 0.0;      // audio time of the change
+        uint8_t from = Full, to = Full;
+        float   load = 0.0f;        // smoothed load when it happened
+        int     voices = 0;
+    };
+
+    QualityGovernor() = default;
+    explicit QualityGovernor(Config cfg) : cfg(cfg) {}
+
+    static const char* levelName(Level l);
+
+    // Audio thread: one block of nFrames at sampleRate took `load` of its
+    // budget with `voices` sounding. Returns the level to render the next
+    // block at.
+    Level update(float load, unsigned nFrames, double sampleRate, int voices);
+
+    Level level() const { return current.load(std::memory_order_relaxed); }
+    float smoothedLoad() const { return ema; }   // audio thread
+
+    // Polyphony cap while at CapPolyphony: 3/4 of the voices sounding when
+    // it was reached, at least MinVoices.
+    static constexpr int MinVoices = 4;
+    int voiceCap() const { return cap; }
+
+    // Off: stays at (or returns to) Full. Call from the UI thread.
+    void setEnabled(bool on) { enabled.store(on, std::memory_order_relaxed); }
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    // UI thread: the next logged transition, if any.
+    bool pollTransition(Transition& t) { return transitions.pop(&t, 1) == 1; }
+    // "[Quality] 12.3 s  Full → ShortRelease  (load 81%, 24 voices)"
+    static void print(std::ostream& os, const Transition& t);
+
+private:
+    Config cfg;
+    std::atomic<Level> current{Full};
+    std::atomic<bool>  enabled{true};
+
+    // audio thread
+    double clock = 0.0;             // seconds of audio seen
+    double lastChange = -1e9;
+    double calmSince = 0.0;         // smoothed load under `low` since
+    float  ema = 0.0f;
+    int    panicBlocks = 0;
+    int    cap = 0;
+
+    SpscRing<Transition> transitions{64};
+
+    void moveTo(Level to, int voices);
+};
+
+} // namespace audio
+} // namespace ava
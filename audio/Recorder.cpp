@@ -0,0 +1,198 @@
+#include "Recorder.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <iostream>
+#include "dr_wav.h"
+
+using namespace ava::audio;
+namespace fs = std::filesystem;
+
+static size_t ringFramesFor(unsigned sampleRate, double seconds) {
+    return (size_t)std::max(1.0, std::ceil(sampleRate * seconds));
+}
+
+Recorder::Recorder(unsigned sr) : Recorder(sr, Config{}) {}
+
+Recorder::Recorder(unsigned sr, Config c)
+    : cfg(std::move(c)), sampleRate(sr ? sr : 48000),
+      input(ringFramesFor(sampleRate, cfg.bufferSeconds)) {
+    input.enabled = false;                 // callback skips it until start()
+    chunk.resize(8192);                    // 4096 stereo frames per write
+    packed.resize(chunk.size() * 4);       // worst case: float32
+}
+
+Recorder::~Recorder() {
+    stop();
+}
+
+int Recorder::bitsPerSample() const {
+    switch (cfg.format) {
+        case Format::Float32: return 32;
+        case Format::Pcm16:   return 16;
+        default:              return 24;
+    }
+}
+
+double Recorder::secondsWritten() const {
+    return (double)framesWritten.load() / sampleRate;
+}
+
+size_t Recorder::droppedFrames() const {
+    return (input.ring.droppedCount() - droppedAtStart) / 2;
+}
+
+std::string Recorder::currentPath() const {
+    std::lock_guard<std::mutex> lock(pathMtx);
+    return path;
+}
+
+bool Recorder::start(const std::string& requested) {
+    if (recording.load()) return true;
+    if (writer.joinable()) writer.join();
+
+    std::string file = requested;
+    if (file.empty()) {
+        char stamp[32];
+        std::time_t now = std::time(nullptr);
+        std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", std::localtime(&now));
+        file = (fs::path(cfg.directory) / ("ava-" + std::string(stamp) + ".wav")).string();
+    }
+    std::error_code ec;
+    fs::path parent = fs::path(file).parent_path();
+    if (!parent.empty()) fs::create_directories(parent, ec);
+
+    {
+        std::lock_guard<std::mutex> lock(pathMtx);
+        basePath = file;
+    }
+    part = 1;
+    if (!openFile(file)) return false;
+
+    // discard anything left from a previous take (no consumer is running)
+    while (input.ring.pop(chunk.data(), chunk.size()) > 0) {}
+    droppedAtStart = input.ring.droppedCount();
+    framesWritten = 0;
+
+    stopRequested = false;
+    failed = false;
+    recording = true;
+    input.enabled = true;
+    writer = std::thread(&Recorder::run, this);
+
+    std::cout << "[Recorder] recording to " << file << " (" << sampleRate << " Hz, "
+              << bitsPerSample() << "-bit)\n";
+    return true;
+}
+
+void Recorder::stop() {
+    if (!recording.load()) {
+        if (writer.joinable()) writer.join();
+        return;
+    }
+    input.disable();        // waits out a block the callback is still pushing
+    stopRequested = true;   // so the writer's last pop sees all of it
+    if (writer.joinable()) writer.join();
+    recording = false;
+
+    std::cout << "[Recorder] stopped: " << secondsWritten() << " s";
+    if (size_t d = droppedFrames()) std::cout << ", " << d << " frames dropped";
+    std::cout << "\n";
+}
+
+void Recorder::run() {
+    for (;;) {
+        size_t n = input.ring.pop(chunk.data(), chunk.size());
+        if (n == 0) {
+            if (stopRequested.load()) break;      // drained after the last push
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            continue;
+        }
+        if (writeFrames(chunk.data(), n / 2) == 0) {
+            std::cerr << "[Recorder] write failed after " << secondsWritten()
+                      << " s, recording stopped (" << currentPath() << ")\n";
+            input.disable();
+            failed = true;
+            recording = false;
+            break;
+        }
+    }
+    closeFile();
+}
+
+bool Recorder::openFile(const std::string& file) {
+    drwav_data_format fmt;
+    fmt.container = drwav_container_riff;
+    fmt.format = (cfg.format == Format::Float32) ? DR_WAVE_FORMAT_IEEE_FLOAT : DR_WAVE_FORMAT_PCM;
+    fmt.channels = 2;
+    fmt.sampleRate = sampleRate;
+    fmt.bitsPerSample = bitsPerSample();
+
+    drwav* w = drwav_open_file_write(file.c_str(), &fmt);
+    if (!w) {
+        std::cerr << "[Recorder] cannot open " << file << "\n";
+        return false;
+    }
+    wav = w;
+    fileBytes = 0;
+    std::lock_guard<std::mutex> lock(pathMtx);
+    path = file;
+    return true;
+}
+
+void Recorder::closeFile() {
+    if (wav) drwav_close(static_cast<drwav*>(wav));   // patches the RIFF sizes
+    wav = nullptr;
+}
+
+size_t Recorder::writeFrames(const float* in, size_t frames) {
+    const size_t samples = frames * 2;
+    const size_t bytesPer = bitsPerSample() / 8;
+    const size_t bytes = samples * bytesPer;
+
+    if (fileBytes + bytes > cfg.maxFileBytes) {
+        closeFile();
+        std::string base;
+        {
+            std::lock_guard<std::mutex> lock(pathMtx);
+            base = basePath;
+        }
+        fs::path p(base);
+        std::string next = (p.parent_path() / (p.stem().string() + "_" + std::to_string(++part)
+                                               + p.extension().string())).string();
+        if (!openFile(next)) return 0;
+        std::cout << "[Recorder] continuing in " << next << "\n";
+    }
+
+    uint8_t* out = packed.data();
+    switch (cfg.format) {
+        case Format::Float32:
+            std::memcpy(out, in, bytes);
+            break;
+        case Format::Pcm16:
+            for (size_t i = 0; i < samples; i++) {
+                float x = std::clamp(in[i], -1.0f, 1.0f);
+                int16_t v = (int16_t)std::lrintf(x * 32767.0f);
+                out[2*i]   = (uint8_t)(v & 0xFF);
+                out[2*i+1] = (uint8_t)((v >> 8) & 0xFF);
+            }
+            break;
+        case Format::Pcm24:
+            for (size_t i = 0; i < samples; i++) {
+                float x = std::clamp(in[i], -1.0f, 1.0f);
+                int32_t v = (int32_t)std::lrintf(x * 8388607.0f);
+                out[3*i]   = (uint8_t)(v & 0xFF);
+                out[3*i+1] = (uint8_t)((v >> 8) & 0xFF);
+                out[3*i+2] = (uint8_t)((v >> 16) & 0xFF);
+            }
+            break;
+    }
+
+    drwav_uint64 written = drwav_write(static_cast<drwav*>(wav), samples, out);
+    fileBytes += (uint64_t)written * bytesPer;
+    framesWritten += written / 2;
+    return (size_t)(written / 2);
+}
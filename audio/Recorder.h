@@ -0,0 +1,87 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SpscRing.h"
+
+namespace ava {
+namespace audio {
+
+// -------------------------
+// Recorder
+// -------------------------
+// Streams the engine output to WAV while playing:
+//   callback → AudioTap (preallocated wait-free ring, no I/O, no allocation)
+//            → writer thread → dr_wav file
+//
+// Memory is fixed at construction (ring + one conversion buffer), so a
+// recording can run for hours. Files roll over to "<name>_2.wav", ... before
+// the 4 GB RIFF limit (~2 h of 96 kHz stereo 24-bit per file).
+class Recorder {
+public:
+    enum class Format { Float32, Pcm24, Pcm16 };
+
+    struct Config {
+        std::string directory = "recordings";
+        Format format = Format::Pcm24;
+        double bufferSeconds = 4.0;                 // writer may stall this long before drops
+        uint64_t maxFileBytes = 3800ull << 20;      // stay under the RIFF 4 GB limit
+    };
+
+    // sampleRate is the engine's; ring size is fixed for it here.
+    explicit Recorder(unsigned sampleRate);
+    Recorder(unsigned sampleRate, Config cfg);
+    ~Recorder();
+
+    Recorder(const Recorder&) = delete;
+    Recorder& operator=(const Recorder&) = delete;
+
+    // Register with AudioEngine::addTap() once; it only fills while recording.
+    AudioTap& tap() { return input; }
+
+    // path = "" → <directory>/ava-YYYYmmdd-HHMMSS.wav
+    bool start(const std::string& path = "");
+    void stop();   // drains what is queued, then finalizes the file
+
+    // False again on its own when a write fails: the writer closes the
+    // file and writeFailed() says so. stop() still joins the writer.
+    bool isRecording() const { return recording.load(); }
+    bool writeFailed() const { return failed.load(); }
+    double secondsWritten() const;
+    size_t droppedFrames() const;     // frames lost because the disk fell behind
+    std::string currentPath() const;
+
+private:
+    Config cfg;
+    unsigned sampleRate;
+    AudioTap input;
+
+    std::thread writer;
+    std::atomic<bool> recording{false};
+    std::atomic<bool> stopRequested{false};
+    std::atomic<bool> failed{false};
+    std::atomic<uint64_t> framesWritten{0};
+    size_t droppedAtStart = 0;
+
+    mutable std::mutex pathMtx;
+    std::string basePath, path;
+
+    // writer-only
+    std::vector<float> chunk;
+    std::vector<uint8_t> packed;
+    void* wav = nullptr;     // drwav*
+    uint64_t fileBytes = 0;
+    int part = 1;
+
+    void run();
+    bool openFile(const std::string& file);
+    void closeFile();
+    size_t writeFrames(const float* interleaved, size_t frames);
+    int bitsPerSample() const;
+};
+
+} // namespace audio
+} // namespace ava
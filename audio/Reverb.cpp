@@ -0,0 +1,224 @@
+#include "Reverb.h"
+#include <algorithm>
+#include <cmath>
+#include "Effects/reverbsc.h"
+#include "ConvolutionReverb.h"
+
+extern "C" {
+#include "soundpipe.h"
+}
+
+#include "FreeVerb.h"
+#include "JCRev.h"
+#include "NRev.h"
+#include "PRCRev.h"
+
+using namespace ava::audio;
+
+namespace {
+
+// Wet gains that bring every engine to roughly ReverbSc's level on the same
+// input (AVA_ReverbBench prints the wet RMS of each).
+constexpr float kSoundpipeScGain   = 1.0f;
+constexpr float kSoundpipeJcGain   = 2.0f;
+constexpr float kSoundpipeZitaGain = 1.4f;
+constexpr float kFreeVerbGain      = 0.4f;
+constexpr float kStkJcGain         = 0.11f;
+constexpr float kStkNGain          = 0.3f;
+constexpr float kStkPrcGain        = 0.24f;
+
+// -------------------------
+// DaisySP
+// -------------------------
+class DaisyScReverb : public Reverb {
+public:
+    explicit DaisyScReverb(float sr) {
+        rev.Init(sr);
+        rev.SetLpFreq(8000.0f);
+    }
+    void setDecay(float fb) override { rev.SetFeedback(fb); }
+    void process(const float* inL, const float* inR,
+                 float* outL, float* outR, size_t n) override {
+        rev.ProcessBlock(inL, inR, outL, outR, n);
+    }
+
+private:
+    daisysp::ReverbSc rev;
+};
+
+// -------------------------
+// Soundpipe (per-sample compute; SPFLOAT is float)
+// -------------------------
+class SoundpipeReverb : public Reverb {
+public:
+    explicit SoundpipeReverb(int sr) {
+        sp_create(&sp);
+        sp->sr = sr;
+    }
+    ~SoundpipeReverb() override { sp_destroy(&sp); }
+
+protected:
+    sp_data* sp = nullptr;
+};
+
+class SoundpipeScReverb : public SoundpipeReverb {
+public:
+    explicit SoundpipeScReverb(int sr) : SoundpipeReverb(sr) {
+        sp_revsc_create(&rev);
+        sp_revsc_init(sp, rev);
+        rev->lpfreq = 8000.0f;
+    }
+    ~SoundpipeScReverb() override { sp_revsc_destroy(&rev); }
+
+    void setDecay(float fb) override { rev->feedback = fb; }
+    void process(const float* inL, const float* inR,
+                 float* outL, float* outR, size_t n) override {
+        for (size_t i = 0; i < n; i++) {
+            SPFLOAT l = inL[i], r = inR[i], ol, or_;
+            sp_revsc_compute(sp, rev, &l, &r, &ol, &or_);
+            outL[i] = ol * kSoundpipeScGain;
+            outR[i] = or_ * kSoundpipeScGain;
+        }
+    }
+
+private:
+    sp_revsc* rev = nullptr;
+};
+
+class SoundpipeJcReverb : public SoundpipeReverb {
+public:
+    explicit SoundpipeJcReverb(int sr) : SoundpipeReverb(sr) {
+        sp_jcrev_create(&rev);
+        sp_jcrev_init(sp, rev);
+    }
+    ~SoundpipeJcReverb() override { sp_jcrev_destroy(&rev); }
+
+    void setDecay(float) override {}    // the Faust jcrev has no controls
+    void process(const float* inL, const float* inR,
+                 float* outL, float* outR, size_t n) override {
+        for (size_t i = 0; i < n; i++) {
+            SPFLOAT in = 0.5f * (inL[i] + inR[i]), out;
+            sp_jcrev_compute(sp, rev, &in, &out);
+            outL[i] = outR[i] = out * kSoundpipeJcGain;
+        }
+    }
+
+private:
+    sp_jcrev* rev = nullptr;
+};
+
+class SoundpipeZitaReverb : public SoundpipeReverb {
+public:
+    explicit SoundpipeZitaReverb(int sr) : SoundpipeReverb(sr) {
+        sp_zitarev_create(&rev);
+        sp_zitarev_init(sp, rev);
+        *rev->mix = 1.0f;      // wet only, the engine mixes
+        *rev->level = 0.0f;    // dB
+    }
+    ~SoundpipeZitaReverb() override { sp_zitarev_destroy(&rev); }
+
+    void setDecay(float fb) override {
+        const float t60 = std::clamp(t60FromFeedback(fb), 1.0f, 8.0f);   // zitarev's range
+        *rev->rt60_mid = t60;
+        *rev->rt60_low = std::min(8.0f, t60 * 1.5f);
+    }
+    void process(const float* inL, const float* inR,
+                 float* outL, float* outR, size_t n) override {
+        for (size_t i = 0; i < n; i++) {
+            SPFLOAT l = inL[i], r = inR[i], ol, or_;
+            sp_zitarev_compute(sp, rev, &l, &r, &ol, &or_);
+            outL[i] = ol * kSoundpipeZitaGain;
+            outR[i] = or_ * kSoundpipeZitaGain;
+        }
+    }
+
+private:
+    sp_zitarev* rev = nullptr;
+};
+
+// -------------------------
+// STK (StkFloat is double; Stk::sampleRate() is set before construction)
+// -------------------------
+class StkFreeVerbReverb : public Reverb {
+public:
+    StkFreeVerbReverb() {
+        rev.setEffectMix(1.0);
+        rev.setDamping(0.4);
+    }
+    // FreeVerb's room size spans comb feedback 0.7..0.98
+    void setDecay(float fb) override {
+        rev.setRoomSize(std::clamp((fb - 0.7f) / 0.28f, 0.0f, 1.0f));
+    }
+    void process(const float* inL, const float* inR,
+                 float* outL, float* outR, size_t n) override {
+        for (size_t i = 0; i < n; i++) {
+            rev.tick(inL[i], inR[i]);
+            outL[i] = (float)rev.lastOut(0) * kFreeVerbGain;
+            outR[i] = (float)rev.lastOut(1) * kFreeVerbGain;
+        }
+    }
+
+private:
+    stk::FreeVerb rev;
+};
+
+// JCRev, NRev and PRCRev share the mono-in / stereo-out T60 interface.
+template <typename Rev>
+class StkT60Reverb : public Reverb {
+public:
+    explicit StkT60Reverb(float gain) : gain(gain) { rev.setEffectMix(1.0); }
+
+    void setDecay(float fb) override {
+        const float t60 = t60FromFeedback(fb);
+        if (t60 != lastT60) {                 // setT60 recomputes every comb
+            lastT60 = t60;
+            rev.setT60(std::max(0.05f, t60));
+        }
+    }
+    void process(const float* inL, const float* inR,
+                 float* outL, float* outR, size_t n) override {
+        for (size_t i = 0; i < n; i++) {
+            rev.tick(0.5 * (inL[i] + inR[i]));
+            outL[i] = (float)rev.lastOut(0) * gain;
+            outR[i] = (float)rev.lastOut(1) * gain;
+        }
+    }
+
+private:
+    Rev   rev;
+    float gain;
+    float lastT60 = -1.0f;
+};
+
+} // namespace
+
+float ava::audio::t60FromFeedback(float feedback) {
+    // -60 dB after n passes of the ~65 ms mean ReverbSc loop: n = -3 / log10(fb)
+    const float fb = std::clamp(feedback, 0.001f, 0.999f);
+    return std::min(30.0f, -3.0f * 0.065f / std::log10(fb));
+}
+
+int ava::audio::reverbForTier(ReverbTier t) {
+    switch (t) {
+        case ReverbTier::Low:    return ReverbStkPrc;
+        case ReverbTier::High:   return ReverbSoundpipeZita;
+        case ReverbTier::Medium:
+        default:                 return ReverbDaisySc;
+    }
+}
+
+std::unique_ptr<Reverb> ava::audio::makeReverb(int id, double sampleRate) {
+    stk::Stk::setSampleRate(sampleRate);
+    switch (id) {
+        case ReverbDaisySc:       return std::make_unique<DaisyScReverb>((float)sampleRate);
+        case ReverbSoundpipeSc:   return std::make_unique<SoundpipeScReverb>((int)sampleRate);
+        case ReverbSoundpipeJc:   return std::make_unique<SoundpipeJcReverb>((int)sampleRate);
+        case ReverbSoundpipeZita: return std::make_unique<SoundpipeZitaReverb>((int)sampleRate);
+        case ReverbStkFreeVerb:   return std::make_unique<StkFreeVerbReverb>();
+        case ReverbStkJc:         return std::make_unique<StkT60Reverb<stk::JCRev>>(kStkJcGain);
+        case ReverbStkN:          return std::make_unique<StkT60Reverb<stk::NRev>>(kStkNGain);
+        case ReverbStkPrc:        return std::make_unique<StkT60Reverb<stk::PRCRev>>(kStkPrcGain);
+        case ReverbConvolution:   return ConvolutionReverb::synthetic(3.0f, t60FromFeedback(0.85f), sampleRate);
+        default:                  return nullptr;
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace ava {
+namespace audio {
+
+// -------------------------
+// Reverb
+// -------------------------
+// Block interface over the reverbs vendored in the tree (DaisySP, Soundpipe,
+// STK), so AudioEngine can run any of them. Adapters own their engine and
+// all of its memory: process() never allocates or locks.
+class Reverb {
+public:
+    virtual ~Reverb() = default;
+
+    // Decay on the panel's scale: ReverbSc feedback, 0..0.99. Engines with a
+    // T60 or room-size control map it onto theirs (see t60FromFeedback).
+    virtual void setDecay(float feedback) = 0;
+
+    // Stereo in → wet stereo out, n frames. Outputs may alias the inputs.
+    virtual void process(const float* inL, const float* inR,
+                         float* outL, float* outR, size_t n) = 0;
+
+    // process() is driven faster than real time (offline render): engines
+    // that hand work to a thread do it inline instead, deterministically.
+    virtual void setOffline(bool) {}
+};
+
+// Cost tiers the panel picks from (low-end devices → studio machines).
+enum class ReverbTier : uint8_t { Low, Medium, High, Count };
+
+enum ReverbId : int {
+    ReverbDaisySc,        // daisysp::ReverbSc, block path (default)
+    ReverbSoundpipeSc,    // Soundpipe revsc: same design, per-sample
+    ReverbSoundpipeJc,    // Soundpipe jcrev (Faust), fixed decay
+    ReverbSoundpipeZita,  // Soundpipe zitarev (Faust): 8-line FDN, EQ
+    ReverbStkFreeVerb,
+    ReverbStkJc,
+    ReverbStkN,
+    ReverbStkPrc,
+    ReverbConvolution,    // ConvolutionReverb: loaded IR, else a synthetic hall
+    ReverbCount
+};
+
+struct ReverbInfo {
+    const char* name;
+    ReverbTier  tier;
+    float       costUs;   // µs of CPU per second of stereo audio, 48 kHz, 256-frame blocks
+};
+
+// Costs from AVA_ReverbBench (app/ReverbBench.cpp says where they were taken).
+inline constexpr ReverbInfo reverbEngines[ReverbCount] = {
+    { "ReverbSc",     ReverbTier::Medium,  2010.0f },
+    { "sp revsc",     ReverbTier::Medium,  2600.0f },
+    { "sp jcrev",     ReverbTier::Low,      750.0f },
+    { "sp zitarev",   ReverbTier::High,   10200.0f },
+    { "stk FreeVerb", ReverbTier::High,    4400.0f },
+    { "stk JCRev",    ReverbTier::Medium,  1800.0f },
+    { "stk NRev",     ReverbTier::Medium,  1600.0f },
+    { "stk PRCRev",   ReverbTier::Low,      540.0f },
+    { "convolution",  ReverbTier::High,   24000.0f },   // 3 s IR; about a fifth on the audio thread, the tail on a worker
+};
+
+inline const char* tierName(ReverbTier t) {
+    switch (t) {
+        case ReverbTier::Low:    return "Low";
+        case ReverbTier::Medium: return "Mid";
+        case ReverbTier::High:   return "High";
+        default:                 return "?";
+    }
+}
+
+// The engine each tier plays: the best sounding one within its budget.
+int reverbForTier(ReverbTier t);
+
+// Allocates and initializes (UI thread). nullptr for an unknown id.
+std::unique_ptr<Reverb> makeReverb(int id, double sampleRate);
+
+// T60 (seconds) of a ReverbSc-sized network with this loop feedback.
+float t60FromFeedback(float feedback);
+
+} // namespace audio
+} // namespace ava
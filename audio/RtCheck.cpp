@@ -0,0 +1,299 @@
+// Interposed libc calls must not be the fortified inline wrappers
+#undef _FORTIFY_SOURCE
+#include "RtCheck.h"
+
+#if AVA_RT_CHECKS
+#include <atomic>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#if defined(__GLIBC__)
+#define AVA_RT_INTERPOSE 1
+#include <dlfcn.h>
+#include <pthread.h>
+#include <unistd.h>
+#endif
+#if defined(__GLIBC__) || defined(__APPLE__)
+#include <execinfo.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <io.h>
+#include <malloc.h>
+#endif
+
+using namespace ava::audio;
+
+#if AVA_RT_INTERPOSE
+extern "C" {
+void* __libc_malloc(size_t);
+void* __libc_calloc(size_t, size_t);
+void* __libc_realloc(void*, size_t);
+void* __libc_memalign(size_t, size_t);
+void  __libc_free(void*);
+}
+#endif
+
+namespace {
+
+thread_local int  depth = 0;          // open Scopes on this thread
+thread_local bool reporting = false;  // a report's own calls aren't violations
+
+std::atomic<uint64_t> count{0};
+std::atomic<int> lateShown{0};
+constexpr int MaxLateReports = 10;
+
+bool  trap = false;
+float deadline = 0.75f;
+
+// Call sites already reported (return addresses), so a per-sample
+// violation prints once rather than 48000 times a second
+constexpr int MaxSites = 256;
+std::atomic<void*> sites[MaxSites];
+
+bool firstAt(void* site) {
+    for (int i = 0; i < MaxSites; i++) {
+        void* cur = sites[i].load(std::memory_order_relaxed);
+        if (cur == site) return false;
+        if (!cur && sites[i].compare_exchange_strong(cur, site)) return true;
+        if (cur == site) return false;
+    }
+    return false;   // table full: count only
+}
+
+void out(const char* s) {
+#if defined(_WIN32)
+    _write(2, s, (unsigned)std::strlen(s));
+#else
+    if (::write(2, s, std::strlen(s)) < 0) {}
+#endif
+}
+
+void backtraceHere() {
+#if defined(__GLIBC__) || defined(__APPLE__)
+    void* frames[32];
+    const int n = backtrace(frames, 32);
+    if (n > 2) backtrace_symbols_fd(frames + 2, n - 2, 2);   // past this and violation()
+#elif defined(_WIN32)
+    void* frames[32];
+    const USHORT n = CaptureStackBackTrace(2, 32, frames, nullptr);
+    char line[48];
+    for (USHORT i = 0; i < n; i++) {
+        std::snprintf(line, sizeof line, "  #%u %p\n", (unsigned)i, frames[i]);
+        out(line);
+    }
+#endif
+}
+
+void violation(const char* what, void* site) {
+    if (depth == 0 || reporting) return;
+    reporting = true;
+    count.fetch_add(1, std::memory_order_relaxed);
+    if (trap || firstAt(site)) {
+        char line[160];
+        std::snprintf(line, sizeof line, "[RtCheck] %s inside the audio callback\n", what);
+        out(line);
+        backtraceHere();
+    }
+    if (trap) std::abort();
+    reporting = false;
+}
+
+struct Env {
+    Env() {
+        if (const char* m = std::getenv("AVA_RT_CHECKS")) trap = std::strcmp(m, "trap") == 0;
+        if (const char* d = std::getenv("AVA_RT_DEADLINE")) deadline = (float)std::atof(d);
+#if defined(__GLIBC__) || defined(__APPLE__)
+        // the first backtrace() loads the unwinder: not from a report
+        void* warm[2];
+        backtrace(warm, 2);
+#endif
+    }
+} env;
+
+void* rawAlloc(size_t n, size_t align) {
+    if (n == 0) n = 1;
+#if AVA_RT_INTERPOSE
+    return align <= alignof(std::max_align_t) ? __libc_malloc(n) : __libc_memalign(align, n);
+#elif defined(_WIN32)
+    return _aligned_malloc(n, align < alignof(std::max_align_t) ? alignof(std::max_align_t) : align);
+#else
+    void* p = nullptr;
+    return posix_memalign(&p, align < sizeof(void*) ? sizeof(void*) : align, n) == 0 ? p : nullptr;
+#endif
+}
+
+void rawFree(void* p) {
+#if AVA_RT_INTERPOSE
+    __libc_free(p);
+#elif defined(_WIN32)
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+void* checkedNew(size_t n, size_t align, void* site, bool nothrow) {
+    violation("operator new", site);
+    void* p = rawAlloc(n, align);
+    if (!p && !nothrow) throw std::bad_alloc();
+    return p;
+}
+
+void checkedDelete(void* p, void* site) {
+    if (!p) return;
+    violation("operator delete", site);
+    rawFree(p);
+}
+
+} // namespace
+
+#define AVA_SITE __builtin_return_address(0)
+
+RtCheck::Scope::Scope() { depth++; }
+RtCheck::Scope::~Scope() { depth--; }
+
+void RtCheck::block(uint64_t busyNs, uint64_t budgetNs) {
+    if (depth == 0 || budgetNs == 0 || (double)busyNs <= deadline * (double)budgetNs) return;
+    count.fetch_add(1, std::memory_order_relaxed);
+    reporting = true;
+    if (trap || lateShown.fetch_add(1, std::memory_order_relaxed) < MaxLateReports) {
+        char line[160];
+        std::snprintf(line, sizeof line, "[RtCheck] late block: %.0f of %.0f us (%.0f%%, limit %.0f%%)\n",
+                      busyNs / 1e3, budgetNs / 1e3, 100.0 * busyNs / budgetNs, 100.0 * deadline);
+        out(line);
+    }
+    if (trap) std::abort();
+    reporting = false;
+}
+
+uint64_t RtCheck::violations() { return count.load(std::memory_order_relaxed); }
+
+// -------------------------
+// operator new / delete
+// -------------------------
+constexpr size_t kNewAlign = alignof(std::max_align_t);
+
+void* operator new(size_t n) { return checkedNew(n, kNewAlign, AVA_SITE, false); }
+void* operator new[](size_t n) { return checkedNew(n, kNewAlign, AVA_SITE, false); }
+void* operator new(size_t n, const std::nothrow_t&) noexcept { return checkedNew(n, kNewAlign, AVA_SITE, true); }
+void* operator new[](size_t n, const std::nothrow_t&) noexcept { return checkedNew(n, kNewAlign, AVA_SITE, true); }
+void* operator new(size_t n, std::align_val_t a) { return checkedNew(n, (size_t)a, AVA_SITE, false); }
+void* operator new[](size_t n, std::align_val_t a) { return checkedNew(n, (size_t)a, AVA_SITE, false); }
+void* operator new(size_t n, std::align_val_t a, const std::nothrow_t&) noexcept { return checkedNew(n, (size_t)a, AVA_SITE, true); }
+void* operator new[](size_t n, std::align_val_t a, const std::nothrow_t&) noexcept { return checkedNew(n, (size_t)a, AVA_SITE, true); }
+
+void operator delete(void* p) noexcept { checkedDelete(p, AVA_SITE); }
+void operator delete[](void* p) noexcept { checkedDelete(p, AVA_SITE); }
+void operator delete(void* p, size_t) noexcept { checkedDelete(p, AVA_SITE); }
+void operator delete[](void* p, size_t) noexcept { checkedDelete(p, AVA_SITE); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { checkedDelete(p, AVA_SITE); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { checkedDelete(p, AVA_SITE); }
+void operator delete(void* p, std::align_val_t) noexcept { checkedDelete(p, AVA_SITE); }
+void operator delete[](void* p, std::align_val_t) noexcept { checkedDelete(p, AVA_SITE); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { checkedDelete(p, AVA_SITE); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { checkedDelete(p, AVA_SITE); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { checkedDelete(p, AVA_SITE); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { checkedDelete(p, AVA_SITE); }
+
+// -------------------------
+// libc (glibc: definitions in the executable win over libc's)
+// -------------------------
+#if AVA_RT_INTERPOSE
+#define AVA_REAL(name) \
+    static const auto real = reinterpret_cast<decltype(&::name)>(dlsym(RTLD_NEXT, #name))
+
+extern "C" {
+
+void* malloc(size_t n) noexcept { violation("malloc", AVA_SITE); return __libc_malloc(n); }
+void* calloc(size_t a, size_t b) noexcept { violation("calloc", AVA_SITE); return __libc_calloc(a, b); }
+void* realloc(void* p, size_t n) noexcept { violation("realloc", AVA_SITE); return __libc_realloc(p, n); }
+void free(void* p) noexcept {
+    if (p) violation("free", AVA_SITE);
+    __libc_free(p);
+}
+
+int pthread_mutex_lock(pthread_mutex_t* m) noexcept {
+    AVA_REAL(pthread_mutex_lock);
+    violation("mutex lock", AVA_SITE);
+    return real(m);
+}
+
+FILE* fopen(const char* path, const char* mode) {
+    AVA_REAL(fopen);
+    violation("fopen", AVA_SITE);
+    return real(path, mode);
+}
+size_t fread(void* p, size_t s, size_t n, FILE* f) {
+    AVA_REAL(fread);
+    violation("fread", AVA_SITE);
+    return real(p, s, n, f);
+}
+size_t fwrite(const void* p, size_t s, size_t n, FILE* f) {
+    AVA_REAL(fwrite);
+    violation("fwrite", AVA_SITE);
+    return real(p, s, n, f);
+}
+int fputs(const char* s, FILE* f) {
+    AVA_REAL(fputs);
+    violation("fputs", AVA_SITE);
+    return real(s, f);
+}
+int puts(const char* s) {
+    AVA_REAL(puts);
+    violation("puts", AVA_SITE);
+    return real(s);
+}
+int fputc(int c, FILE* f) {
+    AVA_REAL(fputc);
+    violation("fputc", AVA_SITE);
+    return real(c, f);
+}
+int putc(int c, FILE* f) {
+    AVA_REAL(putc);
+    violation("putc", AVA_SITE);
+    return real(c, f);
+}
+int fflush(FILE* f) {
+    AVA_REAL(fflush);
+    violation("fflush", AVA_SITE);
+    return real(f);
+}
+int printf(const char* fmt, ...) {
+    violation("printf", AVA_SITE);
+    va_list ap;
+    va_start(ap, fmt);
+    const int r = std::vfprintf(stdout, fmt, ap);
+    va_end(ap);
+    return r;
+}
+int fprintf(FILE* f, const char* fmt, ...) {
+    violation("fprintf", AVA_SITE);
+    va_list ap;
+    va_start(ap, fmt);
+    const int r = std::vfprintf(f, fmt, ap);
+    va_end(ap);
+    return r;
+}
+ssize_t read(int fd, void* p, size_t n) {
+    AVA_REAL(read);
+    violation("read", AVA_SITE);
+    return real(fd, p, n);
+}
+ssize_t write(int fd, const void* p, size_t n) {
+    AVA_REAL(write);
+    violation("write", AVA_SITE);
+    return real(fd, p, n);
+}
+
+} // extern "C"
+#endif // AVA_RT_INTERPOSE
+
+#endif // AVA_RT_CHECKS
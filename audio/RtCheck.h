@@ -0,0 +1,52 @@
+#pragma once
+#include <cstdint>
+
+namespace ava {
+namespace audio {
+
+// -------------------------
+// RtCheck
+// -------------------------
+// Real-time violation detector, compiled in with -DAVA_RT_CHECKS=ON (CMake)
+// and a no-op otherwise. While a thread is inside a Scope (the engine opens
+// one around render(), so the offline renderer is covered too) it reports:
+//
+//   heap        operator new/delete; malloc/calloc/realloc/free (glibc)
+//   locks       pthread_mutex_lock (std::mutex, iostream's stream locks)
+//   I/O         fopen/fread/fwrite/fputs/puts/fputc/putc/fflush/printf/fprintf,
+//               read/write (std::cout and std::cerr end up in these)
+//   deadline    a block that took more than AVA_RT_DEADLINE of its budget
+//
+// Each call site is reported once, with a backtrace, as "[RtCheck] ...";
+// repeats are only counted. AVA_RT_CHECKS=trap in the environment aborts
+// at the first violation instead (for a debugger or CI), AVA_RT_DEADLINE
+// sets the late-block fraction (default 0.75). Interposing malloc and the
+// libc calls needs glibc; elsewhere operator new/delete and the deadline
+// are checked.
+class RtCheck {
+public:
+#if AVA_RT_CHECKS
+    class Scope {
+    public:
+        Scope();
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    static constexpr bool enabled = true;
+    // End of a block: busy vs. the block's real-time budget.
+    static void block(uint64_t busyNs, uint64_t budgetNs);
+    static uint64_t violations();
+#else
+    // user-provided, so `RtCheck::Scope rtScope;` isn't an unused variable
+    struct Scope { Scope() {} ~Scope() {} };
+
+    static constexpr bool enabled = false;
+    static void block(uint64_t, uint64_t) {}
+    static uint64_t violations() { return 0; }
+#endif
+};
+
+} // namespace audio
+} // namespace ava
@@ -0,0 +1,174 @@
+#include "RtMemory.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define AVA_HAVE_MXCSR 1
+#endif
+
+using namespace ava::audio;
+
+namespace {
+
+constexpr size_t kPage = 4096;
+
+RtArena::Config globalConfig;
+std::atomic<bool> globalMade{false};
+
+int log2Ceil(size_t n) {
+    int s = 0;
+    while (((size_t)1 << s) < n) s++;
+    return s;
+}
+
+} // namespace
+
+RtArena::RtArena(Config cfg) {
+    capacity = (cfg.bytes + kPage - 1) & ~(kPage - 1);
+    base = static_cast<char*>(::operator new(capacity, std::align_val_t(kPage)));
+
+    // prefault: the first touch of each page happens here, not in a callback
+    volatile char* touch = base;
+    for (size_t i = 0; i < capacity; i += kPage) touch[i] = 0;
+
+    if (cfg.lock) {
+#if defined(_WIN32)
+        locked = VirtualLock(base, capacity) != 0;
+#else
+        locked = mlock(base, capacity) == 0;
+#endif
+        if (!locked)
+            std::cerr << "RtArena: could not lock " << (capacity >> 20)
+                      << " MiB in memory (pages may be swapped out)\n";
+    }
+}
+
+RtArena::~RtArena() {
+    if (locked) {
+#if defined(_WIN32)
+        VirtualUnlock(base, capacity);
+#else
+        munlock(base, capacity);
+#endif
+    }
+    ::operator delete(base, std::align_val_t(kPage));
+}
+
+void RtArena::configure(Config cfg) {
+    if (!globalMade.load()) globalConfig = cfg;
+}
+
+RtArena& RtArena::global() {
+    // never destroyed: keys and engines may retire blocks during static teardown
+    static RtArena* arena = (globalMade.store(true), new RtArena(globalConfig));
+    return *arena;
+}
+
+void* RtArena::allocate(size_t bytes) {
+    const int shift = std::max(log2Ceil(bytes + Header), MinShift);
+    const uint32_t cls = (uint32_t)(shift - MinShift);
+    const size_t size = (size_t)1 << shift;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    collectLocked();
+
+    char* block = nullptr;
+    if (cls < Classes && freeLists[cls]) {
+        block = static_cast<char*>(freeLists[cls]) - Header;
+        std::memcpy(&freeLists[cls], block + Header, sizeof(void*));
+    } else if (cls < Classes && carved + size <= capacity) {
+        block = base + carved;
+        carved += size;
+    }
+
+    uint32_t tag = cls;
+    if (!block) {
+        if (heapFallbacks++ == 0)
+            std::cerr << "RtArena: " << (capacity >> 20)
+                      << " MiB region full, falling back to the heap\n";
+        block = static_cast<char*>(::operator new(size, std::align_val_t(Header)));
+        tag = HeapClass;
+    }
+    std::memcpy(block, &tag, sizeof tag);
+    if (tag != HeapClass) live += size;
+    return block + Header;
+}
+
+void RtArena::retire(void* p) {
+    if (!p) return;
+    const auto* seq = callbackSeq.load();
+    const unsigned now = seq ? seq->load() : 0u;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (isSafe(now)) release(p);
+    else             retired.push_back({ p, now });
+    collectLocked();
+}
+
+void RtArena::collect() {
+    std::lock_guard<std::mutex> lock(mutex);
+    collectLocked();
+}
+
+// A block retired while no callback ran can't be in use (the callback that
+// runs next loads the new pointer); one retired mid-callback is free once
+// that callback has returned and the counter moved on.
+bool RtArena::isSafe(unsigned seqAtRetire) const {
+    const auto* seq = callbackSeq.load();
+    return !seq || (seqAtRetire & 1u) == 0 || seq->load() != seqAtRetire;
+}
+
+void RtArena::collectLocked() {
+    size_t keep = 0;
+    for (auto& r : retired) {
+        if (isSafe(r.seq)) release(r.p);
+        else               retired[keep++] = r;
+    }
+    retired.resize(keep);
+}
+
+void RtArena::release(void* p) {
+    char* block = static_cast<char*>(p) - Header;
+    uint32_t tag;
+    std::memcpy(&tag, block, sizeof tag);
+    if (tag == HeapClass) {
+        ::operator delete(block, std::align_val_t(Header));
+        return;
+    }
+    live -= (size_t)1 << (tag + MinShift);
+    std::memcpy(p, &freeLists[tag], sizeof(void*));
+    freeLists[tag] = p;
+}
+
+RtArena::Stats RtArena::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    Stats s;
+    s.capacity = capacity;
+    s.carved = carved;
+    s.live = live;
+    s.retired = retired.size();
+    s.heapFallbacks = heapFallbacks;
+    s.locked = locked;
+    return s;
+}
+
+void ava::audio::enableDenormalFlush() {
+#if defined(AVA_HAVE_MXCSR)
+    _mm_setcsr(_mm_getcsr() | 0x8040u);   // FTZ (bit 15) | DAZ (bit 6)
+#elif defined(__aarch64__)
+    uint64_t fpcr;
+    __asm__ __volatile__("mrs %0, fpcr" : "=r"(fpcr));
+    __asm__ __volatile__("msr fpcr, %0" : : "r"(fpcr | ((uint64_t)1 << 24)));   // FZ
+#endif
+}
@@ -0,0 +1,152 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace ava {
+namespace audio {
+
+// -------------------------
+// RtArena
+// -------------------------
+// Memory for what the UI thread hands the audio callback (key lists,
+// wavetables). One region, allocated and prefaulted (every page written)
+// at startup, optionally mlock'ed, carved into power-of-two blocks with a
+// free list per size. allocate() and retire() are for non-RT threads and
+// take a mutex; the callback only reads what they published.
+//
+// retire() is the deferred release: a block the callback may still be
+// reading is freed by a later collect() on a non-RT thread, once the
+// watched callback counter (odd while a callback runs) shows that callback
+// has returned. Blocks are raw memory: objects placed in them must be
+// trivially destructible.
+class RtArena {
+public:
+    struct Config {
+        size_t bytes = 32u << 20;
+        bool   lock = false;       // mlock / VirtualLock the region
+    };
+
+    struct Stats {
+        size_t capacity = 0;
+        size_t carved = 0;         // bytes handed out of the region so far
+        size_t live = 0;           // bytes in blocks not yet freed
+        size_t retired = 0;        // blocks waiting for collect()
+        size_t heapFallbacks = 0;  // allocations the region could not hold
+        bool   locked = false;
+    };
+
+    explicit RtArena(Config cfg);
+    ~RtArena();
+    RtArena(const RtArena&) = delete;
+    RtArena& operator=(const RtArena&) = delete;
+
+    // The arena everything audio-side uses. configure() before the first
+    // global() call picks its size and locking; later calls are ignored.
+    static void configure(Config cfg);
+    static RtArena& global();
+
+    // 64-byte aligned. Past capacity it falls back to the heap (counted,
+    // and reported once) rather than fail.
+    void* allocate(size_t bytes);
+    void  retire(void* p);
+    void  collect();
+
+    // The callback counter of the engine whose callback reads these blocks.
+    void watch(const std::atomic<unsigned>* seq) { callbackSeq.store(seq); }
+
+    Stats stats() const;
+
+private:
+    static constexpr size_t Header = 64;     // keeps the payload cache-aligned
+    static constexpr int    MinShift = 6;    // smallest block: 64 bytes
+    static constexpr int    Classes = 40;
+    static constexpr uint32_t HeapClass = 0xFFFFFFFFu;
+
+    struct Retired { void* p; unsigned seq; };
+
+    char*  base = nullptr;
+    size_t capacity = 0;
+    size_t carved = 0;
+    size_t live = 0;
+    size_t heapFallbacks = 0;
+    bool   locked = false;
+
+    void* freeLists[Classes] = {};
+    std::vector<Retired> retired;
+    std::atomic<const std::atomic<unsigned>*> callbackSeq{nullptr};
+    mutable std::mutex mutex;
+
+    void release(void* p);    // mutex held
+    bool isSafe(unsigned seqAtRetire) const;
+    void collectLocked();
+};
+
+// -------------------------
+// RtArray
+// -------------------------
+// A length followed by that many T in one arena block: what the callback
+// iterates (a key list) is published as one pointer, never torn.
+template <typename T>
+struct RtArray {
+    static_assert(std::is_trivially_copyable_v<T>, "arena blocks are raw memory");
+    size_t count = 0;
+    uint64_t pad = 0;
+
+    T*       data()       { return reinterpret_cast<T*>(this + 1); }
+    const T* data() const { return reinterpret_cast<const T*>(this + 1); }
+    std::span<T const> span() const { return { data(), count }; }
+
+    static RtArray* make(const T* src, size_t n) {
+        void* mem = RtArena::global().allocate(sizeof(RtArray) + n * sizeof(T));
+        auto* a = new (mem) RtArray;
+        a->count = n;
+        for (size_t i = 0; i < n; i++) new (a->data() + i) T(src[i]);
+        return a;
+    }
+};
+
+// -------------------------
+// RtPtr
+// -------------------------
+// Owns one arena block the callback reads. get() is the callback's
+// (acquire) load; reset() publishes a replacement and retires the old
+// block, so the UI thread can swap tables while keys are sounding. Moves
+// are for objects the callback cannot see yet (keys being built).
+template <typename T>
+class RtPtr {
+    static_assert(std::is_trivially_destructible_v<T>, "arena blocks are never destructed");
+public:
+    RtPtr() = default;
+    explicit RtPtr(T* p) : ptr(p) {}
+    RtPtr(RtPtr&& o) noexcept : ptr(o.ptr.exchange(nullptr, std::memory_order_relaxed)) {}
+    RtPtr& operator=(RtPtr&& o) noexcept {
+        if (this != &o) reset(o.ptr.exchange(nullptr, std::memory_order_relaxed));
+        return *this;
+    }
+    ~RtPtr() { reset(); }
+
+    T* get() const { return ptr.load(std::memory_order_acquire); }
+    explicit operator bool() const { return get() != nullptr; }
+
+    void reset(T* next = nullptr) {
+        if (T* old = ptr.exchange(next, std::memory_order_acq_rel))
+            RtArena::global().retire(old);
+    }
+
+private:
+    std::atomic<T*> ptr{nullptr};
+};
+
+// Flush denormals to zero (FTZ) and treat denormal inputs as zero (DAZ) on
+// the calling thread: decaying tails and filter states stay at full speed.
+// No-op on targets without the control bits.
+void enableDenormalFlush();
+
+} // namespace audio
+} // namespace ava
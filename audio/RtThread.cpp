@@ -0,0 +1,40 @@
+#include "RtThread.h"
+#include <algorithm>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace ava::audio;
+
+bool ava::audio::raiseToRealtime(std::thread& t) {
+#if defined(_WIN32)
+    return SetThreadPriority(t.native_handle(), THREAD_PRIORITY_TIME_CRITICAL) != 0;
+#else
+    sched_param p{};
+    p.sched_priority = std::max(sched_get_priority_min(SCHED_FIFO), sched_get_priority_max(SCHED_FIFO) - 1);
+    return pthread_setschedparam(t.native_handle(), SCHED_FIFO, &p) == 0;
+#endif
+}
+
+bool ava::audio::pinToCore(std::thread& t, unsigned core) {
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    core %= cores;
+#if defined(_WIN32)
+    return SetThreadAffinityMask(t.native_handle(), (DWORD_PTR)1 << core) != 0;
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    return pthread_setaffinity_np(t.native_handle(), sizeof set, &set) == 0;
+#else
+    (void)t;
+    return false;
+#endif
+}
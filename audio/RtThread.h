@@ -0,0 +1,23 @@
+#pragma once
+#include <thread>
+
+namespace ava {
+namespace audio {
+
+// -------------------------
+// Real-time worker threads
+// -------------------------
+// For the engine's own audio-side threads (FxPipeline, VoiceWorkers); the
+// device callback's thread belongs to the host. Both are best effort and
+// return false when the platform or the process's permissions say no.
+
+// SCHED_FIFO one step under the maximum (Windows: time-critical), so the
+// device thread, usually at the maximum, still wins a tie.
+bool raiseToRealtime(std::thread& t);
+
+// Keep the thread on one core (core modulo the core count). No-op on
+// macOS, which only takes affinity hints.
+bool pinToCore(std::thread& t, unsigned core);
+
+} // namespace audio
+} // namespace ava
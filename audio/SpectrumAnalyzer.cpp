@@ -0,0 +1,169 @@
+#include "SpectrumAnalyzer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+#if AVA_HAVE_KISSFFT
+#include "kiss_fftr.h"
+#endif
+
+using namespace ava::audio;
+
+SpectrumAnalyzer::SpectrumAnalyzer(double sr) : SpectrumAnalyzer(sr, Config{}) {}
+
+SpectrumAnalyzer::SpectrumAnalyzer(double sr, Config c)
+    : cfg(c), sampleRate(sr > 0.0 ? sr : 48000.0),
+      // ~0.7 s of stereo output: the worker can stall that long before drops
+      input(1 << 15) {
+    cfg.fftSize = std::max(256, cfg.fftSize & ~1);
+    cfg.hop     = std::clamp(cfg.hop, 1, cfg.fftSize);
+    cfg.bins    = std::max(8, cfg.bins);
+
+    history.assign(cfg.fftSize, 0.0f);
+    frame.assign(cfg.fftSize, 0.0f);
+    window.resize(cfg.fftSize);
+    for (int i = 0; i < cfg.fftSize; i++)
+        window[i] = 0.5f - 0.5f * std::cos(2.0 * M_PI * i / cfg.fftSize);   // Hann
+
+    smoothed.assign(cfg.bins, cfg.floorDb);
+    spectrumDb.assign(cfg.bins, cfg.floorDb);
+    published.assign(cfg.bins, cfg.floorDb);
+    setupBins();
+}
+
+SpectrumAnalyzer::~SpectrumAnalyzer() {
+    stop();
+#if AVA_HAVE_KISSFFT
+    if (fft) kiss_fftr_free(static_cast<kiss_fftr_cfg>(fft));
+#endif
+}
+
+bool SpectrumAnalyzer::available() {
+#if AVA_HAVE_KISSFFT
+    return true;
+#else
+    return false;
+#endif
+}
+
+float SpectrumAnalyzer::binFrequency(int i) const {
+    float t = (i + 0.5f) / (float)cfg.bins;
+    return cfg.fMin * std::pow(cfg.fMax / cfg.fMin, t);
+}
+
+void SpectrumAnalyzer::setupBins() {
+    const float hzPerBin = (float)sampleRate / cfg.fftSize;
+    const float maxBin = cfg.fftSize / 2.0f;
+    binLo.resize(cfg.bins);
+    binHi.resize(cfg.bins);
+    for (int i = 0; i < cfg.bins; i++) {
+        float lo = cfg.fMin * std::pow(cfg.fMax / cfg.fMin, (float)i / cfg.bins);
+        float hi = cfg.fMin * std::pow(cfg.fMax / cfg.fMin, (float)(i + 1) / cfg.bins);
+        binLo[i] = std::min(lo / hzPerBin, maxBin);
+        binHi[i] = std::min(hi / hzPerBin, maxBin);
+    }
+}
+
+bool SpectrumAnalyzer::start() {
+#if AVA_HAVE_KISSFFT
+    if (running.load()) return true;
+    if (!fft) fft = kiss_fftr_alloc(cfg.fftSize, 0, nullptr, nullptr);
+    if (!fft) {
+        std::cerr << "[Spectrum] FFT setup failed\n";
+        return false;
+    }
+    fftOut.assign((cfg.fftSize / 2 + 1) * 2, 0.0f);
+    running = true;
+    worker = std::thread(&SpectrumAnalyzer::run, this);
+    return true;
+#else
+    std::cerr << "[Spectrum] built without FFT (AVA_ENABLE_FFT=OFF)\n";
+    return false;
+#endif
+}
+
+void SpectrumAnalyzer::stop() {
+    running = false;
+    if (worker.joinable()) worker.join();
+}
+
+void SpectrumAnalyzer::run() {
+    std::vector<float> chunk(4096);   // even: whole stereo frames only
+
+    while (running.load()) {
+        size_t n = input.ring.pop(chunk.data(), chunk.size());
+        if (n == 0) {
+            // nothing queued: a few ms is well inside one hop (~21 ms)
+            std::this_thread::sleep_for(std::chrono::milliseconds(4));
+            continue;
+        }
+
+        for (size_t i = 0; i + 1 < n; i += 2) {
+            history[historyPos] = 0.5f * (chunk[i] + chunk[i + 1]);
+            historyPos = (historyPos + 1) % history.size();
+            if (++sinceLast >= cfg.hop) {
+                sinceLast = 0;
+                analyze();
+            }
+        }
+    }
+}
+
+void SpectrumAnalyzer::analyze() {
+#if AVA_HAVE_KISSFFT
+    const int N = cfg.fftSize;
+
+    // oldest sample first
+    for (int i = 0; i < N; i++)
+        frame[i] = history[(historyPos + i) % N] * window[i];
+
+    auto* out = reinterpret_cast<kiss_fft_cpx*>(fftOut.data());
+    kiss_fftr(static_cast<kiss_fftr_cfg>(fft), frame.data(), out);
+
+    // amplitude of a full-scale sine → 0 dB (Hann coherent gain 0.5)
+    const float norm = 2.0f / (0.5f * N);
+    auto powerAt = [&](int k) {
+        float re = out[k].r * norm, im = out[k].i * norm;
+        return re * re + im * im;
+    };
+    auto toDb = [&](float p) { return std::max(cfg.floorDb, 10.0f * std::log10(p + 1e-20f)); };
+
+    const int last = N / 2;
+    for (int b = 0; b < cfg.bins; b++) {
+        float lo = binLo[b], hi = binHi[b];
+        float p;
+        if (hi - lo < 1.0f) {
+            // display bin narrower than an FFT bin: interpolate at its centre
+            float c = 0.5f * (lo + hi);
+            int k = std::min((int)c, last - 1);
+            float f = c - k;
+            p = powerAt(k) * (1.0f - f) + powerAt(k + 1) * f;
+        } else {
+            // wider: keep the strongest partial so narrow peaks stay visible
+            p = 0.0f;
+            for (int k = (int)std::ceil(lo); k <= std::min((int)hi, last); k++)
+                p = std::max(p, powerAt(k));
+        }
+        spectrumDb[b] = toDb(p);
+    }
+
+    const float release = cfg.releaseDbPerSec * cfg.hop / (float)sampleRate;
+    for (int b = 0; b < cfg.bins; b++) {
+        float v = spectrumDb[b], &s = smoothed[b];
+        s = (v > s) ? s + (v - s) * 0.6f : std::max(v, s - release);
+    }
+
+    std::lock_guard<std::mutex> lock(outMtx);
+    published = smoothed;
+    publishedFrame++;
+#endif
+}
+
+bool SpectrumAnalyzer::latest(std::vector<float>& outDb) {
+    std::lock_guard<std::mutex> lock(outMtx);
+    if (publishedFrame == seenFrame) return false;
+    seenFrame = publishedFrame;
+    outDb = published;
+    return true;
+}
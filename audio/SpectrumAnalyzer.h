@@ -0,0 +1,83 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "SpscRing.h"
+
+namespace ava {
+namespace audio {
+
+// -------------------------
+// SpectrumAnalyzer
+// -------------------------
+// Real-time spectrum of the engine output, computed entirely off the audio
+// thread:
+//   callback → AudioTap (wait-free ring) → worker: Hann window, real FFT
+//   every `hop` samples (overlapping frames) → log-frequency bins in dB,
+//   fast attack / slow release → latest() for the UI.
+//
+// Needs the FFT (AVA_ENABLE_FFT=ON, kissfft); otherwise available() is
+// false and start() does nothing.
+class SpectrumAnalyzer {
+public:
+    struct Config {
+        int   fftSize = 8192;     // 5.9 Hz bins at 48 kHz: enough to see cents-level partial offsets
+        int   hop     = 1024;     // 87.5% overlap, ~47 frames/s
+        int   bins    = 480;      // log-spaced display bins
+        float fMin    = 27.5f;    // A0
+        float fMax    = 16000.0f;
+        float floorDb = -96.0f;
+        float releaseDbPerSec = 48.0f;
+    };
+
+    explicit SpectrumAnalyzer(double sampleRate);
+    SpectrumAnalyzer(double sampleRate, Config cfg);
+    ~SpectrumAnalyzer();
+
+    SpectrumAnalyzer(const SpectrumAnalyzer&) = delete;
+    SpectrumAnalyzer& operator=(const SpectrumAnalyzer&) = delete;
+
+    static bool available();
+
+    // Register this with AudioEngine::addTap() before start().
+    AudioTap& tap() { return input; }
+
+    bool start();
+    void stop();
+
+    // UI thread: copies the newest bins (dB, size = bins) if a new frame
+    // arrived since the last call.
+    bool latest(std::vector<float>& outDb);
+
+    const Config& config() const { return cfg; }
+    float binFrequency(int i) const;
+
+private:
+    Config cfg;
+    double sampleRate;
+    AudioTap input;
+
+    std::thread worker;
+    std::atomic<bool> running{false};
+
+    // worker-only state
+    std::vector<float> history;     // mono, circular, fftSize long
+    size_t historyPos = 0;
+    int    sinceLast = 0;
+    std::vector<float> window, frame, smoothed, spectrumDb;
+    std::vector<float> binLo, binHi; // FFT bin range per display bin (fractional)
+    void* fft = nullptr;             // kiss_fftr_cfg
+    std::vector<float> fftOut;       // interleaved re/im, fftSize/2+1 pairs
+
+    std::mutex outMtx;
+    std::vector<float> published;
+    unsigned publishedFrame = 0, seenFrame = 0;
+
+    void run();
+    void analyze();
+    void setupBins();
+};
+
+} // namespace audio
+} // namespace ava
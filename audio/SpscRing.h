@@ -0,0 +1,103 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+namespace ava {
+namespace audio {
+
+// -------------------------
+// SpscRing
+// -------------------------
+// Wait-free single-producer / single-consumer ring of trivially copyable T.
+// The producer is the audio callback: push() never blocks or allocates, it
+// writes what fits and counts the rest as dropped. Capacity is rounded up
+// to a power of two and allocated once in the constructor.
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity) {
+        size_t n = 1;
+        while (n < capacity) n <<= 1;
+        buf.resize(n);
+        mask = n - 1;
+    }
+
+    size_t capacity() const { return buf.size(); }
+
+    // Producer side. Returns how many items were written.
+    size_t push(const T* data, size_t count) {
+        const size_t w = writePos.load(std::memory_order_relaxed);
+        const size_t r = readPos.load(std::memory_order_acquire);
+        const size_t space = buf.size() - (w - r);
+        const size_t n = std::min(count, space);
+
+        const size_t first = std::min(n, buf.size() - (w & mask));
+        std::copy(data, data + first, buf.data() + (w & mask));
+        std::copy(data + first, data + n, buf.data());
+
+        writePos.store(w + n, std::memory_order_release);
+        if (n < count) dropped.fetch_add(count - n, std::memory_order_relaxed);
+        return n;
+    }
+
+    // Consumer side. Returns how many items were read.
+    size_t pop(T* out, size_t maxCount) {
+        const size_t r = readPos.load(std::memory_order_relaxed);
+        const size_t w = writePos.load(std::memory_order_acquire);
+        const size_t n = std::min(maxCount, w - r);
+
+        const size_t first = std::min(n, buf.size() - (r & mask));
+        std::copy(buf.data() + (r & mask), buf.data() + (r & mask) + first, out);
+        std::copy(buf.data(), buf.data() + (n - first), out + first);
+
+        readPos.store(r + n, std::memory_order_release);
+        return n;
+    }
+
+    size_t available() const {
+        return writePos.load(std::memory_order_acquire) - readPos.load(std::memory_order_relaxed);
+    }
+
+    // Items the producer had to throw away because the consumer fell behind.
+    size_t droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    std::vector<T> buf;
+    size_t mask = 0;
+    alignas(64) std::atomic<size_t> writePos{0};
+    alignas(64) std::atomic<size_t> readPos{0};
+    std::atomic<size_t> dropped{0};
+};
+
+// -------------------------
+// AudioTap
+// -------------------------
+// What AudioEngine::addTap() takes: a stereo-interleaved ring the callback
+// copies its final output into. One consumer thread per tap.
+struct AudioTap {
+    explicit AudioTap(size_t frames = 1 << 15) : ring(frames * 2) {}
+    SpscRing<float> ring;
+    std::atomic<bool> enabled{true};   // false → the callback skips this tap
+    std::atomic<bool> writing{false};  // the callback is inside write()
+
+    // Callback side: one block in, unless disabled.
+    void write(const float* data, size_t count) {
+        writing.store(true);
+        if (enabled.load()) ring.push(data, count);
+        writing.store(false);
+    }
+
+    // Consumer side: once this returns, nothing more reaches the ring.
+    // writing is raised before enabled is read (both seq_cst), so a block
+    // that saw enabled == true is waited out here.
+    void disable() {
+        enabled.store(false);
+        while (writing.load()) std::this_thread::yield();
+    }
+};
+
+} // namespace audio
+} // namespace ava
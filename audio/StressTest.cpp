@@ -0,0 +1,113 @@
+#include "StressTest.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace ava::audio;
+
+StressTest::StressTest(AudioEngine& e, Config c) : engine(e), cfg(c) {
+    cfg.maxPerformers = std::clamp(cfg.maxPerformers, 1, Improviser::MaxStrokes);
+    cfg.step = std::max(1, cfg.step);
+    cfg.stepSeconds = std::max(0.1, cfg.stepSeconds);
+}
+
+StressTest::Config StressTest::configFromArgs(int argc, char* argv[]) {
+    Config c;
+    for (int i = 1; i + 1 < argc; i++) {
+        std::string a = argv[i];
+        if (a == "--performers")        c.maxPerformers = std::atoi(argv[++i]);
+        else if (a == "--step")         c.step = std::atoi(argv[++i]);
+        else if (a == "--step-seconds") c.stepSeconds = std::atof(argv[++i]);
+        else if (a == "--stroke-ms")    c.strokeMs = std::atoi(argv[++i]);
+        else if (a == "--seed")         c.seed = (uint32_t)std::strtoul(argv[++i], nullptr, 10);
+    }
+    return c;
+}
+
+void StressTest::start(double now) {
+    rows.clear();
+    auto& im = engine.improviser();
+    im.setStyle(cfg.strokeMs, false);
+    im.enable(cfg.seed);
+    active = true;
+
+    std::cout << "[Stress] ramping to " << cfg.maxPerformers << " performers, "
+              << cfg.stepSeconds << " s per level, " << cfg.strokeMs << " ms strokes, seed "
+              << cfg.seed << "\n";
+    std::printf("[Stress] %10s %9s %9s %6s %9s %7s %8s  %s\n",
+                "performers", "mean", "peak", "xruns", "overruns", "voices", "fingers", "quality");
+    beginLevel(1, now);
+}
+
+void StressTest::beginLevel(int n, double now) {
+    performers = n;
+    levelStart = now;
+    peakFingers = 0;
+    worstQuality = 0;
+    engine.improviser().setConcurrency(n);
+    engine.resetPeaks();
+    base = engine.stats();
+}
+
+void StressTest::endLevel() {
+    AudioEngine::Stats st = engine.stats();
+    Row r;
+    r.performers = performers;
+    const uint64_t audio = st.audioNs - base.audioNs;
+    r.meanLoad    = audio ? (double)(st.busyNs - base.busyNs) / (double)audio : 0.0;
+    r.peakLoad    = st.peakLoad;
+    r.xruns       = st.xruns - base.xruns;
+    r.overruns    = st.overruns - base.overruns;
+    r.peakVoices  = st.peakVoices;
+    r.peakFingers = peakFingers;
+    r.worstQuality = worstQuality;
+    rows.push_back(r);
+
+    std::printf("[Stress] %10d %8.1f%% %8.1f%% %6llu %9llu %7d %8d  %s\n",
+                r.performers, 100.0 * r.meanLoad, 100.0 * r.peakLoad,
+                (unsigned long long)r.xruns, (unsigned long long)r.overruns,
+                r.peakVoices, r.peakFingers,
+                QualityGovernor::levelName((QualityGovernor::Level)r.worstQuality));
+}
+
+bool StressTest::update(double now) {
+    if (!active) return false;
+    const AudioEngine::Stats st = engine.stats();
+    peakFingers = std::max(peakFingers, st.fingers);
+    worstQuality = std::max(worstQuality, st.quality);
+    if (now - levelStart < cfg.stepSeconds) return true;
+
+    endLevel();
+    if (performers >= cfg.maxPerformers) {
+        auto& im = engine.improviser();
+        im.disable();
+        im.setStyle(Improviser::DefaultStrokeMs, true);
+        im.setConcurrency(Improviser::DefaultConcurrency);
+        active = false;
+        print(std::cout);
+        return false;
+    }
+    int next = (performers == 1 && cfg.step > 1) ? cfg.step : performers + cfg.step;
+    beginLevel(std::min(next, cfg.maxPerformers), now);
+    return true;
+}
+
+void StressTest::print(std::ostream& os) const {
+    // the ceiling: last level before anything went wrong
+    const Row* safe = nullptr;
+    for (const auto& r : rows) {
+        if (r.xruns || r.overruns || r.peakLoad >= 1.0f) break;
+        safe = &r;
+    }
+    if (!safe) {
+        os << "[Stress] no clean level: even 1 performer glitches on this setup\n";
+    } else if (safe == &rows.back()) {
+        os << "[Stress] clean up to " << safe->performers << " performers (" << safe->peakVoices
+           << " voices), peak load " << (int)(100.0f * safe->peakLoad) << "%: ceiling not reached\n";
+    } else {
+        os << "[Stress] ceiling: " << safe->performers << " performers / " << safe->peakVoices
+           << " voices before the first xrun or overrun\n";
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include "AudioEngine.h"
+
+namespace ava {
+namespace audio {
+
+// -------------------------
+// StressTest
+// -------------------------
+// Finds a device's polyphony / latency ceiling: the improviser plays
+// 1 → maxPerformers simultaneous seeded strokes (one virtual finger each)
+// with no phrase pauses, holding each level for stepSeconds, and the
+// engine's counters are recorded per level.
+//
+// Runs against the live device (AVA_C --stress) or headless
+// (AVA_Render --stress), where "overruns" are blocks that rendered slower
+// than real time. Point the improviser at the whole keyboard first.
+class StressTest {
+public:
+    struct Config {
+        int      maxPerformers = Improviser::MaxStrokes;
+        int      step = 2;               // performers added per level (after 1)
+        double   stepSeconds = 5.0;
+        int      strokeMs = 600;         // shorter strokes → more note-ons per second
+        uint32_t seed = 1;               // same seed → same workload
+    };
+
+    struct Row {
+        int      performers = 0;
+        double   meanLoad = 0.0;         // render time / audio time over the level
+        float    peakLoad = 0.0f;        // worst single block
+        uint64_t xruns = 0;
+        uint64_t overruns = 0;
+        int      peakVoices = 0;
+        int      peakFingers = 0;
+        int      worstQuality = 0;       // lowest QualityGovernor level reached
+    };
+
+    StressTest(AudioEngine& engine, Config cfg);
+
+    // --performers N  --step N  --step-seconds S  --stroke-ms MS  --seed X
+    static Config configFromArgs(int argc, char* argv[]);
+
+    // nowSeconds: any monotonic clock (SDL ticks, or rendered frames / rate)
+    void start(double nowSeconds);
+    // Call every frame / block. Returns false once the last level is done
+    // and the improviser has been put back to its normal style.
+    bool update(double nowSeconds);
+
+    bool running() const { return active; }
+    const std::vector<Row>& results() const { return rows; }
+    void print(std::ostream& os) const;
+
+private:
+    AudioEngine& engine;
+    Config cfg;
+    std::vector<Row> rows;
+
+    bool   active = false;
+    int    performers = 0;
+    double levelStart = 0.0;
+    int    peakFingers = 0;
+    int    worstQuality = 0;
+    AudioEngine::Stats base;
+
+    void beginLevel(int n, double now);
+    void endLevel();
+};
+
+} // namespace audio
+} // namespace ava
@@ -0,0 +1,159 @@
+#include "VoiceWorkers.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include "../dsp/Kernels.h"
+#include "../ui/Key.h"
+#include "PhysicalVoice.h"
+#include "RtCheck.h"
+#include "RtMemory.h"
+#include "RtThread.h"
+
+using namespace ava::audio;
+using Clock = std::chrono::steady_clock;
+
+VoiceWorkers::VoiceWorkers(int helperThreads, double sampleRate)
+    : sampleRate(sampleRate),
+      lanes(std::make_unique<Lane[]>(MaxThreads)) {
+    // a spinning helper sharing the callback's only core would starve it
+    const int cores = (int)std::max(1u, std::thread::hardware_concurrency());
+    helperCount = std::clamp(helperThreads, 0, std::min(MaxThreads, cores) - 1);
+    int unpinned = 0, normal = 0;
+    for (int i = 0; i < helperCount; i++) {
+        helpers.emplace_back(&VoiceWorkers::run, this, i + 1);
+        // core 0 is left to the device thread and the UI
+        unpinned += !pinToCore(helpers.back(), (unsigned)(i + 1));
+        normal += !raiseToRealtime(helpers.back());
+    }
+    if (unpinned || normal)
+        std::cerr << "[Voices] " << helperCount << " helper threads: " << unpinned << " not pinned, "
+                  << normal << " at normal priority\n";
+}
+
+VoiceWorkers::~VoiceWorkers() {
+    running.store(false);
+    chunk.fetch_add(1);
+    chunk.notify_all();
+    for (auto& t : helpers) t.join();
+}
+
+// Marginal cost per sounding key, from AVA_VoiceBench (app/VoiceBench.cpp).
+// Every key pays ~300 µs/s in Key::render (envelope, gain stage) on top of
+// its source; the governor's cheaper steps are scaled by eye.
+float VoiceWorkers::estimateCost(const Key& k, bool hasVoice) {
+    if (!k.isActive()) return hasVoice ? 50.0f : 5.0f;
+    switch (k.source) {
+        case Key::Physical:
+            return 300.0f + (k.voiceModel >= 0 && k.voiceModel < PhysicalModelCount
+                             ? physicalModels[k.voiceModel].costUs : 0.0f);
+        case Key::Additive:
+            return k.lowHarmonics ? 600.0f : 950.0f;
+        case Key::Wavetable:
+            return (k.skipDetune ? 550.0f : 950.0f) * (k.morphLayers > 1 && !k.lowHarmonics ? 1.3f : 1.0f);
+        default:
+            return k.skipDetune ? 600.0f : 1050.0f;
+    }
+}
+
+void VoiceWorkers::add(Key* k, VoiceSource* voice) {
+    if (count == MaxKeys) return;   // the engine renders longer key lists itself
+    const float cost = estimateCost(*k, voice != nullptr);
+    list[count++] = { k, voice, cost };
+    totalCost += cost;
+}
+
+void VoiceWorkers::renderLane(Lane& lane, unsigned n) {
+    std::fill(lane.acc, lane.acc + n, 0.0f);
+    for (int j = 0; j < lane.count; j++) {
+        const Item& it = list[lane.items[j]];
+        Key& k = *it.key;
+        if (it.voice) {
+            it.voice->render(k.voiceBlock, n);
+            k.voiceFrames = (int)n;
+        } else if (k.source == Key::Wavetable) {
+            k.renderTable(n, sampleRate);
+        }
+        k.render(lane.acc, n, sampleRate, clock);
+    }
+}
+
+bool VoiceWorkers::render(float* out, unsigned n, uint64_t chunkClock) {
+    n = std::min(n, MaxFrames);
+    clock = chunkClock;
+    const int threadCount = helperCount + 1;
+
+    // light chunk: the callback alone, in key order
+    if (helperCount == 0 || totalCost < minCost || count < 2) {
+        Lane& lane = lanes[0];
+        lane.count = count;
+        for (int i = 0; i < count; i++) lane.items[i] = i;
+        renderLane(lane, n);
+        std::copy(lane.acc, lane.acc + n, out);
+        serialChunks.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // longest first, each to the least loaded lane
+    for (int i = 0; i < count; i++) order[i] = i;
+    std::sort(order, order + count, [&](int a, int b) { return list[a].cost > list[b].cost; });
+    for (int t = 0; t < threadCount; t++) {
+        lanes[t].count = 0;
+        lanes[t].load = 0.0f;
+    }
+    for (int i = 0; i < count; i++) {
+        int best = 0;
+        for (int t = 1; t < threadCount; t++)
+            if (lanes[t].load < lanes[best].load) best = t;
+        Lane& lane = lanes[best];
+        lane.items[lane.count++] = order[i];
+        lane.load += list[order[i]].cost;
+    }
+
+    // go: helpers that are spinning see the counter, sleepers get a notify
+    frames = n;
+    pending.store(helperCount, std::memory_order_relaxed);
+    chunk.fetch_add(1);                                    // seq_cst: pairs with `sleeping`
+    if (sleeping.load() > 0) chunk.notify_all();
+
+    renderLane(lanes[0], n);
+    while (pending.load(std::memory_order_acquire) > 0) {}
+
+    const ava::dsp::Kernels& kn = ava::dsp::kernels();
+    std::copy(lanes[0].acc, lanes[0].acc + n, out);
+    for (int t = 1; t < threadCount; t++) kn.add(out, lanes[t].acc, n);
+    parallelChunks.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+VoiceWorkers::Stats VoiceWorkers::stats() const {
+    Stats s;
+    s.parallelChunks = parallelChunks.load(std::memory_order_relaxed);
+    s.serialChunks = serialChunks.load(std::memory_order_relaxed);
+    return s;
+}
+
+void VoiceWorkers::run(int laneIndex) {
+    Lane& lane = lanes[laneIndex];
+    unsigned seen = 0;   // the callback's first chunk may come before this line
+    for (;;) {
+        // spin while chunks keep coming (inside a callback), then sleep
+        const auto spinUntil = Clock::now() + std::chrono::microseconds(SpinUs);
+        unsigned now = seen;
+        for (int i = 0; (now = chunk.load(std::memory_order_acquire)) == seen; i++) {
+            if ((i & 255) == 255 && Clock::now() > spinUntil) {
+                sleeping.fetch_add(1);                     // seq_cst: pairs with the go store
+                chunk.wait(seen);
+                sleeping.fetch_sub(1);
+            }
+        }
+        seen = now;
+        if (!running.load()) break;
+
+        {
+            RtCheck::Scope rtScope;
+            enableDenormalFlush();
+            renderLane(lane, frames);
+        }
+        pending.fetch_sub(1, std::memory_order_release);
+    }
+}
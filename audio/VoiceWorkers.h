@@ -0,0 +1,110 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+class Key;
+
+namespace ava {
+namespace audio {
+
+class VoiceSource;
+
+// -------------------------
+// VoiceWorkers
+// -------------------------
+// Renders the keys of one engine chunk on several cores. The callback
+// collects the chunk's keys (with the physical voice each one needs
+// rendered, already acquired from its pool, which stays single-threaded),
+// then render() splits them by estimated cost: longest first, each to the
+// least loaded thread. Every thread, the callback included, renders its
+// keys (physical voice or wavetable block, then Key::render) into a
+// buffer of its own, and the callback sums the buffers. A key's render
+// touches only that key and the chunk's clock, so the parallel sum
+// differs from the serial one by summation order alone.
+//
+// Helpers are pinned one per core and spin on the chunk counter between
+// chunks, so starting a chunk is one store; after SpinUs without work
+// (between callbacks) they sleep on it instead, and the callback wakes
+// them only when one is asleep. Nothing is allocated or locked per chunk.
+//
+// Below minCost (µs of CPU per second of audio; the default, 150000, is
+// 15% of a core) the callback renders everything itself, in key order:
+// the same sum as the single-threaded engine, and no helper is woken.
+class VoiceWorkers {
+public:
+    static constexpr int      MaxThreads = 8;     // helpers + the callback
+    static constexpr int      MaxKeys = 512;      // longer key lists don't use the pool
+    static constexpr unsigned MaxFrames = 64;     // Key::VoiceBlockFrames
+    static constexpr int      SpinUs = 500;
+
+    // `helpers` threads besides the callback's, at most one per other core.
+    VoiceWorkers(int helpers, double sampleRate);
+    ~VoiceWorkers();
+
+    VoiceWorkers(const VoiceWorkers&) = delete;
+    VoiceWorkers& operator=(const VoiceWorkers&) = delete;
+
+    int threads() const { return helperCount + 1; }
+    void setMinCost(float usPerSecond) { minCost = usPerSecond; }
+
+    // --- Audio thread, per chunk ---
+    void clear() { count = 0; totalCost = 0.0f; }
+    // voice: what renderVoice() would render into k.voiceBlock this chunk
+    void add(Key* k, VoiceSource* voice);
+    // Renders everything added and writes the mono sum of n ≤ MaxFrames
+    // frames to out; clock is the chunk's start for Key::render. False
+    // when it ran on the callback alone.
+    bool render(float* out, unsigned n, uint64_t clock);
+
+    // Rough CPU of one key, µs per second of audio (PhysicalModelInfo units).
+    static float estimateCost(const Key& k, bool hasVoice);
+
+    struct Stats {
+        uint64_t parallelChunks = 0;
+        uint64_t serialChunks = 0;
+    };
+    Stats stats() const;
+
+private:
+    struct Item {
+        Key*         key;
+        VoiceSource* voice;
+        float        cost;
+    };
+
+    // per thread: its share of the chunk and where it sums it (own cache lines)
+    struct alignas(64) Lane {
+        float acc[MaxFrames];
+        int   items[MaxKeys];
+        int   count = 0;
+        float load = 0.0f;
+    };
+
+    double sampleRate;
+    int    helperCount = 0;
+    float  minCost = 150000.0f;
+
+    Item  list[MaxKeys];
+    int   count = 0;
+    float totalCost = 0.0f;
+    int   order[MaxKeys];
+    std::unique_ptr<Lane[]> lanes;
+    unsigned frames = 0;             // this chunk's n, published by `chunk`
+    uint64_t clock = 0;              // ... and its Key::render clock
+
+    alignas(64) std::atomic<unsigned> chunk{0};     // callback → helpers
+    alignas(64) std::atomic<int>      pending{0};   // helpers still rendering
+    alignas(64) std::atomic<int>      sleeping{0};
+    std::atomic<bool> running{true};
+    std::atomic<uint64_t> parallelChunks{0}, serialChunks{0};
+    std::vector<std::thread> helpers;
+
+    void renderLane(Lane& lane, unsigned n);
+    void run(int lane);
+};
+
+} // namespace audio
+} // namespace ava
@@ -0,0 +1,342 @@
+#include "SessionLog.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+static const char     kMagic[4] = {'A', 'V', 'A', 'S'};
+static const uint8_t  kVersion  = 1;
+static const size_t   kFlushAt  = 16 * 1024;
+
+static uint64_t zigzag(int64_t v)   { return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63); }
+static int64_t  unzigzag(uint64_t v) { return (int64_t)(v >> 1) ^ -(int64_t)(v & 1); }
+
+static uint16_t quantize(float v) {
+    return (uint16_t)std::lrint(std::clamp(v, 0.0f, 1.0f) * 65535.0f);
+}
+
+// -------------------------
+// SessionEvent
+// -------------------------
+SDL_Event SessionEvent::toSDL() const {
+    SDL_Event e;
+    std::memset(&e, 0, sizeof(e));
+    switch (type) {
+        case FingerDown:   e.type = SDL_FINGERDOWN;   break;
+        case FingerMotion: e.type = SDL_FINGERMOTION; break;
+        case FingerUp:     e.type = SDL_FINGERUP;     break;
+        default:           e.type = SDL_USEREVENT;    return e;
+    }
+    e.tfinger.timestamp = timeMs;
+    e.tfinger.fingerId  = (SDL_FingerID)fingerId;
+    e.tfinger.x         = x;
+    e.tfinger.y         = y;
+    e.tfinger.pressure  = pressure;
+    return e;
+}
+
+// -------------------------
+// SessionWriter
+// -------------------------
+SessionWriter::~SessionWriter() {
+    close();
+}
+
+bool SessionWriter::open(const std::string& requested) {
+    close();
+
+    std::string p = requested;
+    if (p.empty()) {
+        char stamp[32];
+        std::time_t now = std::time(nullptr);
+        std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", std::localtime(&now));
+        p = (fs::path("sessions") / ("ava-" + std::string(stamp) + ".avs")).string();
+    }
+    std::error_code ec;
+    fs::path parent = fs::path(p).parent_path();
+    if (!parent.empty()) fs::create_directories(parent, ec);
+
+    file = std::fopen(p.c_str(), "wb");
+    if (!file) {
+        std::cerr << "[Session] cannot open " << p << "\n";
+        return false;
+    }
+    filePath = p;
+    written = 0;
+    started = false;
+    std::fill(std::begin(lastParam), std::end(lastParam), NAN);
+
+    buf.clear();
+    buf.reserve(kFlushAt * 2);
+    for (char c : kMagic) u8((uint8_t)c);
+    u8(kVersion);
+
+    std::cout << "[Session] logging to " << p << "\n";
+    return true;
+}
+
+void SessionWriter::close() {
+    if (!file) return;
+    flush();
+    std::fclose(file);
+    file = nullptr;
+    std::cout << "[Session] closed " << filePath << " (" << written << " bytes)\n";
+}
+
+void SessionWriter::flush() {
+    if (!file || buf.empty()) return;
+    written += std::fwrite(buf.data(), 1, buf.size(), file);
+    std::fflush(file);
+    buf.clear();
+}
+
+void SessionWriter::begin(SessionEvent::Type type, uint32_t nowMs) {
+    if (!started) {
+        started = true;
+        lastMs = nowMs;
+    }
+    // pushed events can carry a slightly older stamp than a param logged
+    // earlier in the frame: keep time monotonic rather than going negative
+    nowMs = std::max(nowMs, lastMs);
+    u8(type);
+    varint(nowMs - lastMs);
+    lastMs = nowMs;
+}
+
+void SessionWriter::finger(const SDL_TouchFingerEvent& f) {
+    if (!file) return;
+    SessionEvent::Type t;
+    switch (f.type) {
+        case SDL_FINGERDOWN:   t = SessionEvent::FingerDown;   break;
+        case SDL_FINGERMOTION: t = SessionEvent::FingerMotion; break;
+        case SDL_FINGERUP:     t = SessionEvent::FingerUp;     break;
+        default: return;
+    }
+    begin(t, f.timestamp);
+    varint(zigzag((int64_t)f.fingerId));
+    u16(quantize(f.x));
+    u16(quantize(f.y));
+    u16(quantize(f.pressure));
+    if (buf.size() >= kFlushAt) flush();
+}
+
+void SessionWriter::window(uint32_t nowMs, int w, int h) {
+    if (!file) return;
+    begin(SessionEvent::Window, nowMs);
+    varint((uint64_t)std::max(0, w));
+    varint((uint64_t)std::max(0, h));
+}
+
+void SessionWriter::mode(uint32_t nowMs, const std::string& name,
+                         const std::vector<double>& ratios,
+                         const std::vector<std::string>& labels) {
+    if (!file) return;
+    begin(SessionEvent::ModeChange, nowMs);
+    str(name);
+    varint(ratios.size());
+    for (double r : ratios) f64(r);
+    varint(labels.size());
+    for (const auto& l : labels) str(l);
+    flush();   // rare and worth keeping if we crash right after
+}
+
+void SessionWriter::waveform(uint32_t nowMs, const std::string& name,
+                             const std::string& real, const std::string& imag) {
+    if (!file) return;
+    begin(SessionEvent::WaveformChange, nowMs);
+    str(name);
+    str(real);
+    str(imag);
+    flush();
+}
+
+void SessionWriter::param(uint32_t nowMs, uint8_t id, float value) {
+    if (!file || id >= SessionEvent::ParamCount) return;
+    if (lastParam[id] == value) return;      // NaN at start → always logged once
+    lastParam[id] = value;
+    begin(SessionEvent::Param, nowMs);
+    u8(id);
+    f32(value);
+}
+
+void SessionWriter::u16(uint16_t v) {
+    u8((uint8_t)(v & 0xFF));
+    u8((uint8_t)(v >> 8));
+}
+
+void SessionWriter::varint(uint64_t v) {
+    while (v >= 0x80) {
+        u8((uint8_t)(v | 0x80));
+        v >>= 7;
+    }
+    u8((uint8_t)v);
+}
+
+void SessionWriter::f32(float v) {
+    uint32_t bits;
+    std::memcpy(&bits, &v, 4);
+    for (int i = 0; i < 4; i++) u8((uint8_t)(bits >> (8 * i)));
+}
+
+void SessionWriter::f64(double v) {
+    uint64_t bits;
+    std::memcpy(&bits, &v, 8);
+    for (int i = 0; i < 8; i++) u8((uint8_t)(bits >> (8 * i)));
+}
+
+void SessionWriter::str(const std::string& s) {
+    varint(s.size());
+    buf.insert(buf.end(), s.begin(), s.end());
+}
+
+// -------------------------
+// SessionReader
+// -------------------------
+namespace {
+struct Cursor {
+    const uint8_t* p;
+    const uint8_t* end;
+    bool ok = true;
+
+    bool need(size_t n) {
+        if ((size_t)(end - p) < n) ok = false;
+        return ok;
+    }
+    uint8_t u8() { return need(1) ? *p++ : 0; }
+    uint16_t u16() {
+        if (!need(2)) return 0;
+        uint16_t v = (uint16_t)(p[0] | (p[1] << 8));
+        p += 2;
+        return v;
+    }
+    uint64_t varint() {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (!need(1)) return 0;
+            uint8_t b = *p++;
+            v |= (uint64_t)(b & 0x7F) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        ok = false;
+        return 0;
+    }
+    float f32() {
+        if (!need(4)) return 0.0f;
+        uint32_t bits = 0;
+        for (int i = 0; i < 4; i++) bits |= (uint32_t)p[i] << (8 * i);
+        p += 4;
+        float v;
+        std::memcpy(&v, &bits, 4);
+        return v;
+    }
+    double f64() {
+        if (!need(8)) return 0.0;
+        uint64_t bits = 0;
+        for (int i = 0; i < 8; i++) bits |= (uint64_t)p[i] << (8 * i);
+        p += 8;
+        double v;
+        std::memcpy(&v, &bits, 8);
+        return v;
+    }
+    std::string str() {
+        uint64_t n = varint();
+        if (!need(n)) return {};
+        std::string s((const char*)p, (size_t)n);
+        p += n;
+        return s;
+    }
+    // element counts come from the file: never trust them past what is left
+    size_t count(size_t minBytesEach) {
+        uint64_t n = varint();
+        if (n > (uint64_t)(end - p) / std::max<size_t>(1, minBytesEach)) {
+            ok = false;
+            return 0;
+        }
+        return (size_t)n;
+    }
+};
+} // namespace
+
+bool SessionReader::read(const std::string& path, std::vector<SessionEvent>& out) {
+    out.clear();
+
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) {
+        std::cerr << "[Session] cannot open " << path << "\n";
+        return false;
+    }
+    std::vector<uint8_t> data;
+    uint8_t chunk[1 << 16];
+    size_t n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), f)) > 0)
+        data.insert(data.end(), chunk, chunk + n);
+    std::fclose(f);
+
+    if (data.size() < 5 || std::memcmp(data.data(), kMagic, 4) != 0) {
+        std::cerr << "[Session] " << path << " is not a session log\n";
+        return false;
+    }
+    if (data[4] != kVersion) {
+        std::cerr << "[Session] " << path << ": unsupported version " << (int)data[4] << "\n";
+        return false;
+    }
+
+    Cursor c{data.data() + 5, data.data() + data.size()};
+    uint32_t t = 0;
+    while (c.p < c.end) {
+        SessionEvent ev;
+        uint8_t type = c.u8();
+        t += (uint32_t)c.varint();
+        ev.timeMs = t;
+
+        switch (type) {
+            case SessionEvent::FingerDown:
+            case SessionEvent::FingerMotion:
+            case SessionEvent::FingerUp:
+                ev.fingerId = unzigzag(c.varint());
+                ev.x        = c.u16() / 65535.0f;
+                ev.y        = c.u16() / 65535.0f;
+                ev.pressure = c.u16() / 65535.0f;
+                break;
+            case SessionEvent::Window:
+                ev.w = (int)c.varint();
+                ev.h = (int)c.varint();
+                break;
+            case SessionEvent::ModeChange: {
+                ev.name = c.str();
+                ev.ratios.resize(c.count(8));
+                for (auto& r : ev.ratios) r = c.f64();
+                ev.labels.resize(c.count(1));
+                for (auto& l : ev.labels) l = c.str();
+                break;
+            }
+            case SessionEvent::WaveformChange:
+                ev.name = c.str();
+                ev.real = c.str();
+                ev.imag = c.str();
+                break;
+            case SessionEvent::Param:
+                ev.param = c.u8();
+                ev.value = c.f32();
+                break;
+            default:
+                c.ok = false;
+                break;
+        }
+        if (!c.ok) {
+            std::cerr << "[Session] " << path << ": truncated or corrupt after "
+                      << out.size() << " records, keeping those\n";
+            break;
+        }
+        ev.type = (SessionEvent::Type)type;
+        out.push_back(std::move(ev));
+    }
+
+    std::cout << "[Session] read " << out.size() << " records from " << path
+              << " (" << (out.empty() ? 0 : out.back().timeMs) / 1000.0 << " s)\n";
+    return true;
+}
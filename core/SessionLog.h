@@ -0,0 +1,155 @@
+#pragma once
+#include <SDL.h>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// -------------------------
+// Session log
+// -------------------------
+// Compact binary capture of a performance: every finger event, mode change,
+// waveform change, panel slider move and improviser toggle, so the same
+// input can be fed back through Keyboard/AudioEngine later (AVA_C --replay,
+// or AVA_Render offline).
+//
+// File layout (little endian):
+//   "AVAS" u8 version
+//   record*: u8 type, varint dt (ms since the previous record), payload
+//     finger      varint zigzag(fingerId), u16 x, u16 y, u16 pressure (0..1 → 0..65535)
+//     window      varint w, varint h
+//     mode        str name, varint n, f64 ratio * n, varint n, str label * n
+//     waveform    str name, str real, str imag   (real/imag only for "Custom")
+//     param       u8 id, f32 value (sliders: raw 0..1; Improviser: seed, 0 = off;
+//                 ReverbTier: 0..2)
+//   str = varint length + UTF-8 bytes
+//
+// A typical finger record is 9-10 bytes, so an hour of dense playing stays
+// in the low megabytes.
+struct SessionEvent {
+    enum Type : uint8_t {
+        FingerDown = 1, FingerMotion, FingerUp,
+        Window, ModeChange, WaveformChange, Param
+    };
+    // panel sliders, logged as raw values so the replay goes through the
+    // same enabled()/scaledValue() mapping as the live panel
+    enum ParamId : uint8_t {
+        TremoloRate, TremoloDepth, ReverbDecay, ReverbMix, RoomSize,
+        Improviser,     // plays inside the engine: logged as its seed, not as touches
+        ReverbTier,     // panel quality tier, 0..2
+        ParamCount
+    };
+
+    Type     type = FingerDown;
+    uint32_t timeMs = 0;            // since the first record
+
+    // finger
+    int64_t  fingerId = 0;
+    float    x = 0.0f, y = 0.0f, pressure = 0.0f;
+
+    // window
+    int w = 0, h = 0;
+
+    // param
+    uint8_t param = 0;
+    float   value = 0.0f;
+
+    // mode / waveform
+    std::string name, real, imag;
+    std::vector<double> ratios;
+    std::vector<std::string> labels;
+
+    bool isFinger() const { return type >= FingerDown && type <= FingerUp; }
+
+    // Finger records as the SDL event the keyboard expects.
+    SDL_Event toSDL() const;
+};
+
+// -------------------------
+// SessionWriter
+// -------------------------
+// Main-thread only. Records are buffered and written in 16 KB chunks; close()
+// (or the destructor) flushes the rest.
+class SessionWriter {
+public:
+    SessionWriter() = default;
+    ~SessionWriter();
+
+    SessionWriter(const SessionWriter&) = delete;
+    SessionWriter& operator=(const SessionWriter&) = delete;
+
+    // path = "" → sessions/ava-YYYYmmdd-HHMMSS.avs
+    bool open(const std::string& path = "");
+    void close();
+    bool isOpen() const { return file != nullptr; }
+    const std::string& path() const { return filePath; }
+
+    // nowMs is SDL_GetTicks() (finger events carry their own timestamp)
+    void finger(const SDL_TouchFingerEvent& f);
+    void window(uint32_t nowMs, int w, int h);
+    void mode(uint32_t nowMs, const std::string& name,
+              const std::vector<double>& ratios,
+              const std::vector<std::string>& labels);
+    void waveform(uint32_t nowMs, const std::string& name,
+                  const std::string& real = "", const std::string& imag = "");
+    // Only writes when the value differs from the last one logged for id.
+    void param(uint32_t nowMs, uint8_t id, float value);
+
+    uint64_t bytesWritten() const { return written + buf.size(); }
+
+private:
+    std::FILE* file = nullptr;
+    std::string filePath;
+    std::vector<uint8_t> buf;
+    uint64_t written = 0;
+
+    bool     started = false;
+    uint32_t lastMs = 0;
+    float    lastParam[SessionEvent::ParamCount];
+
+    void begin(SessionEvent::Type type, uint32_t nowMs);
+    void u8(uint8_t v) { buf.push_back(v); }
+    void u16(uint16_t v);
+    void varint(uint64_t v);
+    void f32(float v);
+    void f64(double v);
+    void str(const std::string& s);
+    void flush();
+};
+
+// -------------------------
+// SessionReader
+// -------------------------
+class SessionReader {
+public:
+    // Parses the whole file. A truncated tail (crash while playing) is
+    // dropped with a warning; everything before it is kept.
+    static bool read(const std::string& path, std::vector<SessionEvent>& out);
+};
+
+// -------------------------
+// SessionPlayer
+// -------------------------
+// Real-time pacing for a parsed log: poll() once per frame with the current
+// SDL_GetTicks() and it hands over every event that has come due.
+class SessionPlayer {
+public:
+    explicit SessionPlayer(std::vector<SessionEvent> events)
+        : events(std::move(events)) {}
+
+    void start(uint32_t nowMs) { startMs = nowMs; next = 0; }
+    bool done() const { return next >= events.size(); }
+    uint32_t lengthMs() const { return events.empty() ? 0 : events.back().timeMs; }
+
+    template <typename Fn>
+    void poll(uint32_t nowMs, Fn&& fn) {
+        const uint32_t t = nowMs - startMs;
+        while (next < events.size() && events[next].timeMs <= t)
+            fn(events[next++]);
+    }
+
+private:
+    std::vector<SessionEvent> events;
+    size_t next = 0;
+    uint32_t startMs = 0;
+};
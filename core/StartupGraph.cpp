@@ -0,0 +1,183 @@
+#include "StartupGraph.h"
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <thread>
+
+StartupGraph::StartupGraph() : t0(Clock::now()) {}
+
+int StartupGraph::add(const std::string& name, Task fn,
+                      const std::vector<int>& deps, Lane lane) {
+    Phase p;
+    p.name = name;
+    p.fn = std::move(fn);
+    p.deps = deps;
+    p.lane = lane;
+    int id = (int)phases.size();
+    for (int d : deps) {
+        if (d < 0 || d >= id) {
+            // ids are handed out in order, so a forward/unknown id is a typo
+            std::cerr << "[Startup] phase '" << name << "' has invalid dependency " << d << "\n";
+            continue;
+        }
+        phases[d].dependents.push_back(id);
+        p.pendingDeps++;
+    }
+    phases.push_back(std::move(p));
+    return id;
+}
+
+double StartupGraph::elapsedMs() const {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+void StartupGraph::mark(const std::string& milestone) const {
+    std::printf("[Startup] %s at %.1f ms\n", milestone.c_str(), elapsedMs());
+}
+
+bool StartupGraph::ok(int id) const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return id >= 0 && id < (int)phases.size() && phases[id].state == Done;
+}
+
+bool StartupGraph::hasReady(Lane lane) const {
+    for (auto& p : phases)
+        if (p.state == Ready && p.lane == lane) return true;
+    return false;
+}
+
+int StartupGraph::takeReady(Lane lane) {
+    for (int i = 0; i < (int)phases.size(); i++) {
+        if (phases[i].state == Ready && phases[i].lane == lane) {
+            phases[i].state = Running;
+            return i;
+        }
+    }
+    return -1;
+}
+
+void StartupGraph::execute(int id) {
+    Phase& p = phases[id];   // fn/name are not touched by other threads once running
+    double start = elapsedMs();
+    bool success = false;
+    std::string error;
+    try {
+        success = p.fn ? p.fn() : true;
+    } catch (const std::exception& ex) {
+        error = ex.what();
+    } catch (...) {
+        error = "unknown exception";
+    }
+    double dur = elapsedMs() - start;
+
+    std::lock_guard<std::mutex> lock(mtx);
+    p.startMs = start;
+    p.durMs = dur;
+    p.error = error;
+    finish(id, success);
+}
+
+void StartupGraph::finish(int id, bool success) {
+    Phase& p = phases[id];
+    p.state = success ? Done : Failed;
+    unfinished--;
+
+    if (!success) {
+        skipDependents(id);
+    } else {
+        for (int d : p.dependents) {
+            if (phases[d].state == Waiting && --phases[d].pendingDeps == 0)
+                phases[d].state = Ready;
+        }
+    }
+    cv.notify_all();
+}
+
+void StartupGraph::skipDependents(int id) {
+    for (int d : phases[id].dependents) {
+        if (phases[d].state != Waiting) continue;
+        phases[d].state = Skipped;
+        unfinished--;
+        skipDependents(d);
+    }
+}
+
+bool StartupGraph::run(unsigned workers) {
+    int poolPhases = 0;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        unfinished = (int)phases.size();
+        for (auto& p : phases) {
+            if (p.lane == Pool) poolPhases++;
+            if (p.state == Waiting && p.pendingDeps == 0) p.state = Ready;
+        }
+    }
+
+    if (workers == 0) workers = std::max(2u, std::thread::hardware_concurrency());
+    workers = std::min<unsigned>(workers, (unsigned)poolPhases);
+
+    std::vector<std::thread> pool;
+    for (unsigned w = 0; w < workers; w++) {
+        pool.emplace_back([this] {
+            for (;;) {
+                int id;
+                {
+                    std::unique_lock<std::mutex> lock(mtx);
+                    cv.wait(lock, [&] {
+                        return unfinished == 0 || hasReady(Pool);
+                    });
+                    if (unfinished == 0) return;
+                    id = takeReady(Pool);
+                }
+                execute(id);
+            }
+        });
+    }
+
+    // Main lane: this thread
+    for (;;) {
+        int id;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [&] { return unfinished == 0 || hasReady(Main); });
+            if (unfinished == 0) break;
+            id = takeReady(Main);
+        }
+        execute(id);
+    }
+
+    for (auto& t : pool) t.join();
+
+    report();
+
+    std::lock_guard<std::mutex> lock(mtx);
+    for (auto& p : phases)
+        if (p.state != Done) return false;
+    return true;
+}
+
+void StartupGraph::report() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    double serial = 0.0, end = 0.0;
+    for (auto& p : phases) {
+        const char* lane = p.lane == Main ? "main" : "pool";
+        switch (p.state) {
+            case Done:
+                std::printf("[Startup] %-14s %s  +%7.1f ms  %7.1f ms\n",
+                            p.name.c_str(), lane, p.startMs, p.durMs);
+                break;
+            case Failed:
+                std::printf("[Startup] %-14s %s  +%7.1f ms  FAILED%s%s\n",
+                            p.name.c_str(), lane, p.startMs,
+                            p.error.empty() ? "" : ": ", p.error.c_str());
+                break;
+            default:
+                std::printf("[Startup] %-14s %s  skipped\n", p.name.c_str(), lane);
+                break;
+        }
+        serial += p.durMs;
+        end = std::max(end, p.startMs + p.durMs);
+    }
+    std::printf("[Startup] graph done at %.1f ms (phases sum to %.1f ms serially)\n",
+                end, serial);
+}
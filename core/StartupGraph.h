@@ -0,0 +1,78 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// -------------------------
+// StartupGraph
+// -------------------------
+// Startup as a small dependency graph instead of one long serial block.
+//
+//   StartupGraph boot;
+//   int cat = boot.add("catalog", loadCatalog);
+//   int gl  = boot.add("gl", initWindow, {}, StartupGraph::Main);
+//   boot.add("keyboard", buildKeyboard, {cat, gl}, StartupGraph::Main);
+//   boot.run();
+//
+// Pool phases run concurrently on worker threads; Main phases run on the
+// thread that calls run() (SDL windows and the GL context must stay there).
+// A phase returns false (or throws) to fail; everything depending on it is
+// skipped. Each phase's start/duration is logged when run() returns.
+class StartupGraph {
+public:
+    using Task = std::function<bool()>;
+    enum Lane { Pool, Main };
+
+    StartupGraph();
+
+    // Returns the phase id to use in other phases' dependency lists.
+    int add(const std::string& name, Task fn,
+            const std::vector<int>& deps = {}, Lane lane = Pool);
+
+    // Runs every phase; true if all of them succeeded.
+    // workers = 0 → one per hardware thread, at least 2 since phases like the
+    // device open mostly wait (capped by the number of pool phases).
+    bool run(unsigned workers = 0);
+
+    bool ok(int id) const;
+
+    // Milliseconds since the graph was created (i.e. since process start, roughly).
+    double elapsedMs() const;
+
+    // Log a one-off moment such as "first sound" against the same clock.
+    void mark(const std::string& milestone) const;
+
+private:
+    enum State { Waiting, Ready, Running, Done, Failed, Skipped };
+
+    struct Phase {
+        std::string name;
+        Task fn;
+        std::vector<int> deps;
+        std::vector<int> dependents;
+        Lane lane = Pool;
+        State state = Waiting;
+        int pendingDeps = 0;
+        double startMs = 0.0;
+        double durMs = 0.0;
+        std::string error;
+    };
+
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point t0;
+
+    std::vector<Phase> phases;
+    mutable std::mutex mtx;
+    std::condition_variable cv;
+    int unfinished = 0;
+
+    bool hasReady(Lane lane) const;            // caller holds mtx
+    int  takeReady(Lane lane);                 // caller holds mtx
+    void execute(int id);                      // runs without mtx
+    void finish(int id, bool success);         // caller holds mtx
+    void skipDependents(int id);               // caller holds mtx
+    void report() const;
+};
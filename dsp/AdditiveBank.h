@@ -0,0 +1,204 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+
+
+namespace ava::dsp {
+
+
+// -------------------------
+// AdditiveBank
+// -------------------------
+// Per-voice bank of harmonic partials (same idea as daisysp::HarmonicOscillator,
+// but with per-partial amplitude ramps and any phase per partial).
+//
+// Each partial is a unit phasor rotated once per sample (4 mul + 2 add), stored
+// structure-of-arrays and summed into Lanes independent accumulators so the
+// partial loop auto-vectorizes without -ffast-math. The phasor radius is
+// re-normalised once per block, which keeps it stable indefinitely in float.
+//
+// Partials at or above the Nyquist guard for the current frequency ramp to 0
+// and are then skipped, so a voice never aliases when it is retuned upward.
+template <int MaxPartials = 32>
+class AdditiveBank {
+public:
+static constexpr int Lanes = 8;
+static constexpr int Capacity = (MaxPartials + Lanes - 1) / Lanes * Lanes;
+
+
+AdditiveBank() {
+for (int k = 0; k < Capacity; k++) gain_[k] = 1.0f;
+init(sampleRate_);
+}
+
+void init(double sampleRate) {
+sampleRate_ = (sampleRate > 0.0 ? sampleRate : 48000.0);
+for (int k = 0; k < Capacity; k++) {
+re_[k] = 1.0f; im_[k] = 0.0f;
+cosw_[k] = 1.0f; sinw_[k] = 0.0f;
+amp_[k] = 0.0f; inc_[k] = 0.0f; target_[k] = 0.0f;
+base_[k] = 0.0f;
+logk_[k] = std::log2((float)(k + 1));
+}
+active_ = 0;
+setFrequency(freq_);
+}
+
+// Spectrum shape: amps[k] / phases[k] for harmonic k+1 (extra entries ignored).
+void setSpectrum(const float* amps, const float* phases, int count) {
+count = std::min(count, MaxPartials);
+numPartials_ = count;
+for (int k = 0; k < Capacity; k++) {
+base_[k] = (k < count ? amps[k] : 0.0f);
+float phi = (k < count && phases ? phases[k] : 0.0f);
+// output is the imaginary part: sin(k w n + phi)
+re_[k] = std::cos(phi);
+im_[k] = std::sin(phi);
+}
+applyTargets();
+}
+
+void setFrequency(double hz) {
+freq_ = (hz > 1e-6 ? hz : 1e-6);
+const double w = 2.0 * M_PI * freq_ / sampleRate_;
+const double limit = nyquistGuard * 0.5 * sampleRate_;
+
+// cos/sin(k w) by rotation, once per retune
+double c1 = std::cos(w), s1 = std::sin(w);
+double ck = c1, sk = s1;
+audible_ = 0;
+for (int k = 0; k < Capacity; k++) {
+cosw_[k] = (float)ck;
+sinw_[k] = (float)sk;
+if (k < numPartials_ && (k + 1) * freq_ < limit) audible_ = k + 1;
+double cn = ck * c1 - sk * s1;
+sk = sk * c1 + ck * s1;
+ck = cn;
+}
+applyTargets();
+}
+
+// Spectral tilt in octaves: partial k is scaled by (k+1)^-tilt.
+// 0 = spectrum as given, >0 darker, <0 brighter.
+void setTilt(float tilt) {
+if (tilt == tilt_) return;
+tilt_ = tilt;
+applyTargets();
+}
+
+// Direct per-partial control (0..1 of the spectrum amplitude), for expression.
+void setPartialGain(int k, float g) {
+if (k < 0 || k >= MaxPartials) return;
+gain_[k] = g;
+applyTargets();
+}
+
+// Highest partial that may sound (quality governor: fewer partials, less
+// work once the ramp down is over). MaxPartials = no limit.
+void setPartialLimit(int n) {
+n = std::clamp(n, 1, MaxPartials);
+if (n == limit_) return;
+limit_ = n;
+applyTargets();
+}
+
+// Samples over which amplitude changes are ramped (click-free retuning).
+void setRampSamples(int n) { rampSamples_ = std::max(1, n); }
+
+float process() {
+float acc[Lanes] = {};
+const int n = active_;
+for (int g = 0; g < n; g += Lanes) {
+for (int j = 0; j < Lanes; j++) {
+const int k = g + j;
+float re = re_[k] * cosw_[k] - im_[k] * sinw_[k];
+float im = re_[k] * sinw_[k] + im_[k] * cosw_[k];
+re_[k] = re;
+im_[k] = im;
+acc[j] += amp_[k] * im;
+amp_[k] += inc_[k];
+}
+}
+if (rampLeft_ > 0 && --rampLeft_ == 0) endRamp();
+if (++sinceNorm_ >= normInterval) renormalise();
+
+float y = 0.0f;
+for (int j = 0; j < Lanes; j++) y += acc[j];
+return y;
+}
+
+// Adds n samples into out.
+void process(float* out, int n) {
+for (int i = 0; i < n; i++) out[i] += process();
+}
+
+int audiblePartials() const { return audible_; }
+int activePartials() const { return active_; }
+
+
+private:
+static constexpr double nyquistGuard = 0.9;
+static constexpr int normInterval = 256;
+
+void applyTargets() {
+int last = 0;
+for (int k = 0; k < Capacity; k++) {
+float t = 0.0f;
+if (k < audible_ && k < limit_) t = base_[k] * gain_[k] * std::exp2(-tilt_ * logk_[k]);
+target_[k] = t;
+inc_[k] = (t - amp_[k]) / (float)rampSamples_;
+if (t != 0.0f || amp_[k] != 0.0f) last = k + 1;
+}
+rampLeft_ = rampSamples_;
+// round up to whole lanes; the padding partials have zero amplitude
+active_ = std::min(Capacity, (last + Lanes - 1) / Lanes * Lanes);
+}
+
+void endRamp() {
+int last = 0;
+for (int k = 0; k < Capacity; k++) {
+amp_[k] = target_[k];
+inc_[k] = 0.0f;
+if (amp_[k] != 0.0f) last = k + 1;
+}
+active_ = std::min(Capacity, (last + Lanes - 1) / Lanes * Lanes);
+}
+
+void renormalise() {
+sinceNorm_ = 0;
+const int n = active_;
+for (int k = 0; k < n; k++) {
+// first-order 1/sqrt(r^2) around r = 1
+float r2 = re_[k] * re_[k] + im_[k] * im_[k];
+float s = 1.5f - 0.5f * r2;
+re_[k] *= s;
+im_[k] *= s;
+}
+}
+
+double sampleRate_ = 48000.0;
+double freq_ = 440.0;
+int numPartials_ = 0;
+int audible_ = 0;
+int limit_ = MaxPartials;
+int active_ = 0;
+int rampSamples_ = 256;
+int rampLeft_ = 0;
+int sinceNorm_ = 0;
+float tilt_ = 0.0f;
+
+alignas(32) float re_[Capacity];
+alignas(32) float im_[Capacity];
+alignas(32) float cosw_[Capacity];
+alignas(32) float sinw_[Capacity];
+alignas(32) float amp_[Capacity];
+alignas(32) float inc_[Capacity];
+alignas(32) float target_[Capacity];
+alignas(32) float base_[Capacity];
+alignas(32) float logk_[Capacity];
+alignas(32) float gain_[Capacity];
+};
+
+
+} // namespace ava::dsp
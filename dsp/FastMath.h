@@ -0,0 +1,93 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+
+
+namespace ava::dsp::fast {
+
+
+// -------------------------
+// FastMath
+// -------------------------
+// Float stand-ins for the two libm calls the voice kernels make per span
+// (VoiceKernels.h): sin in the tremolo, log2 in Envelope::releaseFrames.
+// Each is a range reduction on the exponent bits or a rounding, then a
+// short minimax polynomial: no tables, no errno, and range checks done
+// on the bits as masks rather than branches, so a loop over them can
+// vectorize once they are inlined. libm is far more accurate than
+// anything audible; these are at float rounding or within a few ulps.
+//
+// What AVA_FastMathBench measures against glibc's float calls (GCC 12,
+// x86-64; > 1 is faster):
+//
+//                   plain loop -O2   plain loop -O3   one call
+//   log2              1.3-1.5x          4.5-4.8x      1.05-1.3x
+//   sin               0.9-1.2x          4.3-5.2x      0.8x
+//   tremolo kernel    1.4-1.6x          2.0-2.2x
+//
+// So sin only pays inside the tremolo kernel, which runs it over
+// Lanes-wide groups; called on its own, std::sin is faster.
+//
+// Accuracy contracts, measured against double-precision libm over the
+// whole domain by AVA_FastMathBench (which fails when one is broken):
+//
+//   log2(x)    absolute ≤ Log2AbsError + |log2 x|·ArgRounding, x > 0 normal
+//   sin(x)     absolute ≤ SinAbsError + |x|·ArgRounding
+//
+// Outside a domain the result is unspecified (no NaN/inf handling).
+inline constexpr float Log2AbsError  = 1.5e-7f;
+inline constexpr float SinAbsError   = 2.5e-7f;
+inline constexpr float ArgRounding   = 1.5e-7f;   // float rounding of a scaled argument or result
+
+namespace detail {
+
+inline float fromBits(uint32_t b) { float f; std::memcpy(&f, &b, sizeof f); return f; }
+inline uint32_t toBits(float f) { uint32_t b; std::memcpy(&b, &f, sizeof b); return b; }
+
+// x + Round - Round is x rounded to the nearest integer (ties to even)
+// for |x| < 2^22, and the low mantissa bits of x + Round hold it
+inline constexpr float Round = 12582912.0f;   // 1.5 · 2^23
+
+// all ones where c holds: bits blended with it are a select
+inline uint32_t mask(bool c) { return c ? ~0u : 0u; }
+
+} // namespace detail
+
+// log2(x) = e + log2(m) with m in [√½, √2): log2(m) = t·P(t²),
+// t = (m - 1) / (m + 1), P of degree 2.
+inline float log2(float x) {
+    using namespace detail;
+    const uint32_t b = toBits(x);
+    const uint32_t mb = (b & 0x007fffffu) | 0x3f800000u;   // m in [1, 2)
+    const bool high = mb > 0x3fb504f3u;                    // m > √2: halve it
+    const float m = fromBits(mb - (high ? 0x00800000u : 0u));
+    const int e = (int)(b >> 23) - 127 + high;
+    const float t = (m - 1.0f) / (m + 1.0f);
+    const float u = t * t;
+    return (float)e + t * (2.8853913f + u * (0.96147081f + u * 0.59897389f));
+}
+
+namespace detail {
+
+// sin(2πx): x rounded to the nearest turn, folded to a quarter period,
+// odd polynomial of degree 9.
+inline float sin2pi(float x) {
+    const float r0 = x - ((x + Round) - Round);            // [-0.5, 0.5]
+    const uint32_t sign = toBits(r0) & 0x80000000u;
+    const uint32_t wide = mask(fromBits(toBits(r0) ^ sign) > 0.25f);   // |r0| > 1/4
+    const float folded = fromBits(sign | 0x3f000000u) - r0;            // ±0.5 - r0
+    const float r = fromBits((toBits(folded) & wide) | (toBits(r0) & ~wide));
+    const float u = r * r;
+    float p = 39.536706f;
+    p = p * u - 76.549782f;
+    p = p * u + 81.601004f;
+    p = p * u - 41.341655f;
+    p = p * u + 6.2831852f;
+    return r * p;
+}
+
+} // namespace detail
+
+inline float sin(float x) { return detail::sin2pi(x * 0.159154943f); }
+
+} // namespace ava::dsp::fast
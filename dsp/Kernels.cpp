@@ -0,0 +1,299 @@
+#include "Kernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include "Effects/reverbsc.h"
+#include "Effects/reverbsc_lanes.h"
+
+#if defined(AVA_KERNELS_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace ava::dsp {
+
+#if defined(AVA_KERNELS_X86)
+// KernelsSse2.cpp, KernelsAvx2.cpp, KernelsAvx512.cpp
+extern const Kernels kernelsSse2;
+extern const Kernels kernelsAvx2;
+extern const Kernels kernelsAvx512;
+#endif
+
+Limiter::Limiter(float sampleRate, float releaseMs) {
+    std::fill(std::begin(box), std::end(box), 1.0f);
+    releaseCoef = 1.0f - std::exp(-1.0f / (releaseMs * 0.001f * sampleRate));
+}
+
+} // namespace ava::dsp
+
+using namespace ava::dsp;
+
+// -------------------------
+// Scalar reference: the loops as the engine wrote them, one sample at a time
+// -------------------------
+namespace {
+
+void addScalar(float* dst, const float* src, unsigned n) {
+    for (unsigned i = 0; i < n; i++) dst[i] += src[i];
+}
+
+void scaleScalar(float* x, float gain, unsigned n) {
+    for (unsigned i = 0; i < n; i++) x[i] *= gain;
+}
+
+void blendScalar(float* out, const float* a, float ga, const float* b, float gb, unsigned n) {
+    for (unsigned i = 0; i < n; i++) out[i] = ga * a[i] + gb * b[i];
+}
+
+float crossfadeScalar(float* dst, const float* src, float mix, float step, unsigned n) {
+    for (unsigned i = 0; i < n; i++) {
+        mix = std::clamp(mix + step, 0.0f, 1.0f);
+        dst[i] += mix * (src[i] - dst[i]);
+    }
+    return mix;
+}
+
+void interleaveScalar(float* out, const float* left, const float* right, unsigned n) {
+    for (unsigned i = 0; i < n; i++) {
+        out[i * 2 + 0] = left[i];
+        out[i * 2 + 1] = right[i];
+    }
+}
+
+void tableReadScalar(float* out, const float* table, const int32_t* index,
+                     const float* frac, int32_t stride, unsigned n) {
+    for (unsigned i = 0; i < n; i++) {
+        const float* t = table + index[i];
+        out[i] = stride ? t[0] + frac[i] * (t[stride] - t[0]) : t[0];
+    }
+}
+
+float rampGainScalar(float* x, float gain, float step, unsigned n) {
+    for (unsigned i = 0; i < n; i++) {
+        gain += step;
+        x[i] *= gain;
+    }
+    return gain;
+}
+
+float chaseGainScalar(float* x, float gain, float target, float keep, unsigned n) {
+    for (unsigned i = 0; i < n; i++) {
+        gain = target + (gain - target) * keep;
+        x[i] *= gain;
+    }
+    return gain;
+}
+
+void biquadCascadeScalar(float* left, float* right, unsigned n, BiquadCascade& c) {
+    float* io[2] = { left, right };
+    Biquad& k = c.k;
+    for (unsigned i = 0; i < n; i++) {
+        k.b0 += c.step.b0; k.b1 += c.step.b1; k.b2 += c.step.b2;
+        k.a1 += c.step.a1; k.a2 += c.step.a2;
+        for (int ch = 0; ch < 2; ch++) {
+            float x = io[ch][i];
+            for (int s = 0; s < c.stages; s++) {
+                const float y = k.b0 * x + c.s1[s][ch];
+                c.s1[s][ch] = k.b1 * x - k.a1 * y + c.s2[s][ch];
+                c.s2[s][ch] = k.b2 * x - k.a2 * y;
+                x = y;
+            }
+            io[ch][i] = x;
+        }
+    }
+}
+
+void limitScalar(float* left, float* right, unsigned n, Limiter& s, float threshold) {
+    constexpr int Lookahead = Limiter::Lookahead;
+    constexpr uint32_t Mask = Limiter::Ring - 1;
+    for (unsigned i = 0; i < n; i++) {
+        const float peak = std::max(std::abs(left[i]), std::abs(right[i]));
+        const float need = peak > threshold ? threshold / peak : 1.0f;
+        while (s.minTail != s.minHead && s.minVal[(s.minTail - 1) & Mask] >= need) s.minTail--;
+        s.minVal[s.minTail & Mask] = need;
+        s.minAt[s.minTail & Mask] = s.frame;
+        s.minTail++;
+        while (s.minAt[s.minHead & Mask] + Lookahead <= s.frame) s.minHead++;
+        const float windowMin = s.minVal[s.minHead & Mask];
+
+        s.held = windowMin < s.held ? windowMin : s.held + (windowMin - s.held) * s.releaseCoef;
+        s.boxSum += s.held - s.box[s.boxPos];
+        s.box[s.boxPos] = s.held;
+        if (++s.boxPos == Lookahead) {
+            s.boxPos = 0;
+            float sum = 0.0f;   // drop the running sum's rounding drift
+            for (float g : s.box) sum += g;
+            s.boxSum = sum;
+        }
+        const float g = std::min(s.boxSum * (1.0f / (float)Lookahead), 1.0f);
+
+        const uint32_t w = (uint32_t)s.frame & Mask;
+        const uint32_t r = (uint32_t)(s.frame - (Lookahead - 1)) & Mask;
+        s.delay[0][w] = left[i];
+        s.delay[1][w] = right[i];
+        left[i] = s.delay[0][r] * g;
+        right[i] = s.delay[1][r] * g;
+        s.frame++;
+    }
+}
+
+// One line after another, as ReverbSc::Process() does
+void reverbLanesScalar(daisysp::ReverbScLanes& s, const float* in1, const float* in2,
+                       float* out1, float* out2, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        s.feedback += (s.feedback_target - s.feedback) * s.feedback_coef;
+
+        float jp = 0.0f;
+        for (int l = 0; l < 8; l++) jp += s.filter_state[l];
+        jp *= daisysp::kJpScale;
+
+        float outL = 0.0f, outR = 0.0f;
+        for (int l = 0; l < 8; l++) {
+            const int size = s.buffer_size[l];
+            float* buf = s.buf[l];
+            buf[s.write_pos[l]] = jp + (l & 1 ? in2[i] : in1[i]) - s.filter_state[l];
+            if (++s.write_pos[l] >= size) s.write_pos[l] -= size;
+            if (s.read_pos_frac[l] >= DELAYPOS_SCALE) {
+                s.read_pos[l] += s.read_pos_frac[l] >> DELAYPOS_SHIFT;
+                s.read_pos_frac[l] &= DELAYPOS_MASK;
+            }
+            if (s.read_pos[l] >= size) s.read_pos[l] -= size;
+
+            const int r = s.read_pos[l];
+            const float vm1 = buf[r > 0 ? r - 1 : r - 1 + size];
+            const float v0 = buf[r];
+            const float v1 = buf[r + 1 < size ? r + 1 : r + 1 - size];
+            const float v2 = buf[r + 2 < size ? r + 2 : r + 2 - size];
+
+            const float frac = (float)s.read_pos_frac[l] * (1.0f / (float)DELAYPOS_SCALE);
+            float a2 = (frac * frac - 1.0f) * (1.0f / 6.0f);
+            float a1 = (frac + 1.0f) * 0.5f;
+            float am1 = a1 - 1.0f;
+            float a0 = 3.0f * a2;
+            a1 -= a0;
+            am1 -= a2;
+            a0 -= frac;
+            const float v = ((am1 * vm1 + a0 * v0 + a1 * v1 + a2 * v2) * frac + v0) * s.feedback;
+            s.filter_state[l] = (s.filter_state[l] - v) * s.damp_fact + v;
+            s.read_pos_frac[l] += s.read_pos_frac_inc[l];
+            s.line_cnt[l]--;
+
+            (l & 1 ? outR : outL) += s.filter_state[l];
+        }
+        out1[i] = outL * daisysp::kOutputGain;
+        out2[i] = outR * daisysp::kOutputGain;
+    }
+}
+
+const Kernels kernelsScalar = {
+    Isa::Scalar, "scalar",
+    addScalar, scaleScalar, blendScalar, crossfadeScalar, interleaveScalar,
+    tableReadScalar,
+    rampGainScalar, chaseGainScalar,
+    biquadCascadeScalar, limitScalar,
+    reverbLanesScalar,
+};
+
+// -------------------------
+// CPU detection
+// -------------------------
+struct Cpu {
+    bool sse2 = false, avx2 = false, fma = false, avx512f = false, avx512vl = false;
+};
+
+Cpu detectCpu() {
+    Cpu c;
+#if defined(AVA_KERNELS_X86) && defined(_MSC_VER)
+    int r[4];
+    __cpuid(r, 0);
+    const int maxLeaf = r[0];
+    __cpuid(r, 1);
+    c.sse2 = (r[3] >> 26) & 1;
+    const bool fma = (r[2] >> 12) & 1, osxsave = (r[2] >> 27) & 1, avx = (r[2] >> 28) & 1;
+    // the OS must save the ymm / zmm registers too
+    const unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+    const bool ymm = (xcr0 & 0x06) == 0x06, zmm = (xcr0 & 0xe6) == 0xe6;
+    c.fma = avx && ymm && fma;
+    if (maxLeaf >= 7) {
+        __cpuidex(r, 7, 0);
+        c.avx2 = avx && ymm && ((r[1] >> 5) & 1);
+        c.avx512f = zmm && ((r[1] >> 16) & 1);
+        c.avx512vl = zmm && ((r[1] >> 31) & 1);
+    }
+#elif defined(AVA_KERNELS_X86)
+    // GCC / Clang: libgcc's CPUID reading, which checks XGETBV as well
+    __builtin_cpu_init();
+    c.sse2 = __builtin_cpu_supports("sse2");
+    c.avx2 = __builtin_cpu_supports("avx2");
+    c.fma = __builtin_cpu_supports("fma");
+    c.avx512f = __builtin_cpu_supports("avx512f");
+    c.avx512vl = __builtin_cpu_supports("avx512vl");
+#endif
+    return c;
+}
+
+const Cpu& cpu() {
+    static const Cpu c = detectCpu();
+    return c;
+}
+
+const Kernels* active = &kernelsScalar;
+
+} // namespace
+
+const Kernels* ava::dsp::kernelsFor(Isa isa) {
+    switch (isa) {
+        case Isa::Scalar: return &kernelsScalar;
+#if defined(AVA_KERNELS_X86)
+        case Isa::Sse2:   return cpu().sse2 ? &kernelsSse2 : nullptr;
+        case Isa::Avx2:   return cpu().avx2 && cpu().fma ? &kernelsAvx2 : nullptr;
+        case Isa::Avx512: return cpu().avx512f && cpu().avx512vl && cpu().avx2 && cpu().fma
+                                 ? &kernelsAvx512 : nullptr;
+#endif
+        default:          return nullptr;
+    }
+}
+
+const char* ava::dsp::cpuFeatures() {
+    static const std::string features = [] {
+        const Cpu& c = cpu();
+        std::string s;
+        if (c.sse2) s += " sse2";
+        if (c.avx2) s += " avx2";
+        if (c.fma) s += " fma";
+        if (c.avx512f) s += " avx512f";
+        if (c.avx512vl) s += " avx512vl";
+        return s.empty() ? std::string("none") : s.substr(1);
+    }();
+    return features.c_str();
+}
+
+const Kernels& ava::dsp::selectKernels() {
+    static const Kernels* chosen = [] {
+        const Kernels* k = &kernelsScalar;
+        for (Isa isa : { Isa::Sse2, Isa::Avx2, Isa::Avx512 })
+            if (const Kernels* t = kernelsFor(isa)) k = t;
+
+        if (const char* want = std::getenv("AVA_KERNELS")) {
+            const Kernels* forced = nullptr;
+            for (Isa isa : { Isa::Scalar, Isa::Sse2, Isa::Avx2, Isa::Avx512 }) {
+                const Kernels* t = kernelsFor(isa);
+                if (t && std::strcmp(t->name, want) == 0) forced = t;
+            }
+            if (forced) k = forced;
+            else std::cerr << "[Kernels] AVA_KERNELS=" << want << " isn't available here, using " << k->name << "\n";
+        }
+
+        daisysp::ReverbSc::SetLanesKernel(k->reverbLanes);
+        std::cout << "[Kernels] " << k->name << " (cpu: " << cpuFeatures() << ")\n";
+        return k;
+    }();
+    active = chosen;
+    return *chosen;
+}
+
+const Kernels& ava::dsp::kernels() {
+    return *active;
+}
@@ -0,0 +1,119 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace daisysp { struct ReverbScLanes; }
+
+
+namespace ava::dsp {
+
+
+// -------------------------
+// Kernels
+// -------------------------
+// The engine's hot inner loops behind one table of function pointers, so
+// one binary runs the widest vector code the machine has. There is a
+// table per instruction set:
+//
+//   scalar   plain per-sample loops (Kernels.cpp): the reference the others
+//            are checked against, and the table on non-x86 builds
+//   sse2     KernelsImpl.h, written as fixed-width lane loops that the
+//   avx2     compiler vectorizes, built once per instruction set with that
+//   avx512   file's flags (KernelsSse2/Avx2/Avx512.cpp, see CMakeLists.txt)
+//
+// selectKernels() picks the widest one CPUID and the OS allow, once at
+// startup; AVA_KERNELS=scalar|sse2|avx2|avx512 in the environment forces
+// one (it falls back when the CPU can't run it). Results match the
+// scalar table to float rounding (FMA, summation order), not bit for bit.
+// AVA_KernelBench checks every table against the reference and times it.
+//
+// Recurrences (the biquads, the limiter's release, the reverb's feedback)
+// don't get wider with the vectors; the streaming kernels do.
+enum class Isa { Scalar, Sse2, Avx2, Avx512 };
+
+// Normalized by a0.
+struct Biquad { float b0 = 1, b1 = 0, b2 = 0, a1 = 0, a2 = 0; };
+
+// Stereo chain of transposed direct form II biquads sharing one set of
+// coefficients, which moves by `step` before every frame (zero: fixed).
+struct BiquadCascade {
+    static constexpr int MaxStages = 4;
+    Biquad k;
+    Biquad step{0, 0, 0, 0, 0};
+    int    stages = 1;
+    float  s1[MaxStages][2] = {}, s2[MaxStages][2] = {};   // per stage, per channel
+};
+
+// Stereo-linked lookahead peak limiter: the signal is delayed Lookahead - 1
+// frames and the gain each frame needs is taken as its minimum over that
+// window (monotonic queue), attacks at once, releases exponentially, and
+// is box-averaged over the window so it is fully down when the peak leaves
+// the delay.
+struct Limiter {
+    static constexpr int Lookahead = 72;
+    static constexpr int Ring = 128;          // ≥ Lookahead, power of two
+
+    Limiter(float sampleRate = 48000.0f, float releaseMs = 80.0f);
+
+    float    delay[2][Ring] = {};
+    float    box[Lookahead];                  // smoothed gains, averaged
+    float    boxSum = (float)Lookahead;
+    int      boxPos = 0;
+    float    held = 1.0f;                     // window minimum with release
+    float    minVal[Ring];
+    uint64_t minAt[Ring];
+    uint32_t minHead = 0, minTail = 0;
+    uint64_t frame = 0;
+    float    releaseCoef;
+};
+
+struct Kernels {
+    Isa         isa;
+    const char* name;
+
+    // --- Mixing ---
+    void  (*add)(float* dst, const float* src, unsigned n);            // dst += src
+    void  (*scale)(float* x, float gain, unsigned n);                  // x *= gain
+    // out = ga·a + gb·b; out may be a or b
+    void  (*blend)(float* out, const float* a, float ga, const float* b, float gb, unsigned n);
+    // dst += m·(src - dst) with m = mix + (i+1)·step held to 0..1; returns the last m
+    float (*crossfade)(float* dst, const float* src, float mix, float step, unsigned n);
+    void  (*interleave)(float* out, const float* left, const float* right, unsigned n);
+
+    // --- Wavetable lookup ---
+    // out[i] = t[j] + frac[i]·(t[j + stride] - t[j]) with j = index[i]: two
+    // morph layers `stride` apart; stride 0 reads one table (frac unused)
+    void (*tableRead)(float* out, const float* table, const int32_t* index,
+                      const float* frac, int32_t stride, unsigned n);
+
+    // --- Envelope segments, applied to x in place ---
+    // linear: gain + (i+1)·step; returns gain + n·step
+    float (*rampGain)(float* x, float gain, float step, unsigned n);
+    // exponential: g ← target + (g - target)·keep before every frame; returns the last g
+    float (*chaseGain)(float* x, float gain, float target, float keep, unsigned n);
+
+    // --- Filters and dynamics, stereo, in place ---
+    void (*biquadCascade)(float* left, float* right, unsigned n, BiquadCascade& c);
+    void (*limit)(float* left, float* right, unsigned n, Limiter& s, float threshold);
+
+    // --- Reverb lines: daisysp::ReverbSc::ProcessBlock's loop ---
+    void (*reverbLanes)(daisysp::ReverbScLanes& s, const float* in1, const float* in2,
+                        float* out1, float* out2, size_t n);
+};
+
+// Chooses the table (once; later calls return it) and hands its reverb
+// lanes to daisysp::ReverbSc. Call at startup, before audio runs.
+const Kernels& selectKernels();
+
+// The table in use; the scalar one until selectKernels().
+const Kernels& kernels();
+
+// One table by instruction set, or nullptr when it isn't built or this CPU
+// can't run it (AVA_KernelBench).
+const Kernels* kernelsFor(Isa isa);
+
+// "sse2 avx2 fma …": what CPUID reported, for logs.
+const char* cpuFeatures();
+
+
+} // namespace ava::dsp
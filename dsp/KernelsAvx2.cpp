@@ -0,0 +1,6 @@
+// AVX2 + FMA build of the lane kernels (KernelsImpl.h): 8-float vectors,
+// fused multiply-adds. Flags from CMakeLists.txt, this file only.
+#define AVA_KERNELS_ISA   Avx2
+#define AVA_KERNELS_NAME  "avx2"
+#define AVA_KERNELS_TABLE kernelsAvx2
+#include "KernelsImpl.h"
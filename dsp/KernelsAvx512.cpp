@@ -0,0 +1,6 @@
+// AVX-512 (F + VL) build of the lane kernels (KernelsImpl.h): 16-float
+// vectors. Flags from CMakeLists.txt, this file only.
+#define AVA_KERNELS_ISA   Avx512
+#define AVA_KERNELS_NAME  "avx512"
+#define AVA_KERNELS_TABLE kernelsAvx512
+#include "KernelsImpl.h"
@@ -0,0 +1,267 @@
+// -------------------------
+// Lane kernels (Kernels.h)
+// -------------------------
+// Built once per instruction set: KernelsSse2.cpp, KernelsAvx2.cpp and
+// KernelsAvx512.cpp define the ISA, the table's name and symbol, include
+// this file and get their own compiler flags from CMakeLists.txt.
+//
+// Loops run in groups of Lanes frames with restrict pointers, so even the
+// -O2 vectorizer (which won't add alias checks or leftover loops) turns
+// each group into one to four vector ops; the last n % Lanes frames run
+// one at a time. Group offsets are size_t: with an unsigned i, i + j may
+// wrap and GCC no longer sees the group as one contiguous access.
+//
+// Nothing here may call an inline function from another header (<cmath>,
+// <algorithm>, member functions): those are merged across translation
+// units at link time, and the copy the linker keeps could be this file's
+// AVX build, run on a CPU without AVX. Helpers live in the anonymous
+// namespace below instead.
+#pragma once
+
+#if !defined(AVA_KERNELS_ISA) || !defined(AVA_KERNELS_NAME) || !defined(AVA_KERNELS_TABLE)
+#error "KernelsImpl.h is built through KernelsSse2.cpp, KernelsAvx2.cpp or KernelsAvx512.cpp"
+#endif
+
+#include "Kernels.h"
+#include "Effects/reverbsc_lanes.h"
+
+#if defined(_MSC_VER)
+#define AVA_RESTRICT __restrict
+#else
+#define AVA_RESTRICT __restrict__
+#endif
+
+namespace ava::dsp {
+namespace {
+
+constexpr unsigned Lanes = 16;           // one zmm, two ymm, four xmm
+constexpr unsigned LimiterBlock = 64;
+
+inline float absf(float x) { return x < 0.0f ? -x : x; }
+inline float minf(float a, float b) { return a < b ? a : b; }
+inline float maxf(float a, float b) { return a > b ? a : b; }
+inline float clamp01(float x) { return minf(maxf(x, 0.0f), 1.0f); }
+
+// --- Mixing ---
+
+void add(float* AVA_RESTRICT dst, const float* AVA_RESTRICT src, unsigned n) {
+    size_t i = 0;
+    for (; i + Lanes <= n; i += Lanes)
+        for (unsigned j = 0; j < Lanes; j++) dst[i + j] += src[i + j];
+    for (; i < n; i++) dst[i] += src[i];
+}
+
+void scale(float* AVA_RESTRICT x, float gain, unsigned n) {
+    size_t i = 0;
+    for (; i + Lanes <= n; i += Lanes)
+        for (unsigned j = 0; j < Lanes; j++) x[i + j] *= gain;
+    for (; i < n; i++) x[i] *= gain;
+}
+
+// out may be a or b: each group is read whole before it is written
+void blend(float* out, const float* a, float ga, const float* b, float gb, unsigned n) {
+    size_t i = 0;
+    for (; i + Lanes <= n; i += Lanes) {
+        float t[Lanes];
+        for (unsigned j = 0; j < Lanes; j++) t[j] = ga * a[i + j] + gb * b[i + j];
+        for (unsigned j = 0; j < Lanes; j++) out[i + j] = t[j];
+    }
+    for (; i < n; i++) out[i] = ga * a[i] + gb * b[i];
+}
+
+float crossfade(float* AVA_RESTRICT dst, const float* AVA_RESTRICT src, float mix, float step, unsigned n) {
+    size_t i = 0;
+    for (; i + Lanes <= n; i += Lanes)
+        for (unsigned j = 0; j < Lanes; j++) {
+            const float m = clamp01(mix + step * (float)(int)(i + j + 1));
+            dst[i + j] += m * (src[i + j] - dst[i + j]);
+        }
+    for (; i < n; i++) {
+        const float m = clamp01(mix + step * (float)(int)(i + 1));
+        dst[i] += m * (src[i] - dst[i]);
+    }
+    return n ? clamp01(mix + step * (float)(int)n) : mix;
+}
+
+void interleave(float* AVA_RESTRICT out, const float* AVA_RESTRICT left,
+                const float* AVA_RESTRICT right, unsigned n) {
+    size_t i = 0;
+    for (; i + Lanes <= n; i += Lanes)
+        for (unsigned j = 0; j < Lanes; j++) {
+            out[(i + j) * 2 + 0] = left[i + j];
+            out[(i + j) * 2 + 1] = right[i + j];
+        }
+    for (; i < n; i++) {
+        out[i * 2 + 0] = left[i];
+        out[i * 2 + 1] = right[i];
+    }
+}
+
+// --- Wavetable lookup: the loads stay scalar, the morph blend is lanes ---
+
+void tableRead(float* AVA_RESTRICT out, const float* AVA_RESTRICT table, const int32_t* AVA_RESTRICT index,
+               const float* AVA_RESTRICT frac, int32_t stride, unsigned n) {
+    size_t i = 0;
+    if (stride == 0) {
+        for (; i + Lanes <= n; i += Lanes)
+            for (unsigned j = 0; j < Lanes; j++) out[i + j] = table[index[i + j]];
+        for (; i < n; i++) out[i] = table[index[i]];
+        return;
+    }
+    const float* AVA_RESTRICT upper = table + stride;
+    for (; i + Lanes <= n; i += Lanes)
+        for (unsigned j = 0; j < Lanes; j++) {
+            const float a = table[index[i + j]], b = upper[index[i + j]];
+            out[i + j] = a + frac[i + j] * (b - a);
+        }
+    for (; i < n; i++) {
+        const float a = table[index[i]], b = upper[index[i]];
+        out[i] = a + frac[i] * (b - a);
+    }
+}
+
+// --- Envelope segments: closed form per frame, no carried sum ---
+
+float rampGain(float* AVA_RESTRICT x, float gain, float step, unsigned n) {
+    size_t i = 0;
+    for (; i + Lanes <= n; i += Lanes)
+        for (unsigned j = 0; j < Lanes; j++) x[i + j] *= gain + step * (float)(int)(i + j + 1);
+    for (; i < n; i++) x[i] *= gain + step * (float)(int)(i + 1);
+    return gain + step * (float)(int)n;
+}
+
+// g_i = target + (gain - target)·keep^(i+1): keep^1..keep^Lanes once, then
+// the distance shrinks by keep^Lanes per group
+float chaseGain(float* AVA_RESTRICT x, float gain, float target, float keep, unsigned n) {
+    if (n == 0) return gain;
+    float pw[Lanes];
+    float p = 1.0f;
+    for (unsigned j = 0; j < Lanes; j++) pw[j] = p *= keep;
+    const float keepGroup = p;
+
+    float d = gain - target;
+    size_t i = 0;
+    for (; i + Lanes <= n; i += Lanes) {
+        for (unsigned j = 0; j < Lanes; j++) x[i + j] *= target + d * pw[j];
+        d *= keepGroup;
+    }
+    if (i == n) return target + d;
+    for (unsigned j = 0; i + j < n; j++) x[i + j] *= target + d * pw[j];
+    return target + d * pw[n - i - 1];
+}
+
+// --- Filters and dynamics ---
+
+// A recurrence in time: the two channels are the only lanes
+void biquadCascade(float* AVA_RESTRICT left, float* AVA_RESTRICT right, unsigned n, BiquadCascade& c) {
+    Biquad k = c.k;
+    const Biquad step = c.step;
+    const int stages = c.stages;
+    float s1[BiquadCascade::MaxStages][2], s2[BiquadCascade::MaxStages][2];
+    for (int s = 0; s < stages; s++)
+        for (int ch = 0; ch < 2; ch++) {
+            s1[s][ch] = c.s1[s][ch];
+            s2[s][ch] = c.s2[s][ch];
+        }
+
+    for (unsigned i = 0; i < n; i++) {
+        k.b0 += step.b0; k.b1 += step.b1; k.b2 += step.b2;
+        k.a1 += step.a1; k.a2 += step.a2;
+        float x[2] = { left[i], right[i] };
+        for (int s = 0; s < stages; s++)
+            for (int ch = 0; ch < 2; ch++) {
+                const float y = k.b0 * x[ch] + s1[s][ch];
+                s1[s][ch] = k.b1 * x[ch] - k.a1 * y + s2[s][ch];
+                s2[s][ch] = k.b2 * x[ch] - k.a2 * y;
+                x[ch] = y;
+            }
+        left[i] = x[0];
+        right[i] = x[1];
+    }
+
+    c.k = k;
+    for (int s = 0; s < stages; s++)
+        for (int ch = 0; ch < 2; ch++) {
+            c.s1[s][ch] = s1[s][ch];
+            c.s2[s][ch] = s2[s][ch];
+        }
+}
+
+// The gain each frame needs (lanes), the window minimum / release / box
+// average (one frame at a time), then the delay line and the gain.
+void limitBlock(float* AVA_RESTRICT left, float* AVA_RESTRICT right, unsigned n, Limiter& s, float threshold) {
+    constexpr int Lookahead = Limiter::Lookahead;
+    constexpr uint32_t Mask = Limiter::Ring - 1;
+
+    float need[LimiterBlock], gain[LimiterBlock];
+    size_t i = 0;
+    for (; i + Lanes <= n; i += Lanes)
+        for (unsigned j = 0; j < Lanes; j++) {
+            const float peak = maxf(absf(left[i + j]), absf(right[i + j]));
+            need[i + j] = peak > threshold ? threshold / peak : 1.0f;
+        }
+    for (; i < n; i++) {
+        const float peak = maxf(absf(left[i]), absf(right[i]));
+        need[i] = peak > threshold ? threshold / peak : 1.0f;
+    }
+
+    uint64_t frame = s.frame;
+    for (i = 0; i < n; i++, frame++) {
+        while (s.minTail != s.minHead && s.minVal[(s.minTail - 1) & Mask] >= need[i]) s.minTail--;
+        s.minVal[s.minTail & Mask] = need[i];
+        s.minAt[s.minTail & Mask] = frame;
+        s.minTail++;
+        while (s.minAt[s.minHead & Mask] + Lookahead <= frame) s.minHead++;
+        const float windowMin = s.minVal[s.minHead & Mask];
+
+        s.held = windowMin < s.held ? windowMin : s.held + (windowMin - s.held) * s.releaseCoef;
+        s.boxSum += s.held - s.box[s.boxPos];
+        s.box[s.boxPos] = s.held;
+        if (++s.boxPos == Lookahead) {
+            s.boxPos = 0;
+            float sum = 0.0f;   // drop the running sum's rounding drift
+            for (int b = 0; b < Lookahead; b++) sum += s.box[b];
+            s.boxSum = sum;
+        }
+        gain[i] = minf(s.boxSum * (1.0f / (float)Lookahead), 1.0f);
+    }
+
+    frame = s.frame;
+    for (i = 0; i < n; i++, frame++) {
+        const uint32_t w = (uint32_t)frame & Mask;
+        const uint32_t r = (uint32_t)(frame - (Lookahead - 1)) & Mask;
+        s.delay[0][w] = left[i];
+        s.delay[1][w] = right[i];
+        left[i] = s.delay[0][r] * gain[i];
+        right[i] = s.delay[1][r] * gain[i];
+    }
+    s.frame = frame;
+}
+
+void limit(float* left, float* right, unsigned n, Limiter& s, float threshold) {
+    for (unsigned done = 0; done < n; done += LimiterBlock) {
+        const unsigned m = n - done < LimiterBlock ? n - done : LimiterBlock;
+        limitBlock(left + done, right + done, m, s, threshold);
+    }
+}
+
+// --- Reverb lines: ReverbSc's own lane loop, built with this file's flags ---
+
+void reverbLanes(daisysp::ReverbScLanes& s, const float* in1, const float* in2,
+                 float* out1, float* out2, size_t n) {
+    daisysp::ReverbScRunLanes(s, in1, in2, out1, out2, n);
+}
+
+} // namespace
+
+extern const Kernels AVA_KERNELS_TABLE;
+const Kernels AVA_KERNELS_TABLE = {
+    Isa::AVA_KERNELS_ISA, AVA_KERNELS_NAME,
+    add, scale, blend, crossfade, interleave,
+    tableRead,
+    rampGain, chaseGain,
+    biquadCascade, limit,
+    reverbLanes,
+};
+
+} // namespace ava::dsp
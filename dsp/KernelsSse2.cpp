@@ -0,0 +1,6 @@
+// SSE2 build of the lane kernels (KernelsImpl.h): the x86-64 baseline,
+// 4-float vectors, the table for any x86 machine.
+#define AVA_KERNELS_ISA   Sse2
+#define AVA_KERNELS_NAME  "sse2"
+#define AVA_KERNELS_TABLE kernelsSse2
+#include "KernelsImpl.h"
@@ -0,0 +1,163 @@
+#pragma once
+#include <cstdint>
+#include "FastMath.h"
+#include "Kernels.h"
+
+
+namespace ava::dsp::voice {
+
+
+// -------------------------
+// Voice kernels
+// -------------------------
+// The pieces a key's sound is built from a span of frames at a time
+// (ui/key.h, Key::render): the envelope, the tremolo LFO, the source
+// loops and the gain stage. The source and gain loops are templates over
+// what Key::process() decides per sample (detuned second oscillator,
+// tremolo on or off), so the loop inside has no branch on it: Key picks
+// one instantiation per span over which none of them change. The
+// envelope renders whole segments through the Kernels table.
+//
+// The streaming loops (tremolo, gain) run in groups of Lanes frames so
+// the -O2 vectorizer takes them; the oscillator phases stay scalar.
+constexpr unsigned Lanes = 8;
+
+enum class EnvStage { Attack, Sustain, Release };
+
+// Level at which a release is over (the key goes idle).
+constexpr float ReleaseFloor = 0.0001f;
+
+// Sustain's one-pole chase toward the touch's level, per frame.
+constexpr float SustainChase = 0.002f;
+
+// -------------------------
+// Envelope
+// -------------------------
+// Linear attack to the touch's level, a one-pole chase toward it while
+// held, an exponential release to ReleaseFloor. Each segment's length is
+// known from its start (closed form, not a per-frame test), so apply()
+// renders a block as at most a few whole segments: rampGain for the
+// attack, chaseGain toward the level or toward 0, each one vectorized
+// call (dsp/Kernels.h). Gains are process()'s per-frame updates in closed
+// form, equal to float rounding; a segment may end a frame apart.
+struct Envelope {
+    EnvStage stage = EnvStage::Attack;
+    float    gain = 0.0f;
+    float    target = 0.0f;
+    float    attackStep = 0.0f;       // gain per frame
+    float    releaseKeep = 0.9995f;   // gain multiplier per frame
+    bool     idle = false;            // a release ended; its last frame is silent
+
+    // Attack frames still below the target (the next one reaches it).
+    unsigned attackFrames() const {
+        if (!(target > gain) || !(attackStep > 0.0f)) return 0;
+        const float q = (target - gain) / attackStep;
+        if (q >= 1e9f) return 1000000000u;
+        const unsigned k = (unsigned)q;
+        return (float)k == q ? k - 1 : k;   // gain + k·step < target
+    }
+
+    // Frames a release from `from` lasts, the silent one it ends on included.
+    unsigned releaseFrames(float from) const {
+        if (!(from * releaseKeep > ReleaseFloor)) return 1;
+        // first k with from·keep^k ≤ floor
+        const float k = fast::log2(ReleaseFloor / from) / fast::log2(releaseKeep);
+        if (k >= 1e9f) return 1000000000u;
+        const unsigned whole = (unsigned)k;
+        return (float)whole == k ? whole : whole + 1;
+    }
+
+    // Multiplies x[0..n) by the envelope, splitting only where a segment
+    // ends. Returns the frames covered: n, or up to the frame a release
+    // ends on (idle is then set and the gain is 0).
+    unsigned apply(const Kernels& kn, float* x, unsigned n) {
+        unsigned done = 0;
+        while (done < n && !idle) {
+            const unsigned left = n - done;
+            switch (stage) {
+                case EnvStage::Attack: {
+                    const unsigned k = attackFrames() < left ? attackFrames() : left;
+                    if (k > 0) gain = kn.rampGain(x + done, gain, attackStep, k);
+                    done += k;
+                    if (k < left) {   // the next frame reaches the level: held from there
+                        gain = target;
+                        stage = EnvStage::Sustain;
+                    }
+                    break;
+                }
+                case EnvStage::Sustain:
+                    gain = kn.chaseGain(x + done, gain, target, 1.0f - SustainChase, left);
+                    done = n;
+                    break;
+                case EnvStage::Release: {
+                    const unsigned r = releaseFrames(gain);
+                    if (r > left) {
+                        gain = kn.chaseGain(x + done, gain, 0.0f, releaseKeep, left);
+                        done = n;
+                        break;
+                    }
+                    if (r > 1) kn.chaseGain(x + done, gain, 0.0f, releaseKeep, r - 1);
+                    x[done + r - 1] *= 0.0f;
+                    done += r;
+                    gain = 0.0f;
+                    idle = true;
+                    break;
+                }
+            }
+        }
+        return done;
+    }
+};
+
+// 1 + depth·0.3·sin(phase) for n frames, the phase (radians, the
+// caller's copy) advanced by inc and wrapped before each.
+inline void tremolo(float* mod, double& phase, double inc, float depth, unsigned n) {
+    constexpr double TwoPi = 2.0 * 3.14159265358979323846;
+    for (unsigned i = 0; i < n; i += Lanes) {
+        const unsigned m = n - i < Lanes ? n - i : Lanes;
+        float ph[Lanes] = {};
+        for (unsigned j = 0; j < m; j++) {
+            phase += inc;
+            if (phase >= TwoPi)
+                phase -= TwoPi;
+            ph[j] = (float)phase;
+        }
+        float t[Lanes];
+        for (unsigned j = 0; j < Lanes; j++) t[j] = 1.0f + depth * 0.3f * fast::sin(ph[j]);
+        for (unsigned j = 0; j < m; j++) mod[i + j] = t[j];
+    }
+}
+
+// One oscillator, or it and its detuned twin averaged. Osc is anything
+// with Process() (daisysp::Oscillator).
+template <bool Detune, class Osc>
+void oscillators(float* out, Osc& a, Osc& b, unsigned n) {
+    for (unsigned i = 0; i < n; i++) {
+        if constexpr (Detune)
+            out[i] = 0.5f * (a.Process() + b.Process());
+        else
+            out[i] = a.Process();
+    }
+}
+
+// out += s·(mod)·weight: the enveloped source into the mix. Each group is
+// read whole before it is written, as in the blend kernel.
+template <bool Tremolo>
+void applyGain(float* out, const float* s, const float* mod, float weight, unsigned n) {
+    unsigned i = 0;
+    for (; i + Lanes <= n; i += Lanes) {
+        float t[Lanes];
+        for (unsigned j = 0; j < Lanes; j++) {
+            if constexpr (Tremolo) t[j] = out[i + j] + s[i + j] * mod[i + j] * weight;
+            else                   t[j] = out[i + j] + s[i + j] * weight;
+        }
+        for (unsigned j = 0; j < Lanes; j++) out[i + j] = t[j];
+    }
+    for (; i < n; i++) {
+        if constexpr (Tremolo) out[i] += s[i] * mod[i] * weight;
+        else                   out[i] += s[i] * weight;
+    }
+}
+
+
+} // namespace ava::dsp::voice
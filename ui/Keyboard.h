@@ -6,7 +6,6 @@
 #include <SDL.h>
 #include <nanovg.h>
 #include <cmath>
-#include "AudioBus.h"
 #include "WaveSchema.h"
 #include "Waveform.h"
 #define NOMINMAX
@@ -40,20 +39,6 @@ public:
         for (auto& k : keys) k.draw(vg);
     }
 
-    // --- AudioBus integration ---
-    void setMasterGain(float g) { bus.setMasterGain(g); }
-    void setLimiterThreshold(float t) { bus.setLimiterThreshold(t); }
-    
-    // --- Lowpass passthroughs ---
-    void setLowpassHz(float hz)        { bus.setLowpassHz(hz); }
-    void setLowpassQ(float q)          { bus.setLowpassQ(q); }
-    void setLowpassEnabled(bool e)     { bus.setLowpassEnabled(e); }
-
-    void process(float* buffer, int numFrames) {
-        for (auto& k : keys) k.addToBuffer(buffer, numFrames);
-        bus.process(buffer, numFrames);
-    }
-
     bool handleEvent(const SDL_Event& e, int winW, int winH) {
         if (e.type == SDL_FINGERDOWN || e.type == SDL_FINGERUP || e.type == SDL_FINGERMOTION) {
             float mx = e.tfinger.x * winW;
@@ -131,36 +116,69 @@ public:
 
     // --- Waveform selection (band-limited via WaveSchema) ---
     void setWaveform(const WaveformInfo& wf) {
-        for (auto& k : keys) {
-            if (wf.name == "Sine")   { k.setOscillator(Key::Sine);   continue; }
-            if (wf.name == "Square") { k.setOscillator(Key::Square); continue; }
-            if (wf.name == "Saw")    { k.setOscillator(Key::Saw);    continue; }
+        applyTables(wf, buildTables(wf));
+    }
+
+    // Table build only depends on the key frequencies, not on geometry or
+    // audio state, so startup can run it on a worker thread (const, no
+    // mutation) and hand the result to applyTables() on the main thread.
+    // Empty entries = no table (Sine/Square/Saw, additive, physical or an unknown waveform).
+    std::vector<std::vector<float>> buildTables(const WaveformInfo& wf) const {
+        std::vector<std::vector<float>> tables(keys.size());
+        if (isBuiltinOscillator(wf.name) || wf.spectrum || wf.physical >= 0) return tables;
+        if (wf.morphs()) return buildMorphStacks(wf);
 
-            std::vector<float> table;
+        HarmonicSpec spec;
+        bool haveSpec = fetchSpecByName(wf.name, spec);
+        std::vector<float> base;   // generator output is the same for every key
+        std::vector<Harmonic> hs;
+        if (haveSpec) {
+            hs = toHarmonics(spec);
+        } else if (wf.generator) {
+            base = wf.generator();
+            float mx = 0.0f; for (float v : base) mx = std::max(mx, std::abs(v));
+            if (mx > 0.0f) {
+                float cap = 0.95f, s = std::min(1.0f/mx, cap/mx);
+                for (auto& v : base) v *= s;
+            }
+        }
 
-            HarmonicSpec spec;
-            if (fetchSpecByName(wf.name, spec)) {
-                auto hs = toHarmonics(spec);
+        for (size_t i = 0; i < keys.size(); i++) {
+            const Key& k = keys[i];
+            if (haveSpec) {
                 // WaveSchema schema(hs, k.frequency, 48000.0, 12000.0, 0.95f);
                 
                 // WaveSchema schema(hs, k.frequency, 48000.0, 12000.0);
                 double cutoff = std::min(6000.0, k.frequency * 20.0);
                 WaveSchema schema(hs, k.frequency, 48000.0, cutoff);
 
-                table = schema.buildTable(k.tableSize);
-            } else if (!wf.generator().empty()) {
-                auto base = wf.generator();
-                if (!base.empty()) {
-                    float mx = 0.0f; for (float v : base) mx = std::max(mx, std::abs(v));
-                    if (mx > 0.0f) {
-                        float cap = 0.95f, s = std::min(1.0f/mx, cap/mx);
-                        for (auto& v : base) v *= s;
-                    }
-                    table = std::move(base);
-                }
+                tables[i] = schema.buildTable(k.tableSize);
+            } else {
+                tables[i] = base;
             }
+        }
+        return tables;
+    }
 
-            if (!table.empty()) k.setWavetable(table);
+    void applyTables(const WaveformInfo& wf, const std::vector<std::vector<float>>& tables) {
+        if (wf.spectrum) {
+            HarmonicSpec spec = wf.spectrum();
+            for (auto& k : keys) k.setAdditive(spec);
+            return;
+        }
+        if (wf.physical >= 0) {
+            for (auto& k : keys) k.setPhysical(wf.physical);
+            return;
+        }
+        for (size_t i = 0; i < keys.size(); i++) {
+            auto& k = keys[i];
+            if (wf.name == "Sine")   { k.setOscillator(Key::Sine);   continue; }
+            if (wf.name == "Square") { k.setOscillator(Key::Square); continue; }
+            if (wf.name == "Saw")    { k.setOscillator(Key::Saw);    continue; }
+
+            if (i >= tables.size() || tables[i].empty()) continue;
+            if (wf.morphs()) k.setMorphStack(tables[i], wf.morphSteps, wf.axis);
+            else             k.setWavetable(tables[i]);
         }
     }
 
@@ -173,6 +191,45 @@ public:
     }
 
 private:
+    // One flattened stack per key (morphSteps tables of 2048). A key that
+    // allows the same number of harmonics below Nyquist as an earlier one
+    // reuses that key's computed stack (copied into its own entry; only the
+    // morph() calls are saved).
+    std::vector<std::vector<float>> buildMorphStacks(const WaveformInfo& wf) const {
+        const double nyquist = 0.5 * 48000.0 * 0.9;   // small guard band
+        std::vector<std::vector<float>> stacks(keys.size());
+        std::map<size_t, size_t> firstWithHarmonics;   // maxHarmonics → key index
+
+        for (size_t i = 0; i < keys.size(); i++) {
+            size_t maxH = (size_t)std::max(1.0, std::floor(nyquist / keys[i].frequency));
+            maxH = std::min(maxH, wf.morphHarmonics);
+            auto it = firstWithHarmonics.find(maxH);
+            if (it != firstWithHarmonics.end()) {
+                stacks[i] = stacks[it->second];
+                continue;
+            }
+            firstWithHarmonics[maxH] = i;
+
+            std::vector<float>& stack = stacks[i];
+            for (int l = 0; l < wf.morphSteps; l++) {
+                float t = (float)l / (float)(wf.morphSteps - 1);
+                std::vector<float> layer = wf.morph(t, maxH);
+                if (layer.empty()) { stack.clear(); break; }
+                float mx = 0.0f; for (float v : layer) mx = std::max(mx, std::abs(v));
+                if (mx > 0.0f) {
+                    float s = 0.95f / mx;
+                    for (auto& v : layer) v *= s;
+                }
+                stack.insert(stack.end(), layer.begin(), layer.end());
+            }
+        }
+        return stacks;
+    }
+
+    static bool isBuiltinOscillator(const std::string& name) {
+        return name == "Sine" || name == "Square" || name == "Saw";
+    }
+
     int numKeys;
     float baseFrequency;
     std::vector<double> ratios;
@@ -183,8 +240,6 @@ private:
     std::vector<Key> keys;
     std::map<SDL_FingerID, int> fingerToKey;
 
-    AudioBus bus {48000.0f};
-
     void buildKeys() {
         keys.clear();
         int numRatios = (int)ratios.size();
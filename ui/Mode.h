@@ -13,6 +13,12 @@ public:
     std::vector<std::string> labels;  // note labels
     std::map<std::string, std::any> meta; // open metadata
 
+    // catalog fields (filled by ModeLoader, defaults for built-in modes)
+    std::string type;                     // gah_type: "Gooya", "Gong", ...
+    int et = 1;                           // et / etdenominator → e.g. 2/24 = 24-ET grid
+    int etDenominator = 1;
+    std::vector<std::string> noteNames;   // per-ratio "name" field ("C", "Tonic (Sa)")
+
     Mode(const std::string& n,
          const std::vector<double>& r,
          const std::vector<std::string>& l,
@@ -77,9 +83,12 @@ public:
             l.push_back("Step " + std::to_string(k) + "/" + std::to_string(N));
         }
 
-        return Mode(name + " " + std::to_string(N),
-                    r, l,
-                    {{"system", std::string("equal temperament")}});
+        Mode m(name + " " + std::to_string(N),
+               r, l,
+               {{"system", std::string("equal temperament")}});
+        m.type = "ET";
+        m.etDenominator = N;
+        return m;
     }
 
 };
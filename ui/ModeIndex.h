@@ -0,0 +1,378 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#include <unordered_map>
+#include "Mode.h"
+
+// -------------------------
+// ModeQuery: what the performer typed
+// -------------------------
+//   "chahargah mokh"        → name tokens (all must match)
+//   "shur type:gong et:24"  → + filters on gah_type and the ET grid
+struct ModeQuery {
+    std::string text;
+    std::string type;          // "" = any (case-insensitive)
+    int etDenominator = 0;     // 0  = any
+    size_t limit = 64;
+
+    static ModeQuery parse(const std::string& input) {
+        ModeQuery q;
+        size_t i = 0;
+        while (i < input.size()) {
+            while (i < input.size() && input[i] == ' ') i++;
+            size_t j = input.find(' ', i);
+            if (j == std::string::npos) j = input.size();
+            std::string tok = input.substr(i, j - i);
+            i = j;
+            if (tok.empty()) continue;
+
+            if (tok.rfind("type:", 0) == 0) { q.type = tok.substr(5); continue; }
+            if (tok.rfind("et:", 0) == 0) {
+                q.etDenominator = std::atoi(tok.c_str() + 3);
+                continue;
+            }
+            if (!q.text.empty()) q.text += ' ';
+            q.text += tok;
+        }
+        return q;
+    }
+};
+
+// -------------------------
+// ModeIndex: built once per catalog load, queried from the UI
+// -------------------------
+// Names are tokenised and kept in two sorted key tables:
+//   translit  – Persian letters mapped to Latin ("چهارگاه" → "chhargah")
+//   skeleton  – consonant skeleton ("chahargah", "chhargah" → "chrgh"),
+//               so typed transliterations match unvoweled Persian spelling
+// Prefix lookups are binary searches; fuzzy matching is a bounded
+// prefix edit distance over the (few hundred) unique tokens.
+class ModeIndex {
+public:
+    void build(const std::vector<Mode>& modes) {
+        entries.clear();
+        tokens.clear();
+        translitKeys.clear();
+        skeletonKeys.clear();
+        bySize.clear();
+        steps.clear();
+
+        std::unordered_map<std::string, uint32_t> tokenIds;
+
+        for (size_t m = 0; m < modes.size(); m++) {
+            const Mode& mode = modes[m];
+            Entry e;
+            e.name          = mode.name;
+            e.type          = lower(mode.type);
+            e.etDenominator = mode.etDenominator;
+
+            for (auto& t : tokenize(transliterate(mode.name))) {
+                auto [it, inserted] = tokenIds.emplace(t, (uint32_t)tokens.size());
+                if (inserted) tokens.push_back({t, skeleton(t), {}});
+                auto& postings = tokens[it->second].modes;
+                if (postings.empty() || postings.back() != (uint32_t)m)
+                    postings.push_back((uint32_t)m);
+            }
+
+            // interval structure: sorted steps in cents (+ closing step to the octave)
+            e.stepOffset = steps.size();
+            std::vector<double> r = mode.ratios;
+            std::sort(r.begin(), r.end());
+            for (size_t k = 1; k < r.size(); k++)
+                steps.push_back(cents(r[k] / r[k-1]));
+            if (!r.empty() && r.back() < 2.0 && r.front() > 0.0)
+                steps.push_back(cents(2.0 * r.front() / r.back()));
+            e.stepCount = steps.size() - e.stepOffset;
+            bySize[e.stepCount].push_back((int)m);
+
+            entries.push_back(std::move(e));
+        }
+
+        for (uint32_t t = 0; t < tokens.size(); t++) {
+            translitKeys.push_back({tokens[t].translit, t});
+            if (!tokens[t].skeleton.empty())
+                skeletonKeys.push_back({tokens[t].skeleton, t});
+        }
+        std::sort(translitKeys.begin(), translitKeys.end());
+        std::sort(skeletonKeys.begin(), skeletonKeys.end());
+    }
+
+    size_t size() const { return entries.size(); }
+
+    // Ranked mode indices (into the vector passed to build()).
+    std::vector<int> search(const ModeQuery& q) const {
+        const std::string wantType = lower(q.type);
+        auto passes = [&](size_t m) {
+            const Entry& e = entries[m];
+            if (!wantType.empty() && e.type != wantType) return false;
+            if (q.etDenominator > 0 && e.etDenominator != q.etDenominator) return false;
+            return true;
+        };
+
+        std::vector<std::string> words = tokenize(transliterate(q.text));
+        std::vector<int> out;
+
+        if (words.empty()) {
+            for (size_t m = 0; m < entries.size() && out.size() < q.limit; m++)
+                if (passes(m)) out.push_back((int)m);
+            return out;
+        }
+
+        // total score per mode; every query word must match some token (AND)
+        const int kNoMatch = 1 << 20;
+        std::vector<int> total(entries.size(), 0);
+        std::vector<int> best(entries.size());
+
+        for (const auto& w : words) {
+            std::fill(best.begin(), best.end(), kNoMatch);
+            scoreWord(w, best);
+            for (size_t m = 0; m < entries.size(); m++)
+                total[m] = (best[m] == kNoMatch || total[m] >= kNoMatch) ? kNoMatch
+                                                                         : total[m] + best[m];
+        }
+
+        for (size_t m = 0; m < entries.size(); m++)
+            if (total[m] < kNoMatch && passes(m)) out.push_back((int)m);
+
+        std::sort(out.begin(), out.end(), [&](int a, int b) {
+            if (total[a] != total[b]) return total[a] < total[b];
+            if (entries[a].name.size() != entries[b].name.size())
+                return entries[a].name.size() < entries[b].name.size();
+            return entries[a].name < entries[b].name;
+        });
+        if (out.size() > q.limit) out.resize(q.limit);
+        return out;
+    }
+
+    // Modes whose step pattern matches `ratios` within ±tolCents per step.
+    // With anyRotation, the same scale started from another degree also matches.
+    std::vector<int> findByIntervals(const std::vector<double>& ratios,
+                                     float tolCents = 15.0f,
+                                     bool anyRotation = false) const {
+        std::vector<double> r = ratios;
+        std::sort(r.begin(), r.end());
+        std::vector<float> want;
+        for (size_t k = 1; k < r.size(); k++) want.push_back(cents(r[k] / r[k-1]));
+        if (!r.empty() && r.back() < 2.0 && r.front() > 0.0)
+            want.push_back(cents(2.0 * r.front() / r.back()));
+        return matchSteps(want, tolCents, anyRotation, -1);
+    }
+
+    std::vector<int> similarTo(int modeIdx, float tolCents = 15.0f, bool anyRotation = true) const {
+        if (modeIdx < 0 || modeIdx >= (int)entries.size()) return {};
+        const Entry& e = entries[modeIdx];
+        std::vector<float> want(steps.begin() + e.stepOffset,
+                                steps.begin() + e.stepOffset + e.stepCount);
+        return matchSteps(want, tolCents, anyRotation, modeIdx);
+    }
+
+    // --- text normalisation (public so the UI can echo what it matched) ---
+
+    // UTF-8 → lowercase Latin; Persian/Arabic letters transliterated, the
+    // rest of the non-alphanumerics become spaces.
+    static std::string transliterate(const std::string& s) {
+        std::string out;
+        out.reserve(s.size());
+        size_t i = 0;
+        while (i < s.size()) {
+            uint32_t cp = decodeUtf8(s, i);
+            if (cp < 0x80) {
+                char c = (char)cp;
+                if (c >= 'A' && c <= 'Z') c = char(c - 'A' + 'a');
+                bool alnum = (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9');
+                out += alnum ? c : ' ';
+                continue;
+            }
+            if (const char* lat = persianToLatin(cp)) out += lat;
+            else out += ' ';
+        }
+        return out;
+    }
+
+    // Consonant skeleton: drop short vowels and y, fold u/w/oo/ou → v and
+    // q → gh, collapse doubled letters.
+    static std::string skeleton(const std::string& t) {
+        std::string out;
+        for (size_t i = 0; i < t.size(); i++) {
+            char c = t[i];
+            char next = (i + 1 < t.size()) ? t[i+1] : 0;
+            std::string add;
+            if (c == 'o' && (next == 'u' || next == 'o')) { add = "v"; i++; }
+            else if (c == 'u' || c == 'w')                add = "v";
+            else if (c == 'q')                            add = "gh";
+            else if (c == 'a' || c == 'e' || c == 'i' || c == 'o' || c == 'y') continue;
+            else                                          add = std::string(1, c);
+            for (char a : add)
+                if (out.empty() || out.back() != a) out += a;
+        }
+        return out;
+    }
+
+private:
+    struct Entry {
+        std::string name;
+        std::string type;          // lowercased gah_type
+        int etDenominator = 1;
+        size_t stepOffset = 0, stepCount = 0;
+    };
+    struct Token {
+        std::string translit;
+        std::string skeleton;
+        std::vector<uint32_t> modes;   // postings, ascending
+    };
+
+    std::vector<Entry> entries;
+    std::vector<Token> tokens;
+    std::vector<std::pair<std::string, uint32_t>> translitKeys;   // sorted
+    std::vector<std::pair<std::string, uint32_t>> skeletonKeys;   // sorted
+    std::vector<float> steps;                                     // flat, per entry
+    std::unordered_map<size_t, std::vector<int>> bySize;
+
+    static float cents(double ratio) { return (float)(1200.0 * std::log2(ratio)); }
+
+    static std::string lower(std::string s) {
+        for (auto& c : s) if (c >= 'A' && c <= 'Z') c = char(c - 'A' + 'a');
+        return s;
+    }
+
+    static std::vector<std::string> tokenize(const std::string& s) {
+        std::vector<std::string> out;
+        std::string cur;
+        for (char c : s) {
+            if (c == ' ') { if (!cur.empty()) out.push_back(cur); cur.clear(); }
+            else cur += c;
+        }
+        if (!cur.empty()) out.push_back(cur);
+        return out;
+    }
+
+    // scores: 0 translit prefix, 1 skeleton prefix, 2+d fuzzy skeleton prefix
+    void scoreWord(const std::string& w, std::vector<int>& best) const {
+        auto mark = [&](uint32_t tok, int score) {
+            for (uint32_t m : tokens[tok].modes) best[m] = std::min(best[m], score);
+        };
+        auto prefixRange = [&](const std::vector<std::pair<std::string, uint32_t>>& keys,
+                               const std::string& p, int score) {
+            auto it = std::lower_bound(keys.begin(), keys.end(),
+                                       std::make_pair(p, (uint32_t)0));
+            for (; it != keys.end() && it->first.compare(0, p.size(), p) == 0; ++it)
+                mark(it->second, score);
+        };
+
+        prefixRange(translitKeys, w, 0);
+
+        const std::string ws = skeleton(w);
+        if (ws.empty()) return;
+        prefixRange(skeletonKeys, ws, 1);
+
+        const int maxDist = ws.size() <= 3 ? 0 : (ws.size() <= 6 ? 1 : 2);
+        if (maxDist == 0) return;
+        for (uint32_t t = 0; t < tokens.size(); t++) {
+            int d = prefixDistance(ws, tokens[t].skeleton, maxDist);
+            if (d > 0 && d <= maxDist) mark(t, 2 + d);
+        }
+    }
+
+    // Edit distance between `q` and the best-matching prefix of `t`,
+    // abandoned as soon as it must exceed maxDist.
+    static int prefixDistance(const std::string& q, const std::string& t, int maxDist) {
+        constexpr size_t kMax = 48;
+        const size_t m = std::min(q.size(), kMax), n = std::min(t.size(), kMax);
+        int prev[kMax + 1], cur[kMax + 1];
+        for (size_t j = 0; j <= n; j++) prev[j] = (int)j;
+        for (size_t i = 1; i <= m; i++) {
+            cur[0] = (int)i;
+            int rowMin = cur[0];
+            for (size_t j = 1; j <= n; j++) {
+                int cost = (q[i-1] == t[j-1]) ? 0 : 1;
+                cur[j] = std::min({ prev[j] + 1, cur[j-1] + 1, prev[j-1] + cost });
+                rowMin = std::min(rowMin, cur[j]);
+            }
+            if (rowMin > maxDist) return maxDist + 1;
+            std::copy(cur, cur + n + 1, prev);
+        }
+        int d = prev[0];
+        for (size_t j = 1; j <= n; j++) d = std::min(d, prev[j]);
+        return d;
+    }
+
+    std::vector<int> matchSteps(const std::vector<float>& want, float tol,
+                                bool anyRotation, int exclude) const {
+        std::vector<std::pair<float, int>> hits;
+        auto it = bySize.find(want.size());
+        if (want.empty() || it == bySize.end()) return {};
+
+        const size_t n = want.size();
+        for (int m : it->second) {
+            if (m == exclude) continue;
+            const float* s = &steps[entries[m].stepOffset];
+            float bestDev = 1e9f;
+            const size_t rotations = anyRotation ? n : 1;
+            for (size_t r = 0; r < rotations; r++) {
+                float dev = 0.0f;
+                for (size_t k = 0; k < n && dev <= tol; k++)
+                    dev = std::max(dev, std::fabs(s[(k + r) % n] - want[k]));
+                bestDev = std::min(bestDev, dev);
+            }
+            if (bestDev <= tol) hits.push_back({bestDev, m});
+        }
+        std::sort(hits.begin(), hits.end());
+        std::vector<int> out;
+        for (auto& h : hits) out.push_back(h.second);
+        return out;
+    }
+
+    static uint32_t decodeUtf8(const std::string& s, size_t& i) {
+        unsigned char c = (unsigned char)s[i];
+        int len = c < 0x80 ? 1 : (c >> 5) == 0x6 ? 2 : (c >> 4) == 0xE ? 3 : (c >> 3) == 0x1E ? 4 : 1;
+        if (i + len > s.size()) len = 1;
+        uint32_t cp = (len == 1) ? c : (len == 2) ? (c & 0x1F) : (len == 3) ? (c & 0x0F) : (c & 0x07);
+        for (int k = 1; k < len; k++) cp = (cp << 6) | ((unsigned char)s[i + k] & 0x3F);
+        i += len;
+        return cp;
+    }
+
+    // Persian / Arabic letters → Latin (same letter-for-letter scheme as
+    // assets/modes_eng.json). nullptr = separator, "" = ignored mark.
+    static const char* persianToLatin(uint32_t cp) {
+        switch (cp) {
+            case 0x0622: case 0x0623: case 0x0627: case 0x0671: return "a";
+            case 0x0625: return "e";
+            case 0x0628: return "b";
+            case 0x067E: return "p";
+            case 0x062A: case 0x0637: return "t";
+            case 0x062B: case 0x0633: case 0x0635: return "s";
+            case 0x062C: return "j";
+            case 0x0686: return "ch";
+            case 0x062D: case 0x0647: case 0x0629: return "h";
+            case 0x062E: return "kh";
+            case 0x062F: return "d";
+            case 0x0630: case 0x0632: case 0x0636: case 0x0638: return "z";
+            case 0x0631: return "r";
+            case 0x0698: return "zh";
+            case 0x0634: return "sh";
+            case 0x0639: return "a";
+            case 0x063A: case 0x0642: return "gh";
+            case 0x0641: return "f";
+            case 0x06A9: case 0x0643: return "k";
+            case 0x06AF: return "g";
+            case 0x0644: return "l";
+            case 0x0645: return "m";
+            case 0x0646: return "n";
+            case 0x0648: case 0x0624: return "v";
+            case 0x06CC: case 0x064A: case 0x0626: case 0x0649: return "y";
+            case 0x0621: case 0x200C: case 0x200D: return "";   // hamza, ZWNJ/ZWJ
+            default:
+                if (cp >= 0x064B && cp <= 0x0652) return "";     // harakat
+                if (cp >= 0x06F0 && cp <= 0x06F9) {              // Persian digits
+                    static const char* digits[] = {"0","1","2","3","4","5","6","7","8","9"};
+                    return digits[cp - 0x06F0];
+                }
+                return nullptr;
+        }
+    }
+};
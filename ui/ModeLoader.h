@@ -27,6 +27,8 @@ public:
     static std::vector<Mode> fromJSON(const json& j) {
         std::map<std::string, std::vector<double>> ratioGroups;
         std::map<std::string, std::vector<std::string>> labelGroups;
+        std::map<std::string, std::vector<std::string>> nameGroups;
+        std::map<std::string, const json*> firstEntry;   // per-gah fields
 
         for (const auto& entry : j) {
             std::string gah   = entry.value("gah_name", "Unknown");
@@ -35,15 +37,19 @@ public:
 
             ratioGroups[gah].push_back(ratio);
             labelGroups[gah].push_back(label);
+            nameGroups[gah].push_back(entry.value("name", ""));
+            if (!firstEntry.count(gah)) firstEntry[gah] = &entry;
         }
 
         std::vector<Mode> modes;
         for (auto& [gah, ratios] : ratioGroups) {
-            modes.emplace_back(
-                gah,
-                ratios,
-                labelGroups[gah]
-            );
+            Mode m(gah, ratios, labelGroups[gah]);
+            const json& e   = *firstEntry[gah];
+            m.type          = e.value("gah_type", "");
+            m.et            = e.value("et", 1);
+            m.etDenominator = e.value("etdenominator", 1);
+            m.noteNames     = std::move(nameGroups[gah]);
+            modes.push_back(std::move(m));
         }
 
         return modes;
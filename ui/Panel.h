@@ -80,7 +80,6 @@ public:
     bool visible;
     float panelHeightFrac;
     std::vector<Widget*> children;
-    TouchSketchGenerator& improv;  // 🔹 reference improv generator
 
     // Controls
     Slider* tremRate;
@@ -95,19 +94,31 @@ public:
     InputField* imagField;
 
     Selector* modeSelector;  //new
+    InputField* modeSearch;  // name / type: / et: query for the mode catalog
     Button* improvToggle;   // new
+    Button* recToggle;      // 🔹 performance recorder
+    Button* reverbTierBtn;  // 🔹 reverb quality tier (Low / Mid / High)
 
     bool improvEnabled = false;  // 🔹 track improviser state
+    bool recordEnabled = false;  // 🔹 track recorder state
+    int  reverbTier = 1;         // 🔹 ava::audio::ReverbTier, Mid = ReverbSc
 
+    // main.cpp starts/stops the recorder; returns the resulting state
+    std::function<bool(bool)> onRecord;
+    // main.cpp starts/stops the audio-side improviser
+    std::function<void(bool)> onImprov;
+    // main.cpp swaps the engine's reverb for the tier
+    std::function<void(int)> onReverbTier;
 
-Panel(Keyboard& kb, TouchSketchGenerator& imp, float heightFrac = 0.18f)
+
+Panel(Keyboard& kb, float heightFrac = 0.18f)
     : keyboard(kb),
-      improv(imp),                 // ✅ initialize reference
       visible(false), panelHeightFrac(heightFrac),
       tremRate(nullptr), tremDepth(nullptr),
       reverbDecay(nullptr), reverbMix(nullptr), roomSize(nullptr),
       oscWave(nullptr), realField(nullptr), imagField(nullptr),
-      modeSelector(nullptr), improvToggle(nullptr),
+      modeSelector(nullptr), modeSearch(nullptr), improvToggle(nullptr), recToggle(nullptr),
+      reverbTierBtn(nullptr),
       improvEnabled(false) {}
 
 
@@ -200,16 +211,40 @@ Panel(Keyboard& kb, TouchSketchGenerator& imp, float heightFrac = 0.18f)
                                 improvEnabled ? "ImprovOn" : "ImprovOff");
 
         improvToggle->onClick = [this]() {
-            improvEnabled = !improvEnabled;
-            improvToggle->text = improvEnabled ? "ImprovOn" : "ImprovOff";
-            if (!improvEnabled) {
-                improv.releaseAll();   // ✅ stop notes when turned off
-            }
+            setImproviser(!improvEnabled);
         };
 
         children.push_back(improvToggle);
         x += 160 + spacing;
 
+        // 🔹 Mode search (results are pushed into modeSelector by main.cpp)
+        modeSearch = new InputField(x, yBox, selectorW * 1.5f, boxH);
+        children.push_back(modeSearch);
+        x += selectorW * 1.5f + spacing;
+
+        // 🔹 Record button
+        recToggle = new Button(x, yBox, 160.0f, boxH,
+                               recordEnabled ? "RecOn" : "RecOff");
+
+        recToggle->onClick = [this]() {
+            bool want = !recordEnabled;
+            recordEnabled = onRecord ? onRecord(want) : false;
+            recToggle->text = recordEnabled ? "RecOn" : "RecOff";
+        };
+
+        children.push_back(recToggle);
+        x += 160 + spacing;
+
+        // 🔹 Reverb quality: cheap on low-end devices, dense on studio machines
+        reverbTierBtn = new Button(x, yBox, 160.0f, boxH, reverbTierLabel(reverbTier));
+
+        reverbTierBtn->onClick = [this]() {
+            setReverbTier((reverbTier + 1) % 3);
+        };
+
+        children.push_back(reverbTierBtn);
+        x += 160 + spacing;
+
 
 
 
@@ -321,6 +356,12 @@ Panel(Keyboard& kb, TouchSketchGenerator& imp, float heightFrac = 0.18f)
             float h = modeSelector->h + 20;
             drawFrame(vg, x, modeSelector->y - 20, w, h, "Mode");
         }
+        if (modeSearch) {
+            float x = modeSearch->x - 6;
+            float w = modeSearch->w + 12;
+            float h = modeSearch->h + 20;
+            drawFrame(vg, x, modeSearch->y - 20, w, h, "Search");
+        }
 
         // Draw children
         for (auto* c : children) {
@@ -367,6 +408,25 @@ Panel(Keyboard& kb, TouchSketchGenerator& imp, float heightFrac = 0.18f)
         bool improviserEnabled() const {
             return improvEnabled;
         }
+        void setImproviser(bool on) {
+            improvEnabled = on;
+            if (improvToggle) improvToggle->text = improvEnabled ? "ImprovOn" : "ImprovOff";
+            if (onImprov) onImprov(on);   // ✅ off releases the generated notes
+        }
+        // the recorder stopped on its own (a failed write): label only
+        void setRecording(bool on) {
+            recordEnabled = on;
+            if (recToggle) recToggle->text = recordEnabled ? "RecOn" : "RecOff";
+        }
+        static const char* reverbTierLabel(int tier) {
+            static const char* labels[] = { "RevLow", "RevMid", "RevHigh" };
+            return labels[tier < 0 ? 0 : tier > 2 ? 2 : tier];
+        }
+        void setReverbTier(int tier) {
+            reverbTier = tier;
+            if (reverbTierBtn) reverbTierBtn->text = reverbTierLabel(tier);
+            if (onReverbTier) onReverbTier(tier);
+        }
 
 
 
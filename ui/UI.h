@@ -224,6 +224,7 @@ public:
     // 🔹 Callbacks
     std::function<void(const std::string&)> onChange; 
     std::function<void(const std::string&)> onBlur;
+    std::function<void(const std::string&)> onSubmit;   // Enter, before the blur
 
     InputField(float x_, float y_, float w_, float h_)
         : Widget(x_, y_, w_, h_), focused(false) {
@@ -288,9 +289,10 @@ public:
                 if (onChange) onChange(text);
                 return true;
             }
-            // Optional: press Enter to also trigger onBlur
-            if (e.key.keysym.sym == SDLK_RETURN && onBlur) {
-                onBlur(text);
+            // Enter submits and leaves the field
+            if (e.key.keysym.sym == SDLK_RETURN) {
+                if (onSubmit) onSubmit(text);
+                if (onBlur) onBlur(text);
                 focused = false;
                 return true;
             }
@@ -540,6 +542,13 @@ public:
         return options[selectedIndex];
     }
 
+    // Jump straight to an option (search results) and fire onSelect
+    void select(int idx) {
+        if (idx < 0 || idx >= (int)options.size()) return;
+        selectedIndex = idx;
+        if (onSelect) onSelect(selectedIndex, options[selectedIndex]);
+    }
+
     void draw(NVGcontext* vg) override {
         // Box
         nvgBeginPath(vg);
@@ -1,6 +1,7 @@
 #pragma once
 #include <vector>
 #include <cmath>
+#include <algorithm>
 #include <nanovg.h>
 #include "UI.h"   // ✅ srgbColor is here
 
@@ -40,3 +41,45 @@ inline void drawSpectrum(NVGcontext* vg, float x, float y, float w, float h,
     nvgFillColor(vg, srgbColor(187,125,128));
     nvgFill(vg);
 }
+
+// --- Draw a log-frequency spectrum (dB bins, e.g. from SpectrumAnalyzer) ---
+// bins are evenly spaced in log frequency between fMin and fMax.
+// Faint vertical lines mark octaves of A (55, 110, 220 ... Hz) so partials
+// of a microtonal mode can be read against them.
+inline void drawSpectrum(NVGcontext* vg, float x, float y, float w, float h,
+                         const std::vector<float>& binsDb,
+                         float fMin, float fMax,
+                         float minDb = -90.0f, float maxDb = 0.0f) {
+    if (binsDb.empty() || fMax <= fMin) return;
+    const float logSpan = std::log2(fMax / fMin);
+
+    // octave grid
+    nvgBeginPath(vg);
+    for (float f = 55.0f; f < fMax; f *= 2.0f) {
+        if (f < fMin) continue;
+        float gx = x + w * std::log2(f / fMin) / logSpan;
+        nvgMoveTo(vg, gx, y);
+        nvgLineTo(vg, gx, y + h);
+    }
+    nvgStrokeColor(vg, withAlpha(srgbColor(187,125,128), 0.15f));
+    nvgStrokeWidth(vg, 1.0f);
+    nvgStroke(vg);
+
+    // filled curve
+    const size_t N = binsDb.size();
+    const float dx = w / float(N);
+    auto level = [&](float db) {
+        float t = (db - minDb) / (maxDb - minDb);
+        return std::min(1.0f, std::max(0.0f, t));
+    };
+
+    nvgBeginPath(vg);
+    nvgMoveTo(vg, x, y + h);
+    for (size_t i = 0; i < N; i++) {
+        nvgLineTo(vg, x + (i + 0.5f) * dx, y + h - level(binsDb[i]) * h);
+    }
+    nvgLineTo(vg, x + w, y + h);
+    nvgClosePath(vg);
+    nvgFillColor(vg, withAlpha(srgbColor(187,125,128), 0.45f));
+    nvgFill(vg);
+}
@@ -5,23 +5,78 @@
 #include <map>
 #include <cmath>
 #include <memory>
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <functional>
 #include <SDL.h>
 #include "daisysp.h"
+#include "../dsp/AdditiveBank.h"
+#include "../dsp/Kernels.h"
+#include "../dsp/VoiceKernels.h"
+#include "../audio/RtMemory.h"
+
+// 🔹 A key's wavetable (one table, or `layers` tables back to back) in one
+// arena block (audio/RtMemory.h): replacing it while the key sounds is one
+// pointer store, and the old table is freed after the callback let go.
+struct alignas(16) KeyTable {
+    uint32_t size = 0;     // samples per layer
+    int32_t  layers = 1;
+
+    float*       samples()       { return reinterpret_cast<float*>(this + 1); }
+    const float* samples() const { return reinterpret_cast<const float*>(this + 1); }
+
+    static KeyTable* make(const std::vector<float>& src, int layers) {
+        void* mem = ava::audio::RtArena::global().allocate(sizeof(KeyTable) + src.size() * sizeof(float));
+        auto* t = new (mem) KeyTable;
+        t->size = (uint32_t)(src.size() / layers);
+        t->layers = layers;
+        std::copy(src.begin(), src.end(), t->samples());
+        return t;
+    }
+};
 
 class Key : public Rect {
 public:
-    enum SourceType { Sine, Square, Saw, Wavetable };
+    enum SourceType { Sine, Square, Saw, Wavetable, Additive, Physical };
 
     SourceType source = Wavetable;
 
-    std::unique_ptr<daisysp::Oscillator> osc;
-    std::unique_ptr<daisysp::Oscillator> oscDetuned; // 🔹 for detune
-    std::vector<float> wavetable;
-    size_t tableSize = 2048;
+    daisysp::Oscillator osc;          // Sine / Square / Saw
+    daisysp::Oscillator oscDetuned;   // 🔹 for detune
+    ava::audio::RtPtr<KeyTable> table;   // Wavetable source; the callback reads it
+    size_t tableSize = 2048;          // samples per layer the tables are built with
+    int morphLayers = 1;
+    MorphAxis morphAxis = MorphAxis::None;
+    float morphPos = 0.0f;            // smoothed position along the axis, 0..1
     double phase = 0.0;
     double phaseInc = 0.0;
     double phaseDetuned = 0.0; // 🔹 for detuned wavetable
 
+    // 🔹 Additive source: partials rendered live, darker the softer the touch
+    ava::dsp::AdditiveBank<32> additive;
+    float additiveTiltDepth = 1.0f;   // octaves of tilt at zero intensity
+    float additiveRatio = 1.0f;       // detune ratio the bank is tuned to
+
+    // 🔹 Physical-model source (audio/PhysicalVoice.h): the engine renders
+    // this key's pooled voice one chunk at a time into voiceBlock and
+    // process() plays it out. The voice fields belong to the audio thread;
+    // noteOn/noteOff only raise voiceStrike/voiceDamp.
+    static constexpr int VoiceBlockFrames = 64;
+    int      voiceModel = -1;         // PhysicalModel while source == Physical
+    int      voicePool = -1;          // model of the pool voiceSlot is in
+    int      voiceSlot = -1;
+    uint32_t voiceGeneration = 0;
+    bool     voiceStrike = false;
+    bool     voiceDamp = false;
+    float    voiceBlock[VoiceBlockFrames] = {};
+    int      voiceFrames = 0, voiceRead = 0;
+
+    // 🔹 Quality governor steps (audio/QualityGovernor.h), set by the engine
+    bool fastRelease = false;      // ~0.1 s release tail
+    bool lowHarmonics = false;     // first morph layer, ≤ 8 additive partials
+    bool skipDetune = false;       // no detuned second oscillator
+
     double frequency = 440.0;
     double defaultSampleRate = 48000.0;
     float gain = 0.0f;
@@ -44,6 +99,22 @@ public:
     float detuneRangeCents = 0.0f; // ±600 cents
     float detuneAmount = 0.0f;
 
+    // Generated touches (audio-thread improviser), counted apart from real fingers
+    int drivenTouches = 0;
+    float drivenLevel = 0.0f;      // last generated intensity, for the overlay
+    int heldTouches = 0;           // real fingers, as the last touch() reported them
+
+    // 🔹 Real fingers. handleEvent() (UI thread) keeps the touch map and
+    // hands every change to onTouch; AudioEngine::setKeys() routes it
+    // through the improviser's command ring, so the envelope and the touch
+    // counts are only ever written by the audio thread. Without a handler
+    // (one-thread tools) the change is applied on the spot.
+    enum TouchPhase : uint8_t { TouchDown, TouchMove, TouchUp };
+    std::function<void(Key&, TouchPhase, int held, float intensity, float detune)> onTouch;
+    // Tells this key from one built later at the same address, so a touch
+    // still queued when the keyboard is rebuilt can't land on a new key.
+    uint32_t serial = nextSerial();
+
     Key(float x, float y, float w, float h,
         int circleNum = 0, const std::string& txt = "")
         : Rect(x, y, w, h, 0.0f, circleNum, txt) {
@@ -58,21 +129,19 @@ public:
         if (freqHz < 20.0f) freqHz = 20.0f;
         if (freqHz > 20000.0f) freqHz = 20000.0f;
 
-        double f2 = freqHz * freqHz;
+        const float f2 = freqHz * freqHz;
 
-        // RA(f) from A-weighting standard
-        double num = pow(12200.0, 2) * f2 * f2;
-        double den = (f2 + pow(20.6, 2))
-                * sqrt((f2 + pow(107.7, 2)) * (f2 + pow(737.9, 2)))
-                * (f2 + pow(12200.0, 2));
-        double Ra = num / den;
+        // RA(f) from A-weighting standard (fits a float up to 20 kHz)
+        const float num = 12200.0f * 12200.0f * f2 * f2;
+        const float den = (f2 + 20.6f * 20.6f)
+                * std::sqrt((f2 + 107.7f * 107.7f) * (f2 + 737.9f * 737.9f))
+                * (f2 + 12200.0f * 12200.0f);
+        const float Ra = num / den;
 
-        // A-weighting in dB
-        double AdB = 20.0 * log10(Ra) + 2.0;
-
-        // Convert back to linear gain, inverted
-        // return pow(10.0, -(AdB) / 20.0); //main one
-        return pow(10.0, -(AdB * 0.3) / 20.0); // only 30% compensation
+        // A-weighting in dB is AdB = 20·log10(Ra) + 2; inverted back to a
+        // linear gain, 10^(-AdB / 20) = Ra^-1 · 10^-0.1 (the main one).
+        // Only 30% compensation: Ra^-0.3 · 10^-0.03
+        return std::pow(Ra, -0.3f) * 0.93325430f;
 
     }
 
@@ -81,10 +150,31 @@ public:
 
 
     // 🔹 Mix this key into the shared audio buffer
-    void addToBuffer(float* buffer, int numFrames, double sampleRate = 48000.0) {
-        for (int i = 0; i < numFrames; i++) {
-            buffer[i] += process(sampleRate);
+    void addToBuffer(float* buffer, int numFrames, double sampleRate = 48000.0, uint64_t clock = 0) {
+        render(buffer, (unsigned)numFrames, sampleRate, clock);
+    }
+
+    // 🔹 Adds this key's next n frames into out: what n process() calls
+    // would return, a span at a time. Each span runs one instantiation of
+    // renderSpan (source × tremolo × detune, dsp/VoiceKernels.h), picked
+    // here per span, so nothing inside it branches per sample; the
+    // envelope covers the span in whole segments (voice::Envelope). Only
+    // a wavetable key's table reads before its first chunk go through
+    // process(). clock: the engine's frame count at out[0], which the
+    // tremolo LFO is read from (tremPhaseAt), so keys rendered on
+    // different threads share no state.
+    void render(float* out, unsigned n, double sampleRate, uint64_t clock = 0) {
+        unsigned i = 0;
+        while (i < n && active) {
+            const unsigned m = renderSteady(out + i, std::min(n - i, (unsigned)VoiceBlockFrames), sampleRate, clock + i);
+            if (m > 0) {
+                i += m;
+            } else {
+                out[i] += process(sampleRate, clock + i);
+                i++;
+            }
         }
+        if (i < n) lastGain = gain;   // silent frames, as process() leaves them
     }
 
     void draw(NVGcontext* vg) override {
@@ -95,6 +185,7 @@ public:
         float maxIntensity = 0.0f;
         for (auto &kv : activeTouches)
             maxIntensity = std::max(maxIntensity, kv.second);
+        maxIntensity = std::max(maxIntensity, drivenLevel);
         if (maxIntensity > 0.0f) {
             nvgBeginPath(vg);
             nvgRoundedRect(vg, x, y, w, h, cornerRadius);
@@ -114,44 +205,159 @@ public:
 
 
 
+    // The oscillators live in the key: switching sources never allocates
+    // or frees anything the callback might be using.
     void setOscillator(SourceType type) {
-        source = type;
-        osc.reset();
-        oscDetuned.reset();
+        table.reset();
         if (type == Sine || type == Square || type == Saw) {
-            auto o1 = std::make_unique<daisysp::Oscillator>();
-            auto o2 = std::make_unique<daisysp::Oscillator>();
-            o1->Init(defaultSampleRate);
-            o2->Init(defaultSampleRate);
-            if (type == Sine) {
-                o1->SetWaveform(daisysp::Oscillator::WAVE_SIN);
-                o2->SetWaveform(daisysp::Oscillator::WAVE_SIN);
-            }
-            if (type == Square) {
-                o1->SetWaveform(daisysp::Oscillator::WAVE_POLYBLEP_SQUARE);
-                o2->SetWaveform(daisysp::Oscillator::WAVE_POLYBLEP_SQUARE);
+            uint8_t wave = daisysp::Oscillator::WAVE_SIN;
+            if (type == Square) wave = daisysp::Oscillator::WAVE_POLYBLEP_SQUARE;
+            if (type == Saw)    wave = daisysp::Oscillator::WAVE_POLYBLEP_SAW;
+            for (auto* o : { &osc, &oscDetuned }) {
+                o->Init(defaultSampleRate);
+                o->SetWaveform(wave);
+                o->SetAmp(0.5f);
+                o->SetFreq(frequency);
             }
-            if (type == Saw) {
-                o1->SetWaveform(daisysp::Oscillator::WAVE_POLYBLEP_SAW);
-                o2->SetWaveform(daisysp::Oscillator::WAVE_POLYBLEP_SAW);
-            }
-            o1->SetAmp(0.5f);
-            o2->SetAmp(0.5f);
-            osc = std::move(o1);
-            oscDetuned = std::move(o2);
         }
+        source = type;
     }
 
-    void setWavetable(const std::vector<float>& table) {
-        source = Wavetable;
-        osc.reset();
-        oscDetuned.reset();
-        wavetable = table;
-        tableSize = table.size();
+    void setWavetable(const std::vector<float>& samples) {
+        setTable(samples, 1);
+        morphLayers = 1;
+        morphAxis = MorphAxis::None;
         phase = 0.0;
         phaseDetuned = 0.0;
     }
 
+    // Fills a new arena table, then publishes it: the callback plays the old
+    // table or the new one, never half of each.
+    void setTable(const std::vector<float>& samples, int layers) {
+        if (samples.empty()) { table.reset(); return; }
+        tableSize = samples.size() / layers;
+        table.reset(KeyTable::make(samples, layers));
+        source = Wavetable;
+    }
+
+    // 🔹 Morph stack: `layers` equal-size tables back to back, interpolated
+    // along `axis` per sample (two table reads instead of a rebuild).
+    void setMorphStack(const std::vector<float>& stack, int layers, MorphAxis axis) {
+        if (layers < 2 || stack.empty() || stack.size() % layers != 0) {
+            setWavetable(stack);
+            return;
+        }
+        setTable(stack, layers);
+        morphLayers = layers;
+        morphAxis = axis;
+        morphPos = morphTarget();
+        setFrequency(frequency);   // phaseInc depends on tableSize
+    }
+
+    void setAdditive(const HarmonicSpec& spec) {
+        source = Additive;
+        table.reset();
+        morphLayers = 1;
+        morphAxis = MorphAxis::None;
+
+        int n = (int)std::min(spec.amps.size(), spec.phases.size());
+        std::vector<float> amps(spec.amps.begin(), spec.amps.begin() + n);
+
+        // same peak level as the table builders (peak of one cycle → 0.95)
+        float peak = 0.0f;
+        for (int i = 0; i < 256; i++) {
+            float t = 2.0f * (float)M_PI * i / 256.0f, v = 0.0f;
+            for (int h = 0; h < n; h++) v += amps[h] * std::sin((h + 1) * t + spec.phases[h]);
+            peak = std::max(peak, std::abs(v));
+        }
+        if (peak > 0.0f) for (auto& a : amps) a *= 0.95f / peak;
+
+        additive.init(defaultSampleRate);
+        additive.setSpectrum(amps.data(), spec.phases.data(), n);
+        additiveRatio = 1.0f;
+        setFrequency(frequency);
+    }
+
+    void setPhysical(int model) {
+        source = Physical;
+        table.reset();
+        morphLayers = 1;
+        morphAxis = MorphAxis::None;
+        voiceModel = model;
+    }
+
+    // 🔹 Wavetable source a chunk ahead: the engine calls this once per chunk
+    // (n ≤ VoiceBlockFrames) and process() plays voiceBlock out, as for a
+    // physical voice. Phases and the morph glide step per frame exactly as
+    // in process(); the table reads are one tableRead kernel per oscillator
+    // (dsp/Kernels.h). A key that starts sounding mid-chunk reads the table
+    // in process() until the next chunk; one whose release ends mid-chunk
+    // rewinds to the frames it played (rewindTable).
+    void renderTable(unsigned n, double sampleRate) {
+        voiceFrames = voiceRead = 0;
+        const KeyTable* tab = table.get();
+        if (source != Wavetable || !tab || !active || envState == Idle) return;
+        n = std::min(n, (unsigned)VoiceBlockFrames);
+
+        const uint32_t size = tab->size;
+        const int layers = tab->layers;
+        const bool morph = layers > 1 && !lowHarmonics;
+        const float ratio = std::exp2(detuneAmount * (1.0f / 1200.0f));
+        const double incDetuned = (frequency * ratio / sampleRate) * size;
+        tableStart = { phase, phaseDetuned, incDetuned, morphPos, size, morph };
+
+        int32_t index[VoiceBlockFrames], indexDetuned[VoiceBlockFrames];
+        float frac[VoiceBlockFrames], detuned[VoiceBlockFrames];
+        for (unsigned i = 0; i < n; i++) {
+            uint32_t base = 0;
+            frac[i] = 0.0f;
+            if (morph) {
+                morphPos += (morphTarget() - morphPos) * 0.002f;   // same glide as Sustain
+                float pos = morphPos * (float)(layers - 1);
+                int layer = std::min((int)pos, layers - 2);
+                frac[i] = pos - (float)layer;
+                base = (uint32_t)layer * size;
+            }
+            index[i] = (int32_t)(base + tableIndex(phase, size));
+            if (!skipDetune) {
+                phaseDetuned += incDetuned;
+                if (phaseDetuned >= (double)size)
+                    phaseDetuned -= (double)size;
+                indexDetuned[i] = (int32_t)(base + tableIndex(phaseDetuned, size));
+            }
+            phase += phaseInc;
+            if (phase >= (double)size)
+                phase -= (double)size;
+        }
+
+        const ava::dsp::Kernels& kn = ava::dsp::kernels();
+        const int32_t stride = morph ? (int32_t)size : 0;
+        kn.tableRead(voiceBlock, tab->samples(), index, frac, stride, n);
+        if (!skipDetune) {
+            kn.tableRead(detuned, tab->samples(), indexDetuned, frac, stride, n);
+            kn.add(voiceBlock, detuned, n);
+            kn.scale(voiceBlock, 0.5f, n);
+        }
+        voiceFrames = (int)n;
+    }
+
+    // Audio thread, once per block (cheap when nothing changed).
+    void setQuality(bool shortTail, bool fewHarmonics, bool noDetune) {
+        fastRelease = shortTail;
+        lowHarmonics = fewHarmonics;
+        skipDetune = noDetune;
+        if (source == Additive) additive.setPartialLimit(fewHarmonics ? 8 : 32);
+    }
+
+    // Polyphony cap: let go of this key as if every finger had lifted.
+    void shed() {
+        if (!active || envState == Release) return;
+        pendingRelease = false;
+        envState = Release;
+        if (source == Physical) voiceDamp = true;
+    }
+    bool isReleasing() const { return envState == Release; }
+
     void setFrequency(double freq) {
         setFrequency(freq, defaultSampleRate);
     }
@@ -159,8 +365,9 @@ public:
     void setFrequency(double freq, double sampleRate) {
         frequency = freq;
         phaseInc = (frequency / sampleRate) * (double)tableSize;
-        if (osc) osc->SetFreq(frequency);
-        if (oscDetuned) oscDetuned->SetFreq(frequency);
+        osc.SetFreq(frequency);
+        oscDetuned.SetFreq(frequency);
+        if (source == Additive) additive.setFrequency(frequency * additiveRatio);
     }
 
     bool handleEvent(const SDL_Event& e, int winW, int winH) override {
@@ -173,9 +380,8 @@ public:
         if (e.type == SDL_FINGERDOWN) {
             if (isInside(mx, my)) {
                 float intensity = computeIntensity(my);
-                detuneAmount = computeDetune(mx);
                 activeTouches[e.tfinger.fingerId] = intensity;
-                noteOn(intensity);
+                sendTouch(TouchDown, intensity, computeDetune(mx));
                 return true;
             }
         }
@@ -183,26 +389,67 @@ public:
             if (activeTouches.find(e.tfinger.fingerId) != activeTouches.end()) {
                 if (isInside(mx, my)) {
                     float intensity = computeIntensity(my);
-                    detuneAmount = computeDetune(mx);
                     activeTouches[e.tfinger.fingerId] = intensity;
-                    noteMove(intensity);
+                    sendTouch(TouchMove, intensity, computeDetune(mx));
                     return true;
                 } else {
                     activeTouches.erase(e.tfinger.fingerId);
-                    if (activeTouches.empty()) noteOff();
+                    sendTouch(TouchUp, 0.0f, 0.0f);
                 }
             }
         }
         if (e.type == SDL_FINGERUP) {
             activeTouches.erase(e.tfinger.fingerId);
-            if (activeTouches.empty()) noteOff();
+            sendTouch(TouchUp, 0.0f, 0.0f);
             return true;
         }
         return false;
     }
 
+    // Audio thread: one finger change from handleEvent(); `held` is how
+    // many fingers were on the key after it.
+    void touch(TouchPhase phase, int held, float intensity, float detune) {
+        heldTouches = held;
+        switch (phase) {
+            case TouchDown:
+                detuneAmount = detune;
+                noteOn(intensity);
+                break;
+            case TouchMove:
+                detuneAmount = detune;
+                noteMove(intensity);
+                break;
+            case TouchUp:
+                if (heldTouches == 0 && drivenTouches == 0) noteOff();
+                break;
+        }
+    }
+
+    // --- Generated touches ---
+    // Same mapping as a finger at (mx, my) in window pixels, without the
+    // touch map: no allocation, so the audio thread can drive the key.
+    void driveOn(float mx, float my) {
+        float intensity = computeIntensity(my);
+        detuneAmount = computeDetune(mx);
+        drivenTouches++;
+        drivenLevel = intensity;
+        noteOn(intensity);
+    }
+    void driveMove(float mx, float my) {
+        if (drivenTouches == 0) return;
+        float intensity = computeIntensity(my);
+        detuneAmount = computeDetune(mx);
+        drivenLevel = intensity;
+        noteMove(intensity);
+    }
+    void driveOff() {
+        if (drivenTouches == 0) return;
+        if (--drivenTouches == 0) drivenLevel = 0.0f;
+        if (drivenTouches == 0 && heldTouches == 0) noteOff();
+    }
+
     
-float process(double sampleRate = 48000.0) {
+float process(double sampleRate = 48000.0, uint64_t clock = 0) {
     lastGain = gain;
 
     if (!active) return 0.0f;
@@ -219,14 +466,15 @@ float process(double sampleRate = 48000.0) {
             }
             break;
         case Sustain:
-            gain += (targetGain - gain) * 0.002f;
+            gain += (targetGain - gain) * ava::dsp::voice::SustainChase;
             break;
         case Release:
-            gain *= 0.9995f;   // ✅ exponential release
-            if (gain <= 0.0001f) {
+            gain *= fastRelease ? 0.998f : 0.9995f;   // ✅ exponential release
+            if (gain <= ava::dsp::voice::ReleaseFloor) {
                 gain = 0;
                 envState = Idle;
                 active = false;
+                if (voiceRead < voiceFrames && source == Wavetable) rewindTable(voiceRead);
             }
             break;
         case Idle:
@@ -235,24 +483,65 @@ float process(double sampleRate = 48000.0) {
     }
 
     float sample = 0.0f;
-    float ratio  = powf(2.0f, detuneAmount / 1200.0f);
+    float ratio  = std::exp2(detuneAmount * (1.0f / 1200.0f));
 
-    if (osc && oscDetuned) {
-        osc->SetFreq(frequency);
-        oscDetuned->SetFreq(frequency * ratio);
-        sample = 0.5f * (osc->Process() + oscDetuned->Process());
+    if (source == Sine || source == Square || source == Saw) {
+        osc.SetFreq(frequency);
+        if (skipDetune) {
+            sample = osc.Process();
+        } else {
+            oscDetuned.SetFreq(frequency * ratio);
+            sample = 0.5f * (osc.Process() + oscDetuned.Process());
+        }
+    }
+    else if (source == Physical) {
+        // the voice carries its own pitch, detune and excitation
+        sample = voiceRead < voiceFrames ? voiceBlock[voiceRead++] : 0.0f;
     }
-    else if (!wavetable.empty()) {
+    else if (source == Additive) {
+        // detune bends the additive voice instead of doubling it
+        if (ratio != additiveRatio) {
+            additiveRatio = ratio;
+            additive.setFrequency(frequency * ratio);
+        }
+        additive.setTilt(additiveTiltDepth * (1.0f - targetGain));
+        sample = additive.process();
+    }
+    else if (voiceRead < voiceFrames) {
+        // wavetable chunk from renderTable()
+        sample = voiceBlock[voiceRead++];
+    }
+    else if (const KeyTable* tab = table.get()) {
+        // size and layers come from the table this sample reads, never
+        // from a replacement the UI is still filling in
+        const size_t tableSize = tab->size;
+        const int layers = tab->layers;
+        const float* t0 = tab->samples();
+        const float* t1 = t0;
+        float frac = 0.0f;
+        if (layers > 1 && !lowHarmonics) {
+            morphPos += (morphTarget() - morphPos) * 0.002f;   // same glide as Sustain
+            float pos = morphPos * (float)(layers - 1);
+            int layer = std::min((int)pos, layers - 2);
+            frac = pos - (float)layer;
+            t0 = tab->samples() + (size_t)layer * tableSize;
+            t1 = t0 + tableSize;
+        }
+
         size_t idx1 = (size_t)phase % tableSize;
-        float s1 = wavetable[idx1];
+        float s1 = t0[idx1] + frac * (t1[idx1] - t0[idx1]);
 
-        phaseDetuned += (frequency * ratio / sampleRate) * tableSize;
-        if (phaseDetuned >= (double)tableSize)
-            phaseDetuned -= (double)tableSize;
-        size_t idx2 = (size_t)phaseDetuned % tableSize;
-        float s2 = wavetable[idx2];
+        if (skipDetune) {
+            sample = s1;
+        } else {
+            phaseDetuned += (frequency * ratio / sampleRate) * tableSize;
+            if (phaseDetuned >= (double)tableSize)
+                phaseDetuned -= (double)tableSize;
+            size_t idx2 = (size_t)phaseDetuned % tableSize;
+            float s2 = t0[idx2] + frac * (t1[idx2] - t0[idx2]);
 
-        sample = 0.5f * (s1 + s2);
+            sample = 0.5f * (s1 + s2);
+        }
 
         phase += phaseInc;
         if (phase >= (double)tableSize)
@@ -272,17 +561,11 @@ float process(double sampleRate = 48000.0) {
     }
 
     // Tremolo (leave as is)
-    static double tremPhase = 0.0;
     if (tremDepthParam > 0.0f) {
-        float tremRateHz = 1.0f + tremRateParam * 7.0f;
         float fingerFactor = 1.0f - targetGain;
         float effectiveDepth = tremDepthParam * fingerFactor;
 
-        tremPhase += (tremRateHz / sampleRate) * 2.0 * M_PI;
-        if (tremPhase >= 2.0 * M_PI)
-            tremPhase -= 2.0 * M_PI;
-
-        float trem = std::sin(tremPhase);
+        float trem = (float)std::sin(tremPhaseAt(clock + 1, sampleRate));
         float modAmp = 1.0f + effectiveDepth * 0.3f * trem;
         lastRawSample = sample;
         return sample * gain * modAmp * equalLoudnessWeight((float)frequency);
@@ -312,20 +595,223 @@ float process(double sampleRate = 48000.0) {
 
 
 private:
-    std::map<SDL_FingerID, float> activeTouches;
+    std::map<SDL_FingerID, float> activeTouches;   // UI thread
+
+    void sendTouch(TouchPhase phase, float intensity, float detune) {
+        const int held = (int)activeTouches.size();
+        if (onTouch) onTouch(*this, phase, held, intensity, detune);
+        else         touch(phase, held, intensity, detune);
+    }
+    static uint32_t nextSerial() {
+        static std::atomic<uint32_t> next{0};
+        return ++next;
+    }
+
     float lastRawSample = 0.0f;
     bool pendingRelease = false;
     int pendingSamples = 0;   // track how long we've been waiting
 
 
+    float tremRateHz() const { return 1.0f + tremRateParam * 7.0f; }
+
+    // Tremolo LFO phase (radians) at engine frame `clock`: a function of
+    // the clock alone, so every key at one rate is in step and nothing is
+    // advanced per key.
+    double tremPhaseAt(uint64_t clock, double sampleRate) const {
+        const double cycles = (double)tremRateHz() * (double)clock / sampleRate;
+        return (cycles - std::floor(cycles)) * 2.0 * M_PI;
+    }
+
+    // --- Span rendering (render()) ---
+    enum class SpanSource { Oscillators, Additive, Block };
+
+    using SpanFn = unsigned (Key::*)(float*, unsigned, double, uint64_t);
+
+    // Frames rendered into out by the instantiation for the key's current
+    // state; 0 when the next frame has to go through process().
+    unsigned renderSteady(float* out, unsigned n, double sampleRate, uint64_t clock) {
+        if (envState == Idle) return 0;
+        SpanSource src = SpanSource::Block;
+        switch (source) {
+            case Sine: case Square: case Saw:
+                src = SpanSource::Oscillators;
+                break;
+            case Additive:
+                src = SpanSource::Additive;
+                break;
+            case Physical:
+                break;
+            case Wavetable:
+                // the chunk from renderTable(); past it, process() reads the table
+                if (voiceRead >= voiceFrames) return 0;
+                n = std::min(n, (unsigned)(voiceFrames - voiceRead));
+                break;
+        }
+        const int variant = (tremDepthParam > 0.0f ? 2 : 0)
+                          + (src == SpanSource::Oscillators && !skipDetune ? 1 : 0);
+        switch (src) {
+            case SpanSource::Oscillators: return renderVariant<SpanSource::Oscillators>(out, n, sampleRate, clock, variant);
+            case SpanSource::Additive:    return renderVariant<SpanSource::Additive>(out, n, sampleRate, clock, variant);
+            case SpanSource::Block:       return renderVariant<SpanSource::Block>(out, n, sampleRate, clock, variant);
+        }
+        return 0;
+    }
+
+    // variant: tremolo · 2 + detune
+    template <SpanSource Src>
+    unsigned renderVariant(float* out, unsigned n, double sampleRate, uint64_t clock, int variant) {
+        static constexpr SpanFn spans[4] = {
+            &Key::renderSpan<Src, false, false>, &Key::renderSpan<Src, false, true>,
+            &Key::renderSpan<Src, true, false>,  &Key::renderSpan<Src, true, true>,
+        };
+        return (this->*spans[variant])(out, n, sampleRate, clock);
+    }
+
+    // One span of process() with its per-sample decisions fixed. The span
+    // is first cut so no release can end inside it (the source must not
+    // run past the frame the key falls silent on); then the source, the
+    // zero-crossing wait, the envelope, the tremolo and the gain stage
+    // each run over the whole span.
+    template <SpanSource Src, bool Tremolo, bool Detune>
+    unsigned renderSpan(float* out, unsigned n, double sampleRate, uint64_t clock) {
+        namespace voice = ava::dsp::voice;
+        float s[VoiceBlockFrames], mod[VoiceBlockFrames];
+
+        voice::Envelope env;
+        env.stage = envState == Attack ? voice::EnvStage::Attack
+                  : envState == Sustain ? voice::EnvStage::Sustain : voice::EnvStage::Release;
+        env.gain = gain;
+        env.target = targetGain;
+        env.attackStep = 1.0f / (attackTime * sampleRate);
+        env.releaseKeep = fastRelease ? 0.998f : 0.9995f;
+        if (pendingRelease)   // released from somewhere between gain and the level
+            n = std::min(n, env.releaseFrames(std::min(gain, targetGain)));
+        else if (envState == Release)
+            n = std::min(n, env.releaseFrames(gain));
+
+        if constexpr (Src == SpanSource::Oscillators) {
+            osc.SetFreq(frequency);
+            if constexpr (Detune)
+                oscDetuned.SetFreq(frequency * std::exp2(detuneAmount * (1.0f / 1200.0f)));
+            voice::oscillators<Detune>(s, osc, oscDetuned, n);
+        } else if constexpr (Src == SpanSource::Additive) {
+            const float ratio = std::exp2(detuneAmount * (1.0f / 1200.0f));
+            if (ratio != additiveRatio) {
+                additiveRatio = ratio;
+                additive.setFrequency(frequency * ratio);
+            }
+            additive.setTilt(additiveTiltDepth * (1.0f - targetGain));
+            for (unsigned i = 0; i < n; i++) s[i] = additive.process();
+        } else {
+            // physical voice or wavetable chunk; a voice that ran dry is silent
+            const unsigned avail = (unsigned)std::max(0, std::min((int)n, voiceFrames - voiceRead));
+            std::copy(voiceBlock + voiceRead, voiceBlock + voiceRead + avail, s);
+            std::fill(s + avail, s + n, 0.0f);
+            voiceRead += (int)avail;
+        }
+        lastRawSample = s[n - 1];
+
+        // ✅ Zero-cross release + fallback timer: release from the frame after
+        unsigned held = n;
+        bool release = false;
+        if (pendingRelease) {
+            const int timeout = (int)(0.05 * sampleRate);   // ~50 ms
+            for (unsigned i = 0; i < n && !release; i++) {
+                pendingSamples++;
+                if (std::fabs(s[i]) < 0.001f || pendingSamples > timeout) {
+                    release = true;
+                    held = i + 1;
+                }
+            }
+        }
+
+        const ava::dsp::Kernels& kn = ava::dsp::kernels();
+        lastGain = gain;
+        env.apply(kn, s, held);
+        if (release) {
+            pendingRelease = false;
+            env.stage = voice::EnvStage::Release;
+            env.apply(kn, s + held, n - held);
+        }
+
+        if constexpr (Tremolo) {
+            const float effectiveDepth = tremDepthParam * (1.0f - targetGain);
+            double phase = tremPhaseAt(clock, sampleRate);
+            voice::tremolo(mod, phase, (tremRateHz() / sampleRate) * 2.0 * M_PI, effectiveDepth, n);
+        }
+        voice::applyGain<Tremolo>(out, s, mod, equalLoudnessWeight((float)frequency), n);
+
+        gain = env.gain;
+        envState = env.stage == voice::EnvStage::Attack ? Attack
+                 : env.stage == voice::EnvStage::Sustain ? Sustain : Release;
+        if (env.idle) {
+            envState = Idle;
+            active = false;
+            if (voiceRead < voiceFrames && source == Wavetable) rewindTable(voiceRead);
+        }
+        return n;
+    }
+
+    // Oscillator state where renderTable()'s chunk began.
+    struct TableStart {
+        double   phase = 0.0, phaseDetuned = 0.0, incDetuned = 0.0;
+        float    morphPos = 0.0f;
+        uint32_t size = 0;
+        bool     morph = false;
+    };
+    TableStart tableStart;
+
+    // The chunk ran ahead of a key that fell silent after `frames` of it:
+    // step from the chunk's start again, so the next note starts from the
+    // phases process() would have left.
+    void rewindTable(int frames) {
+        const TableStart& t = tableStart;
+        phase = t.phase;
+        phaseDetuned = t.phaseDetuned;
+        morphPos = t.morphPos;
+        for (int i = 0; i < frames; i++) {
+            if (t.morph)
+                morphPos += (morphTarget() - morphPos) * 0.002f;
+            if (!skipDetune) {
+                phaseDetuned += t.incDetuned;
+                if (phaseDetuned >= (double)t.size)
+                    phaseDetuned -= (double)t.size;
+            }
+            phase += phaseInc;
+            if (phase >= (double)t.size)
+                phase -= (double)t.size;
+        }
+        voiceFrames = frames;
+    }
+
+    // (size_t)phase % size, without the division while phase is in range
+    static uint32_t tableIndex(double phase, uint32_t size) {
+        const size_t i = (size_t)phase;
+        return (uint32_t)(i < size ? i : i % size);
+    }
+
     float computeIntensity(float my) {
         float relY = (my - y) / h;
         float d = std::abs(relY - 0.5f) * 2.0f;
         // return std::max(0.0f, 1.0f - d);
         // return std::max(0.0f, 1.0f - powf(d, 0.5f));
-        return (expf(-4.0f * d) - expf(-4.0f)) / (1.0f - expf(-4.0f));
+        constexpr float edge = 0.018315639f;    // e^-4, the curve at d = 1
+        return (std::exp(-4.0f * d) - edge) / (1.0f - edge);
+
 
+    }
 
+    // Where the morph axis currently points, 0..1
+    float morphTarget() const {
+        switch (morphAxis) {
+            case MorphAxis::Intensity:
+                return std::clamp(targetGain, 0.0f, 1.0f);
+            case MorphAxis::Detune:
+                if (detuneRangeCents <= 0.0f) return 0.5f;
+                return std::clamp(0.5f + 0.5f * detuneAmount / detuneRangeCents, 0.0f, 1.0f);
+            default:
+                return 0.0f;
+        }
     }
 
     float computeDetune(float mx) {
@@ -334,7 +820,18 @@ private:
         return centered * detuneRangeCents;
     }
 
-    void noteOn(float relGain) { targetGain = relGain; envState = Attack; active = true; }
+    void noteOn(float relGain) {
+        targetGain = relGain;
+        active = true;
+        if (source == Physical) {
+            // the model shapes its own attack: a pluck starts at full level
+            voiceStrike = true;
+            gain = relGain;
+            envState = Sustain;
+            return;
+        }
+        envState = Attack;
+    }
     void noteMove(float relGain) { targetGain = relGain; }
     // void noteMove(float relGain) {
     //     // Smooth the jump: move targetGain gradually
@@ -344,6 +841,11 @@ private:
 
     // void noteOff() { envState = Release; }
     void noteOff() {
+        if (source == Physical) {
+            voiceDamp = true;
+            envState = Release;
+            return;
+        }
         if (source == Wavetable) {
             envState = Release;
             pendingRelease = false;
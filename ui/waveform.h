@@ -4,10 +4,12 @@
 #include <algorithm>
 #include <string>
 #include <functional>
+#include <sstream>
 #include <nanovg.h>
 #include <SDL.h>
 #include "UI.h"           // for Widget + srgbColor
 #include "WaveSchema.h"   // harmonic extrapolation engine
+#include "../audio/PhysicalVoice.h"   // string / bowed models as sources
 
 #include "daisysp.h"
 using namespace daisysp;
@@ -19,9 +21,30 @@ struct HarmonicSpec {
     std::vector<float> phases;
 };
 
+// What a morphing waveform's timbre follows while a key is held
+enum class MorphAxis { None, Intensity, Detune };
+
 struct WaveformInfo {
     std::string name;
     std::function<std::vector<float>()> generator;
+
+    // Optional morph stack: morph(t, maxHarmonics) builds the table at
+    // position t (0..1) along `axis`, limited to maxHarmonics so each key
+    // gets a band-limited stack. Keys interpolate between adjacent layers.
+    MorphAxis axis = MorphAxis::None;
+    std::function<std::vector<float>(float t, size_t maxHarmonics)> morph;
+    int morphSteps = 8;
+    size_t morphHarmonics = 64;   // most partials the morph tables ever use
+
+    // Optional: render this spectrum live with an additive bank instead of
+    // a table, so partials can follow the touch individually.
+    std::function<HarmonicSpec()> spectrum;
+
+    // Optional: a physical model (ava::audio::PhysicalModel) the engine
+    // plays from its voice pool instead of any table.
+    int physical = -1;
+
+    bool morphs() const { return axis != MorphAxis::None && morph && morphSteps > 1; }
 };
 
 
@@ -99,9 +122,15 @@ public:
         size_t harmonics = std::min(real.size(), imag.size());
         for (size_t i = 0; i < tableSize; i++) {
             double t = (2.0 * M_PI * i) / tableSize;
+            // cos(k t), sin(k t) by rotation instead of two trig calls per term
+            double c1 = std::cos(t), s1 = std::sin(t);
+            double ck = 1.0, sk = 0.0;
             double v = 0.0;
             for (size_t k = 0; k < harmonics; k++) {
-                v += real[k] * std::cos(k * t) + imag[k] * std::sin(k * t);
+                v += real[k] * ck + imag[k] * sk;
+                double cn = ck * c1 - sk * s1;
+                sk = sk * c1 + ck * s1;
+                ck = cn;
             }
             out[i] = float(v);
         }
@@ -242,9 +271,50 @@ public:
             {"DodExtended", [](){ return GoldenDodWave(); }},
             {"Violin", [](){ return Violin(); }},
             {"Euler", [](){ return Euler(); }},
-            {"Eulerplus", [](){ return Eulerplus(); }},
-            {"Custom", [](){ return std::vector<float>(); }}
+            {"Eulerplus", [](){ return Eulerplus(); },
+                MorphAxis::Intensity,                       // brighter as the touch gets stronger
+                [](float t, size_t maxH) { return Eulerplus(2048, maxH, t); }},
+            {"Custom", [](){ return std::vector<float>(); }},
+            additiveVoice("Golden+",       GoldenSpec),
+            additiveVoice("BrighterSine+", BrighterSineSpec),
+            additiveVoice("Dod+",          DodSpec),
+            physicalVoice(ava::audio::ModelSitar),
+            physicalVoice(ava::audio::ModelStringVoice),
+            physicalVoice(ava::audio::ModelStifKarp),
+            physicalVoice(ava::audio::ModelBowed),
+            physicalVoice(ava::audio::ModelPlucked),
+            physicalVoice(ava::audio::ModelString),
+            physicalVoice(ava::audio::ModelModalVoice)
+        };
+    }
+
+    static WaveformInfo physicalVoice(ava::audio::PhysicalModel model) {
+        WaveformInfo wf;
+        wf.name = ava::audio::physicalModels[model].name;
+        wf.generator = [](){ return std::vector<float>(); };
+        wf.physical = model;
+        return wf;
+    }
+
+    static WaveformInfo additiveVoice(const std::string& name, HarmonicSpec (*spec)()) {
+        WaveformInfo wf;
+        wf.name = name;
+        wf.generator = [](){ return std::vector<float>(); };
+        wf.spectrum = spec;
+        return wf;
+    }
+
+    // "Custom": table from the panel's Real/Imag fields (space-separated amplitudes)
+    static WaveformInfo custom(const std::string& realText, const std::string& imagText) {
+        auto parseList = [](const std::string& txt) {
+            std::vector<float> vals;
+            std::stringstream ss(txt);
+            float v;
+            while (ss >> v) vals.push_back(v);
+            return vals;
         };
+        auto table = buildTable(parseList(realText), parseList(imagText), 2048);
+        return WaveformInfo{"Custom", [table]() { return table; }};
     }
 
 private: